@@ -31,6 +31,7 @@
 
 #include "addon/addon.hpp"
 #include "addon/md5.hpp"
+#include "physfs/physfs_directory_index.hpp"
 #include "physfs/physfs_file_system.hpp"
 #include "util/file_system.hpp"
 #include "util/gettext.hpp"
@@ -116,7 +117,7 @@ static PHYSFS_EnumerateCallbackResult add_to_dictionary_path(void *data, const c
     {
         log_debug << "Adding \"" << full_path << "\" to dictionary search path" << std::endl;
         // We want translations from addons to have precedence
-        g_dictionary_manager->add_directory(full_path, true);
+        g_compiled_dictionary->add_directory(full_path, true);
     }
     return PHYSFS_ENUM_OK;
 }
@@ -126,7 +127,7 @@ static PHYSFS_EnumerateCallbackResult remove_from_dictionary_path(void *data, co
     std::string full_path = FileSystem::join(origdir, fname);
     if(PhysFSFileSystem::is_directory(full_path))
     {
-        g_dictionary_manager->remove_directory(full_path);
+        g_compiled_dictionary->remove_directory(full_path);
     }
     return PHYSFS_ENUM_OK;
 }
@@ -143,7 +144,7 @@ AddonManager::AddonManager(const std::string& addon_directory,
   m_has_been_updated(false),
   m_transfer_status()
 {
-  if(!PHYSFS_mkdir(m_addon_directory.c_str()))
+  if(!PhysFSFileSystem::mkdir(m_addon_directory))
   {
     std::ostringstream msg;
     msg << "Couldn't create directory for addons '"
@@ -323,7 +324,7 @@ AddonManager::request_install_addon(const AddonId& addon_id)
           MD5 md5 = md5_from_file(install_filename);
           if (repository_addon.get_md5() != md5.hex_digest())
           {
-            if (PHYSFS_delete(install_filename.c_str()) == 0)
+            if (PhysFSFileSystem::remove(install_filename))
             {
               log_warning << "PHYSFS_delete failed: " << PHYSFS_getLastErrorCode() << std::endl;
             }
@@ -382,7 +383,7 @@ AddonManager::install_addon(const AddonId& addon_id)
   MD5 md5 = md5_from_file(install_filename);
   if (repository_addon.get_md5() != md5.hex_digest())
   {
-    if (PHYSFS_delete(install_filename.c_str()) == 0)
+    if (PhysFSFileSystem::remove(install_filename))
     {
       log_warning << "PHYSFS_delete failed: " << PHYSFS_getLastErrorCode() << std::endl;
     }
@@ -413,7 +414,7 @@ AddonManager::uninstall_addon(const AddonId& addon_id)
     disable_addon(addon_id);
   }
   log_debug << "deleting file \"" << addon.get_install_filename() << "\"" << std::endl;
-  PHYSFS_delete(addon.get_install_filename().c_str());
+  PhysFSFileSystem::remove(addon.get_install_filename());
   m_installed_addons.erase(std::remove_if(m_installed_addons.begin(), m_installed_addons.end(),
                                           [&addon](const std::unique_ptr<Addon>& rhs)
                                           {
@@ -446,7 +447,7 @@ AddonManager::enable_addon(const AddonId& addon_id)
         break;
     }
 
-    if (PHYSFS_mount(addon.get_install_filename().c_str(), mountpoint.c_str(), 0) == 0)
+    if (PhysFSFileSystem::mount(addon.get_install_filename(), mountpoint, false) == 0)
     {
       log_warning << "Could not add " << addon.get_install_filename() << " to search path: "
                   << PHYSFS_getLastErrorCode() << std::endl;
@@ -474,7 +475,7 @@ AddonManager::disable_addon(const AddonId& addon_id)
   else
   {
     log_debug << "Removing archive \"" << addon.get_install_filename() << "\" from search path" << std::endl;
-    if (PHYSFS_unmount(addon.get_install_filename().c_str()) == 0)
+    if (PhysFSFileSystem::unmount(addon.get_install_filename()) == 0)
     {
       log_warning << "Could not remove " << addon.get_install_filename() << " from search path: "
                   << PHYSFS_getLastErrorCode() << std::endl;
@@ -525,7 +526,7 @@ AddonManager::mount_old_addons()
   std::string mountpoint;
   for (auto& addon : m_installed_addons) {
     if (is_old_enabled_addon(addon)) {
-      if (PHYSFS_mount(addon->get_install_filename().c_str(), mountpoint.c_str(), 0) == 0)
+      if (PhysFSFileSystem::mount(addon->get_install_filename(), mountpoint, false) == 0)
       {
         log_warning << "Could not add " << addon->get_install_filename() << " to search path: "
                     << PHYSFS_getLastErrorCode() << std::endl;
@@ -539,7 +540,7 @@ AddonManager::unmount_old_addons()
 {
   for (auto& addon : m_installed_addons) {
     if (is_old_enabled_addon(addon)) {
-      if (PHYSFS_unmount(addon->get_install_filename().c_str()) == 0)
+      if (PhysFSFileSystem::unmount(addon->get_install_filename()) == 0)
       {
         log_warning << "Could not remove " << addon->get_install_filename() << " from search path: "
                     << PHYSFS_getLastErrorCode() << std::endl;
@@ -567,15 +568,12 @@ AddonManager::scan_for_archives() const
   std::vector<std::string> archives;
 
   // Search for archives and add them to the search path
-  std::unique_ptr<char*, decltype(&PHYSFS_freeList)>
-    rc(PHYSFS_enumerateFiles(m_addon_directory.c_str()),
-       PHYSFS_freeList);
-  for(char** i = rc.get(); *i != 0; ++i)
+  for(const auto& filename : PhysFSDirectoryIndex::enumerate(m_addon_directory))
   {
-    if (StringUtil::has_suffix(*i, ".zip"))
+    if (StringUtil::has_suffix(filename, ".zip"))
     {
-      std::string archive = FileSystem::join(m_addon_directory, *i);
-      if (PHYSFS_exists(archive.c_str()))
+      std::string archive = FileSystem::join(m_addon_directory, filename);
+      if (PhysFSDirectoryIndex::exists(archive))
       {
         archives.push_back(archive);
       }
@@ -588,14 +586,11 @@ AddonManager::scan_for_archives() const
 std::string
 AddonManager::scan_for_info(const std::string& archive_os_path) const
 {
-  std::unique_ptr<char*, decltype(&PHYSFS_freeList)>
-    rc2(PHYSFS_enumerateFiles("/"),
-        PHYSFS_freeList);
-  for(char** j = rc2.get(); *j != 0; ++j)
+  for(const auto& filename : PhysFSDirectoryIndex::enumerate("/"))
   {
-    if (StringUtil::has_suffix(*j, ".nfo"))
+    if (StringUtil::has_suffix(filename, ".nfo"))
     {
-      std::string nfo_filename = FileSystem::join("/", *j);
+      std::string nfo_filename = FileSystem::join("/", filename);
 
       // make sure it's in the current archive_os_path
       const char* realdir = PHYSFS_getRealDir(nfo_filename.c_str());
@@ -629,7 +624,7 @@ AddonManager::add_installed_archive(const std::string& archive, const std::strin
   {
     std::string os_path = FileSystem::join(realdir, archive);
 
-    PHYSFS_mount(os_path.c_str(), NULL, 0);
+    PhysFSFileSystem::mount(os_path, "", false);
 
     std::string nfo_filename = scan_for_info(os_path);
 
@@ -651,7 +646,7 @@ AddonManager::add_installed_archive(const std::string& archive, const std::strin
       }
     }
 
-    PHYSFS_unmount(os_path.c_str());
+    PhysFSFileSystem::unmount(os_path);
   }
 }
 
@@ -25,6 +25,7 @@
 #include <sstream>
 #include <stdexcept>
 
+#include "physfs/physfs_directory_index.hpp"
 #include "util/log.hpp"
 #include "version.h"
 
@@ -97,6 +98,7 @@ public:
       out << "PHYSFS_openRead() failed: " << PHYSFS_getLastErrorCode();
       throw std::runtime_error(out.str());
     }
+    PhysFSDirectoryIndex::invalidate();
 
     m_handle = curl_easy_init();
     if (!m_handle)
@@ -257,6 +259,7 @@ Downloader::download(const std::string& url, const std::string& filename)
   std::unique_ptr<PHYSFS_file, int(*)(PHYSFS_File*)> fout(PHYSFS_openWrite(filename.c_str()),
                                                           PHYSFS_close);
   download(url, my_curl_physfs_write, fout.get());
+  PhysFSDirectoryIndex::invalidate();
 }
 
 void
@@ -0,0 +1,108 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "audio/audio_stream_thread.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+AudioStreamThread::AudioStreamThread() :
+  m_commands(64),
+  m_wakeup_mutex(),
+  m_wakeup_cond(),
+  m_wakeup(false),
+  m_streams(),
+  m_decode_buffer(new char[StreamSoundSource::STREAMFRAGMENTSIZE]),
+  m_thread()
+{
+  m_thread = std::thread(&AudioStreamThread::run, this);
+}
+
+AudioStreamThread::~AudioStreamThread()
+{
+  send(Command::QUIT, nullptr);
+  m_thread.join();
+}
+
+void
+AudioStreamThread::add(StreamSoundSource* source)
+{
+  send(Command::ADD, source->get_stream());
+}
+
+void
+AudioStreamThread::remove(StreamSoundSource* source)
+{
+  send(Command::REMOVE, source->get_stream());
+}
+
+void
+AudioStreamThread::send(Command::Type type, std::shared_ptr<StreamSoundSource::Stream> stream)
+{
+  Command command;
+  command.type = type;
+  command.stream = std::move(stream);
+  while(!m_commands.push(command))
+  {
+    std::this_thread::yield();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_wakeup_mutex);
+    m_wakeup = true;
+  }
+  m_wakeup_cond.notify_one();
+}
+
+void
+AudioStreamThread::run()
+{
+  while(true)
+  {
+    Command command;
+    while(m_commands.pop(command))
+    {
+      switch(command.type)
+      {
+        case Command::ADD:
+          m_streams.push_back(std::move(command.stream));
+          break;
+
+        case Command::REMOVE:
+          // the last reference might be this one, freeing it here keeps
+          // alDeleteSources() off the main thread
+          m_streams.erase(std::remove(m_streams.begin(), m_streams.end(), command.stream),
+                          m_streams.end());
+          break;
+
+        case Command::QUIT:
+          return;
+      }
+    }
+
+    for(const auto& stream : m_streams)
+    {
+      stream->refill(m_decode_buffer.get());
+    }
+
+    std::unique_lock<std::mutex> lock(m_wakeup_mutex);
+    m_wakeup_cond.wait_for(lock, std::chrono::milliseconds(REFILL_INTERVAL_MS),
+                           [this]{ return m_wakeup; });
+    m_wakeup = false;
+  }
+}
+
+/* EOF */
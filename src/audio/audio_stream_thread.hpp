@@ -0,0 +1,83 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADER_SUPERTUX_AUDIO_AUDIO_STREAM_THREAD_HPP
+#define HEADER_SUPERTUX_AUDIO_AUDIO_STREAM_THREAD_HPP
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "audio/stream_sound_source.hpp"
+#include "util/spsc_queue.hpp"
+
+/** Worker thread that decodes and queues the buffers of all
+    StreamSoundSources, so music never depends on the frame rate of
+    the main loop. The main thread talks to it only through a
+    lock-free command queue, the decode buffer is allocated once and
+    reused for every refill. */
+class AudioStreamThread
+{
+public:
+  AudioStreamThread();
+  ~AudioStreamThread();
+
+  /** Starts refilling @c source, called from the main thread */
+  void add(StreamSoundSource* source);
+
+  /** Stops refilling @c source, called from the main thread. Doesn't
+      wait: the thread keeps its own reference to the stream and frees
+      it once the command is processed. */
+  void remove(StreamSoundSource* source);
+
+private:
+  struct Command
+  {
+    enum Type { ADD, REMOVE, QUIT };
+
+    Type type;
+    std::shared_ptr<StreamSoundSource::Stream> stream;
+  };
+
+  void send(Command::Type type, std::shared_ptr<StreamSoundSource::Stream> stream);
+  void run();
+
+private:
+  /** interval in which the sources are checked for processed buffers */
+  static const int REFILL_INTERVAL_MS = 10;
+
+  SPSCQueue<Command> m_commands;
+
+  std::mutex m_wakeup_mutex;
+  std::condition_variable m_wakeup_cond;
+  bool m_wakeup;
+
+  /** only used by the thread */
+  std::vector<std::shared_ptr<StreamSoundSource::Stream> > m_streams;
+  std::unique_ptr<char[]> m_decode_buffer;
+
+  std::thread m_thread;
+
+private:
+  AudioStreamThread(const AudioStreamThread&) = delete;
+  AudioStreamThread& operator=(const AudioStreamThread&) = delete;
+};
+
+#endif
+
+/* EOF */
@@ -0,0 +1,31 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "audio/memory_sound_sink.hpp"
+
+MemorySoundSink::MemorySoundSink() :
+  m_samples()
+{
+}
+
+void
+MemorySoundSink::write(const int16_t* samples, size_t frames)
+{
+  m_samples.insert(m_samples.end(), samples, samples + frames * 2);
+}
+
+/* EOF */
@@ -0,0 +1,47 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HEADER_SUPERTUX_AUDIO_MEMORY_SOUND_SINK_HPP
+#define HEADER_SUPERTUX_AUDIO_MEMORY_SOUND_SINK_HPP
+
+#include <vector>
+
+#include "audio/sound_sink.hpp"
+
+/** Keeps everything that was mixed in memory */
+class MemorySoundSink : public SoundSink
+{
+public:
+  MemorySoundSink();
+
+  virtual void write(const int16_t* samples, size_t frames) override;
+
+  /** interleaved stereo samples */
+  const std::vector<int16_t>& get_samples() const { return m_samples; }
+  size_t get_frames() const { return m_samples.size() / 2; }
+
+private:
+  std::vector<int16_t> m_samples;
+
+private:
+  MemorySoundSink(const MemorySoundSink&) = delete;
+  MemorySoundSink& operator=(const MemorySoundSink&) = delete;
+};
+
+#endif
+
+/* EOF */
@@ -0,0 +1,133 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "audio/music_intro_cache.hpp"
+
+#include <physfs.h>
+#include <sstream>
+
+#include "audio/sound_error.hpp"
+#include "audio/stream_sound_source.hpp"
+#include "util/log.hpp"
+#include "util/thread_pool.hpp"
+
+const size_t MusicIntroCache::INTRO_SIZE = StreamSoundSource::STREAMBUFFERSIZE;
+
+MusicIntroCache::MusicIntroCache(size_t max_entries) :
+  m_max_entries(max_entries),
+  m_mutex(),
+  m_intros(),
+  m_lru(),
+  m_hits(0),
+  m_misses(0),
+  m_pool(new ThreadPool(1))
+{
+}
+
+MusicIntroCache::~MusicIntroCache()
+{
+  m_pool.reset();
+}
+
+void
+MusicIntroCache::prefetch(const std::string& filename)
+{
+  if(filename.empty())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(m_intros.find(filename) != m_intros.end())
+      return;
+    m_intros[filename] = std::shared_ptr<const PrefetchedSoundFile::Intro>();
+  }
+
+  m_pool->post([this, filename] { load(filename); });
+}
+
+void
+MusicIntroCache::load(const std::string& filename)
+{
+  std::shared_ptr<const PrefetchedSoundFile::Intro> intro;
+  try {
+    intro = PrefetchedSoundFile::load_intro(filename, INTRO_SIZE);
+  } catch(std::exception& e) {
+    log_warning << "Couldn't prefetch music file '" << filename << "': " << e.what() << std::endl;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if(!intro) {
+    m_intros.erase(filename);
+    return;
+  }
+
+  m_intros[filename] = intro;
+  m_lru.remove(filename);
+  m_lru.push_front(filename);
+  while(m_lru.size() > m_max_entries) {
+    m_intros.erase(m_lru.back());
+    m_lru.pop_back();
+  }
+}
+
+std::unique_ptr<SoundFile>
+MusicIntroCache::open(const std::string& filename)
+{
+  if(!PHYSFS_exists(filename.c_str())) {
+    std::stringstream msg;
+    msg << "Couldn't open '" << filename << "': file doesn't exist";
+    throw SoundError(msg.str());
+  }
+
+  std::shared_ptr<const PrefetchedSoundFile::Intro> intro;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_intros.find(filename);
+    if(it != m_intros.end() && it->second) {
+      intro = it->second;
+      m_lru.remove(filename);
+      m_lru.push_front(filename);
+      m_hits += 1;
+    } else {
+      m_misses += 1;
+    }
+  }
+
+  // the decoder waiting behind the intro is used up by the file opened
+  // last, get the next one ready while the intro plays
+  if(intro) {
+    m_pool->post([filename, intro] {
+        try {
+          intro->prepare_file(filename);
+        } catch(std::exception& e) {
+          log_warning << "Couldn't prefetch music file '" << filename << "': " << e.what() << std::endl;
+        }
+      });
+  }
+
+  return std::unique_ptr<SoundFile>(new PrefetchedSoundFile(filename, intro));
+}
+
+void
+MusicIntroCache::print_stats(std::ostream& out) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  out << "Music intros: " << m_lru.size() << " cached"
+      << ", hits: " << m_hits << ", misses: " << m_misses << std::endl;
+}
+
+/* EOF */
@@ -0,0 +1,77 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HEADER_SUPERTUX_AUDIO_MUSIC_INTRO_CACHE_HPP
+#define HEADER_SUPERTUX_AUDIO_MUSIC_INTRO_CACHE_HPP
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+#include "audio/prefetched_sound_file.hpp"
+
+class ThreadPool;
+
+/** Decodes the beginning of music files on a background thread and
+    keeps the most recently used ones, so that switching to them starts
+    without opening or decoding anything on the main thread */
+class MusicIntroCache
+{
+public:
+  /** decoded bytes kept per file, enough to fill all stream buffers */
+  static const size_t INTRO_SIZE;
+
+public:
+  MusicIntroCache(size_t max_entries);
+  ~MusicIntroCache();
+
+  /** Starts decoding the intro of @c filename unless it's cached */
+  void prefetch(const std::string& filename);
+
+  /** Returns a file that starts with the cached intro if there is one.
+      Throws if @c filename doesn't exist. */
+  std::unique_ptr<SoundFile> open(const std::string& filename);
+
+  void print_stats(std::ostream& out) const;
+
+private:
+  void load(const std::string& filename);
+
+private:
+  size_t m_max_entries;
+  mutable std::mutex m_mutex;
+  /** NULL while the intro is being decoded */
+  std::map<std::string, std::shared_ptr<const PrefetchedSoundFile::Intro> > m_intros;
+  /** most recently used first */
+  std::list<std::string> m_lru;
+  int m_hits;
+  int m_misses;
+
+  /** destroyed first, so no job runs while the rest goes away */
+  std::unique_ptr<ThreadPool> m_pool;
+
+private:
+  MusicIntroCache(const MusicIntroCache&) = delete;
+  MusicIntroCache& operator=(const MusicIntroCache&) = delete;
+};
+
+#endif
+
+/* EOF */
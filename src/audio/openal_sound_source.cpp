@@ -36,8 +36,11 @@ OpenALSoundSource::OpenALSoundSource() :
 
 OpenALSoundSource::~OpenALSoundSource()
 {
-  stop();
-  alDeleteSources(1, &source);
+  // subclasses may hand the source over to someone else
+  if(source) {
+    stop();
+    alDeleteSources(1, &source);
+  }
 }
 
 void
@@ -0,0 +1,169 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "audio/prefetched_sound_file.hpp"
+
+#include <algorithm>
+#include <string.h>
+
+#include "util/log.hpp"
+
+namespace {
+
+/** Reads and drops @c bytes of decoded samples from @c file */
+void skip(SoundFile& file, size_t bytes)
+{
+  char scratch[16384];
+  while(bytes > 0) {
+    size_t count = file.read(scratch, std::min(bytes, sizeof(scratch)));
+    if(count == 0)
+      break;
+    bytes -= count;
+  }
+}
+
+} // namespace
+
+std::unique_ptr<SoundFile>
+PrefetchedSoundFile::Intro::take_file() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return std::move(file);
+}
+
+void
+PrefetchedSoundFile::Intro::prepare_file(const std::string& filename) const
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if(file)
+      return;
+  }
+
+  std::unique_ptr<SoundFile> next = load_sound_file(filename);
+  skip(*next, data.size());
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if(!file)
+    file = std::move(next);
+}
+
+std::shared_ptr<const PrefetchedSoundFile::Intro>
+PrefetchedSoundFile::load_intro(const std::string& filename, size_t bytes)
+{
+  std::unique_ptr<SoundFile> file = load_sound_file(filename);
+
+  std::shared_ptr<Intro> intro = std::make_shared<Intro>();
+  intro->channels = file->channels;
+  intro->rate = file->rate;
+  intro->bits_per_sample = file->bits_per_sample;
+  intro->size = file->size;
+  intro->data.resize(std::min(bytes, file->size));
+
+  size_t size = 0;
+  while(size < intro->data.size()) {
+    size_t count = file->read(intro->data.data() + size, intro->data.size() - size);
+    if(count == 0)
+      break;
+    size += count;
+  }
+  intro->data.resize(size);
+  // the first file that plays past the intro continues with this one
+  intro->file = std::move(file);
+  return intro;
+}
+
+PrefetchedSoundFile::PrefetchedSoundFile(const std::string& filename,
+                                         std::shared_ptr<const Intro> intro) :
+  m_filename(filename),
+  m_intro(std::move(intro)),
+  m_intro_position(0),
+  m_file(),
+  m_failed(false)
+{
+  if(m_intro) {
+    channels = m_intro->channels;
+    rate = m_intro->rate;
+    bits_per_sample = m_intro->bits_per_sample;
+    size = m_intro->size;
+  }
+}
+
+size_t
+PrefetchedSoundFile::read(void* buffer, size_t buffer_size)
+{
+  char* out = static_cast<char*>(buffer);
+  size_t count = 0;
+  if(m_intro && m_intro_position < m_intro->data.size()) {
+    count = std::min(buffer_size, m_intro->data.size() - m_intro_position);
+    memcpy(out, m_intro->data.data() + m_intro_position, count);
+    m_intro_position += count;
+    if(count == buffer_size)
+      return count;
+  }
+
+  if(!m_file && m_intro) {
+    m_file = m_intro->take_file();
+  }
+  if(!m_file) {
+    if(m_failed || !open())
+      return count;
+    skip_intro();
+  }
+  return count + m_file->read(out + count, buffer_size - count);
+}
+
+void
+PrefetchedSoundFile::reset()
+{
+  if(m_intro) {
+    m_intro_position = m_intro->data.size();
+  }
+  if(!m_file && (m_failed || !open()))
+    return;
+  m_file->reset();
+}
+
+bool
+PrefetchedSoundFile::open()
+{
+  try {
+    m_file = load_sound_file(m_filename);
+  } catch(std::exception& e) {
+    // only complain once, the stream thread keeps asking for more
+    log_warning << "Couldn't open music file '" << m_filename << "': " << e.what() << std::endl;
+    m_failed = true;
+    return false;
+  }
+
+  channels = m_file->channels;
+  rate = m_file->rate;
+  bits_per_sample = m_file->bits_per_sample;
+  size = m_file->size;
+  return true;
+}
+
+void
+PrefetchedSoundFile::skip_intro()
+{
+  if(!m_intro)
+    return;
+
+  skip(*m_file, m_intro->data.size());
+}
+
+/* EOF */
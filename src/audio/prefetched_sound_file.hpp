@@ -0,0 +1,88 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HEADER_SUPERTUX_AUDIO_PREFETCHED_SOUND_FILE_HPP
+#define HEADER_SUPERTUX_AUDIO_PREFETCHED_SOUND_FILE_HPP
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "audio/sound_file.hpp"
+
+/** A sound file that plays an already decoded intro from memory and
+    only opens the actual file once it is read past that intro. Since
+    StreamSoundSource reads on the stream thread, the main thread never
+    opens or decodes anything. */
+class PrefetchedSoundFile : public SoundFile
+{
+public:
+  /** the first bytes of decoded samples of a file */
+  struct Intro
+  {
+    int channels;
+    int rate;
+    int bits_per_sample;
+    size_t size;
+    std::vector<char> data;
+
+    /** Returns a decoder positioned right after @c data, or NULL if
+        there is none waiting */
+    std::unique_ptr<SoundFile> take_file() const;
+    /** Opens and positions another decoder for take_file() unless one
+        is waiting, meant for a background thread */
+    void prepare_file(const std::string& filename) const;
+
+    mutable std::mutex mutex;
+    mutable std::unique_ptr<SoundFile> file;
+  };
+
+  /** Decodes the first @c bytes of @c filename, throws on errors */
+  static std::shared_ptr<const Intro> load_intro(const std::string& filename, size_t bytes);
+
+public:
+  /** @param intro  may be NULL, then the file is opened on the first read */
+  PrefetchedSoundFile(const std::string& filename, std::shared_ptr<const Intro> intro);
+
+  virtual size_t read(void* buffer, size_t buffer_size) override;
+  /** Continues at the loop point of the file, the intro is only played
+      the first time */
+  virtual void reset() override;
+
+private:
+  /** Opens the file, returns false if that failed */
+  bool open();
+  /** Moves the file past the bytes that are played from the intro,
+      only needed if the intro had no decoder waiting */
+  void skip_intro();
+
+private:
+  std::string m_filename;
+  std::shared_ptr<const Intro> m_intro;
+  size_t m_intro_position;
+  std::unique_ptr<SoundFile> m_file;
+  bool m_failed;
+
+private:
+  PrefetchedSoundFile(const PrefetchedSoundFile&) = delete;
+  PrefetchedSoundFile& operator=(const PrefetchedSoundFile&) = delete;
+};
+
+#endif
+
+/* EOF */
@@ -0,0 +1,140 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "audio/software_mixer.hpp"
+
+#include <algorithm>
+#include <assert.h>
+#include <chrono>
+
+#include "audio/sound_buffer_cache.hpp"
+#include "audio/sound_file.hpp"
+#include "audio/sound_sink.hpp"
+
+const size_t SoftwareMixer::MAX_EVENTS;
+
+SoftwareMixer::SoftwareMixer(int rate, int game_fps, std::unique_ptr<SoundSink> sink) :
+  m_rate(rate),
+  m_game_fps(game_fps),
+  m_sink(std::move(sink)),
+  m_sources(),
+  m_samples(),
+  m_listener_position(),
+  m_accumulator(),
+  m_output(),
+  m_events(),
+  m_event_count(0),
+  m_game_frames(0),
+  m_mixed_frames(0),
+  m_mix_usec(0),
+  m_peak_sources(0)
+{
+}
+
+SoftwareMixer::~SoftwareMixer()
+{
+  assert(m_sources.empty());
+}
+
+std::unique_ptr<SoftwareSoundSource>
+SoftwareMixer::create_source(const std::string& filename)
+{
+  auto it = m_samples.find(filename);
+  if(it != m_samples.end()) {
+    return std::unique_ptr<SoftwareSoundSource>(new SoftwareSoundSource(*this, it->second));
+  }
+
+  std::unique_ptr<SoundFile> file = load_sound_file(filename);
+  if(file->size >= SoundBufferCache::STREAM_THRESHOLD) {
+    return std::unique_ptr<SoftwareSoundSource>(new SoftwareSoundSource(*this, std::move(file)));
+  }
+
+  std::shared_ptr<const SoftwareSoundSource::Samples> samples = SoftwareSoundSource::decode(*file);
+  m_samples[filename] = samples;
+  return std::unique_ptr<SoftwareSoundSource>(new SoftwareSoundSource(*this, samples));
+}
+
+void
+SoftwareMixer::add(SoftwareSoundSource* source)
+{
+  m_sources.push_back(source);
+  m_peak_sources = std::max(m_peak_sources, m_sources.size());
+}
+
+void
+SoftwareMixer::remove(SoftwareSoundSource* source)
+{
+  m_sources.erase(std::remove(m_sources.begin(), m_sources.end(), source),
+                  m_sources.end());
+}
+
+void
+SoftwareMixer::mix_frame()
+{
+  // computed from the total, so that rounding doesn't add up
+  m_game_frames += 1;
+  uint64_t end = m_game_frames * m_rate / m_game_fps;
+  mix(static_cast<size_t>(end - m_mixed_frames));
+}
+
+void
+SoftwareMixer::mix(size_t frames)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  m_accumulator.assign(frames * 2, 0);
+  for(auto& source : m_sources) {
+    source->mix(m_accumulator.data(), frames, m_rate, m_listener_position);
+  }
+
+  m_output.resize(frames * 2);
+  for(size_t i = 0; i < frames * 2; ++i) {
+    m_output[i] = static_cast<int16_t>(std::max(-32768, std::min(32767, m_accumulator[i])));
+  }
+  if(m_sink) {
+    m_sink->write(m_output.data(), frames);
+  }
+  m_mixed_frames += frames;
+
+  m_mix_usec += std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now() - start).count();
+}
+
+void
+SoftwareMixer::record_event(const std::string& filename)
+{
+  if(m_events.size() >= MAX_EVENTS)
+    m_events.pop_front();
+  m_events.push_back(Event{m_mixed_frames, filename});
+  m_event_count += 1;
+
+  if(m_sink) {
+    m_sink->write_event(m_mixed_frames, filename);
+  }
+}
+
+void
+SoftwareMixer::print_stats(std::ostream& out) const
+{
+  double seconds = static_cast<double>(m_mixed_frames) / m_rate;
+  out << "Software mixer: " << seconds << "s of audio at " << m_rate << "Hz"
+      << " mixed in " << (m_mix_usec / 1000) << "ms" << std::endl;
+  out << "Sources: " << m_sources.size() << " (peak " << m_peak_sources << ")"
+      << ", sounds played: " << m_event_count << std::endl;
+}
+
+/* EOF */
@@ -0,0 +1,111 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HEADER_SUPERTUX_AUDIO_SOFTWARE_MIXER_HPP
+#define HEADER_SUPERTUX_AUDIO_SOFTWARE_MIXER_HPP
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "audio/software_sound_source.hpp"
+#include "math/vector.hpp"
+
+class SoundSink;
+
+/** Mixes all SoftwareSoundSources into a SoundSink. Time only advances
+    when mix() or mix_frame() is called, so the output only depends on
+    what was played in which game frame and not on the speed of the
+    machine. Everything runs on the main thread. */
+class SoftwareMixer
+{
+public:
+  /** a sound started with SoundManager::play() */
+  struct Event
+  {
+    /** output frame at which the sound started */
+    uint64_t frame;
+    std::string filename;
+  };
+
+public:
+  /** @param rate  output frames per second
+      @param game_fps  game frames per second, for mix_frame() */
+  SoftwareMixer(int rate, int game_fps, std::unique_ptr<SoundSink> sink);
+  ~SoftwareMixer();
+
+  int get_rate() const { return m_rate; }
+
+  /** Creates a source playing @c filename, short files are decoded once
+      and shared, long ones are streamed. Throws if the file can't be
+      loaded. */
+  std::unique_ptr<SoftwareSoundSource> create_source(const std::string& filename);
+
+  void add(SoftwareSoundSource* source);
+  void remove(SoftwareSoundSource* source);
+
+  void set_listener_position(const Vector& position) { m_listener_position = position; }
+
+  /** Mixes the output frames of one game frame */
+  void mix_frame();
+  void mix(size_t frames);
+
+  /** Remembers that @c filename started playing now and passes it on
+      to the sink */
+  void record_event(const std::string& filename);
+
+  /** the most recent MAX_EVENTS events */
+  const std::deque<Event>& get_events() const { return m_events; }
+  uint64_t get_event_count() const { return m_event_count; }
+
+  static const size_t MAX_EVENTS = 256;
+
+  uint64_t get_mixed_frames() const { return m_mixed_frames; }
+
+  void print_stats(std::ostream& out) const;
+
+private:
+  int m_rate;
+  int m_game_fps;
+  std::unique_ptr<SoundSink> m_sink;
+  std::vector<SoftwareSoundSource*> m_sources;
+  std::map<std::string, std::shared_ptr<const SoftwareSoundSource::Samples> > m_samples;
+  Vector m_listener_position;
+
+  std::vector<int32_t> m_accumulator;
+  std::vector<int16_t> m_output;
+  std::deque<Event> m_events;
+  uint64_t m_event_count;
+
+  uint64_t m_game_frames;
+  uint64_t m_mixed_frames;
+  int64_t m_mix_usec;
+  size_t m_peak_sources;
+
+private:
+  SoftwareMixer(const SoftwareMixer&) = delete;
+  SoftwareMixer& operator=(const SoftwareMixer&) = delete;
+};
+
+#endif
+
+/* EOF */
@@ -0,0 +1,289 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "audio/software_sound_source.hpp"
+
+#include <algorithm>
+#include <math.h>
+#include <stdexcept>
+
+#include "audio/software_mixer.hpp"
+#include "audio/sound_file.hpp"
+
+namespace {
+
+/** bytes read from a streamed file at once */
+const size_t STREAM_BLOCK_SIZE = 16384;
+
+/** the listener is this far in front of the level, like with OpenAL */
+const float LISTENER_DISTANCE = 300.0f;
+
+} // namespace
+
+std::shared_ptr<const SoftwareSoundSource::Samples>
+SoftwareSoundSource::decode(SoundFile& file)
+{
+  if(file.channels != 1 && file.channels != 2)
+    throw std::runtime_error("Only 1 and 2 channel samples supported");
+
+  std::vector<char> bytes(file.size);
+  size_t size = file.read(bytes.data(), bytes.size());
+
+  std::shared_ptr<Samples> samples = std::make_shared<Samples>();
+  samples->channels = file.channels;
+  samples->rate = file.rate;
+  convert(bytes.data(), size, file.bits_per_sample, samples->data);
+  return samples;
+}
+
+void
+SoftwareSoundSource::convert(const char* bytes, size_t size, int bits_per_sample,
+                             std::vector<int16_t>& out)
+{
+  if(bits_per_sample == 16) {
+    out.resize(size / 2);
+    std::copy(bytes, bytes + out.size() * 2, reinterpret_cast<char*>(out.data()));
+  } else if(bits_per_sample == 8) {
+    out.resize(size);
+    for(size_t i = 0; i < size; ++i) {
+      out[i] = static_cast<int16_t>((static_cast<uint8_t>(bytes[i]) - 128) * 256);
+    }
+  } else {
+    throw std::runtime_error("Only 16 and 8 bit samples supported");
+  }
+}
+
+SoftwareSoundSource::SoftwareSoundSource(SoftwareMixer& mixer,
+                                         std::shared_ptr<const Samples> samples) :
+  m_mixer(mixer),
+  m_samples(std::move(samples)),
+  m_file(),
+  m_stream(),
+  m_data(m_samples.get()),
+  m_state(STOPPED),
+  m_position(0),
+  m_looping(false),
+  m_relative(false),
+  m_gain(1.0f),
+  m_pitch(1.0f),
+  m_source_position(),
+  m_reference_distance(128)
+{
+  m_mixer.add(this);
+}
+
+SoftwareSoundSource::SoftwareSoundSource(SoftwareMixer& mixer,
+                                         std::unique_ptr<SoundFile> file) :
+  m_mixer(mixer),
+  m_samples(),
+  m_file(std::move(file)),
+  m_stream(),
+  m_data(&m_stream),
+  m_state(STOPPED),
+  m_position(0),
+  m_looping(false),
+  m_relative(false),
+  m_gain(1.0f),
+  m_pitch(1.0f),
+  m_source_position(),
+  m_reference_distance(128)
+{
+  if(m_file->channels != 1 && m_file->channels != 2)
+    throw std::runtime_error("Only 1 and 2 channel samples supported");
+
+  m_stream.channels = m_file->channels;
+  m_stream.rate = m_file->rate;
+  m_mixer.add(this);
+}
+
+SoftwareSoundSource::~SoftwareSoundSource()
+{
+  m_mixer.remove(this);
+}
+
+void
+SoftwareSoundSource::play()
+{
+  if(m_state == PAUSED) {
+    m_state = PLAYING;
+    return;
+  }
+
+  m_position = 0;
+  if(m_file) {
+    m_file->reset();
+    m_stream.data.clear();
+    read_block();
+  }
+  m_state = PLAYING;
+}
+
+void
+SoftwareSoundSource::stop()
+{
+  m_state = STOPPED;
+}
+
+bool
+SoftwareSoundSource::playing() const
+{
+  return m_state == PLAYING;
+}
+
+void
+SoftwareSoundSource::pause()
+{
+  if(m_state == PLAYING) {
+    m_state = PAUSED;
+  }
+}
+
+void
+SoftwareSoundSource::resume()
+{
+  if(m_state == PAUSED) {
+    m_state = PLAYING;
+  }
+}
+
+bool
+SoftwareSoundSource::paused() const
+{
+  return m_state == PAUSED;
+}
+
+void
+SoftwareSoundSource::set_looping(bool looping)
+{
+  m_looping = looping;
+}
+
+void
+SoftwareSoundSource::set_relative(bool relative)
+{
+  m_relative = relative;
+}
+
+void
+SoftwareSoundSource::set_gain(float gain)
+{
+  m_gain = gain;
+}
+
+void
+SoftwareSoundSource::set_pitch(float pitch)
+{
+  m_pitch = pitch;
+}
+
+void
+SoftwareSoundSource::set_position(const Vector& position)
+{
+  m_source_position = position;
+}
+
+void
+SoftwareSoundSource::set_velocity(const Vector& )
+{
+  // no doppler effect
+}
+
+void
+SoftwareSoundSource::set_reference_distance(float distance)
+{
+  m_reference_distance = distance;
+}
+
+void
+SoftwareSoundSource::get_gains(const Vector& listener, int32_t& left, int32_t& right) const
+{
+  // inverse distance clamped attenuation, OpenAL's default model
+  Vector offset = m_relative ? m_source_position : m_source_position - listener;
+  float z = m_relative ? 0.0f : LISTENER_DISTANCE;
+  float distance = sqrtf(offset.x * offset.x + offset.y * offset.y + z * z);
+  float gain = m_gain;
+  float pan = 0.0f;
+  if(distance > 0.0f) {
+    gain *= m_reference_distance / std::max(distance, m_reference_distance);
+    pan = std::max(-1.0f, std::min(1.0f, offset.x / distance));
+  }
+
+  left = static_cast<int32_t>(gain * std::min(1.0f, 1.0f - pan) * 256.0f);
+  right = static_cast<int32_t>(gain * std::min(1.0f, 1.0f + pan) * 256.0f);
+}
+
+void
+SoftwareSoundSource::mix(int32_t* out, size_t frames, int rate, const Vector& listener)
+{
+  if(m_state != PLAYING)
+    return;
+
+  int32_t left_gain, right_gain;
+  get_gains(listener, left_gain, right_gain);
+  double step = static_cast<double>(m_data->rate) * m_pitch / rate;
+
+  for(size_t i = 0; i < frames; ++i) {
+    size_t index = static_cast<size_t>(m_position);
+    while(index >= m_data->frames()) {
+      if(!next_block()) {
+        m_state = STOPPED;
+        return;
+      }
+      index = static_cast<size_t>(m_position);
+    }
+
+    const int16_t* frame = &m_data->data[index * m_data->channels];
+    int32_t left = frame[0];
+    int32_t right = m_data->channels == 2 ? frame[1] : left;
+    out[i * 2] += (left * left_gain) / 256;
+    out[i * 2 + 1] += (right * right_gain) / 256;
+
+    m_position += step;
+  }
+}
+
+bool
+SoftwareSoundSource::next_block()
+{
+  size_t frames = m_data->frames();
+  if(!m_file) {
+    if(!m_looping || frames == 0)
+      return false;
+    m_position -= static_cast<double>(frames);
+    return true;
+  }
+
+  m_position -= static_cast<double>(frames);
+  if(read_block())
+    return true;
+
+  if(!m_looping)
+    return false;
+  m_file->reset();
+  return read_block();
+}
+
+bool
+SoftwareSoundSource::read_block()
+{
+  char bytes[STREAM_BLOCK_SIZE];
+  size_t size = m_file->read(bytes, sizeof(bytes));
+  convert(bytes, size, m_file->bits_per_sample, m_stream.data);
+  return m_stream.frames() > 0;
+}
+
+/* EOF */
@@ -0,0 +1,112 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HEADER_SUPERTUX_AUDIO_SOFTWARE_SOUND_SOURCE_HPP
+#define HEADER_SUPERTUX_AUDIO_SOFTWARE_SOUND_SOURCE_HPP
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "audio/sound_source.hpp"
+#include "math/vector.hpp"
+
+class SoftwareMixer;
+class SoundFile;
+
+/** A sound source that is mixed by the SoftwareMixer instead of
+    OpenAL, either from samples decoded up front or streamed from a
+    SoundFile while it plays */
+class SoftwareSoundSource : public SoundSource
+{
+public:
+  /** 16 bit samples, interleaved if there is more than one channel */
+  struct Samples
+  {
+    int channels;
+    int rate;
+    std::vector<int16_t> data;
+
+    size_t frames() const { return data.size() / channels; }
+  };
+
+  /** Decodes all of @c file, throws if its format isn't supported */
+  static std::shared_ptr<const Samples> decode(SoundFile& file);
+
+public:
+  SoftwareSoundSource(SoftwareMixer& mixer, std::shared_ptr<const Samples> samples);
+  SoftwareSoundSource(SoftwareMixer& mixer, std::unique_ptr<SoundFile> file);
+  virtual ~SoftwareSoundSource();
+
+  virtual void play() override;
+  virtual void stop() override;
+  virtual bool playing() const override;
+  void pause();
+  void resume();
+  bool paused() const;
+
+  virtual void set_looping(bool looping) override;
+  virtual void set_relative(bool relative) override;
+  virtual void set_gain(float gain) override;
+  virtual void set_pitch(float pitch) override;
+  virtual void set_position(const Vector& position) override;
+  virtual void set_velocity(const Vector& velocity) override;
+  virtual void set_reference_distance(float distance) override;
+
+  /** Adds the next @c frames frames at @c rate to the interleaved
+      stereo @c out, stops the source when it runs out of samples */
+  void mix(int32_t* out, size_t frames, int rate, const Vector& listener);
+
+private:
+  enum State { STOPPED, PLAYING, PAUSED };
+
+  static void convert(const char* bytes, size_t size, int bits_per_sample,
+                      std::vector<int16_t>& out);
+
+  void get_gains(const Vector& listener, int32_t& left, int32_t& right) const;
+  /** Moves on to the next block of samples, returns false at the end */
+  bool next_block();
+  bool read_block();
+
+private:
+  SoftwareMixer& m_mixer;
+  std::shared_ptr<const Samples> m_samples;
+  std::unique_ptr<SoundFile> m_file;
+  /** the block of m_file that is played right now */
+  Samples m_stream;
+  const Samples* m_data;
+
+  State m_state;
+  /** in frames of m_data, fractional when the rates differ */
+  double m_position;
+
+  bool m_looping;
+  bool m_relative;
+  float m_gain;
+  float m_pitch;
+  Vector m_source_position;
+  float m_reference_distance;
+
+private:
+  SoftwareSoundSource(const SoftwareSoundSource&) = delete;
+  SoftwareSoundSource& operator=(const SoftwareSoundSource&) = delete;
+};
+
+#endif
+
+/* EOF */
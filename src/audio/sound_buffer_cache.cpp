@@ -0,0 +1,346 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "audio/sound_buffer_cache.hpp"
+
+#include <chrono>
+#include <stdexcept>
+
+#include "audio/sound_file.hpp"
+#include "audio/sound_manager.hpp"
+#include "util/log.hpp"
+#include "util/thread_pool.hpp"
+
+SoundBufferCache::Decode::Decode(const std::string& filename_) :
+  filename(filename_),
+  started(false),
+  done(false),
+  stream(false),
+  error(),
+  samples(),
+  format(),
+  rate(),
+  usec(0)
+{
+}
+
+SoundBufferCache::SoundBufferCache(size_t budget) :
+  m_budget(budget),
+  m_pool(new ThreadPool(1)),
+  m_mutex(),
+  m_cond(),
+  m_pending(),
+  m_buffers(),
+  m_lru(),
+  m_streamed(),
+  m_failed(),
+  m_resident_bytes(0),
+  m_hits(0),
+  m_misses(0),
+  m_background_decodes(0),
+  m_evictions(0),
+  m_decode_usec(0)
+{
+}
+
+SoundBufferCache::~SoundBufferCache()
+{
+  // decodes that haven't started yet are dropped
+  m_pool.reset();
+
+  for(const auto& it : m_buffers)
+  {
+    alDeleteBuffers(1, &it.second.buffer);
+  }
+}
+
+SoundBufferCache::State
+SoundBufferCache::get_state(const std::string& filename) const
+{
+  if(m_buffers.find(filename) != m_buffers.end())
+    return READY;
+  else if(m_streamed.find(filename) != m_streamed.end())
+    return STREAM;
+  else if(m_pending.find(filename) != m_pending.end())
+    return PENDING;
+  else if(m_failed.find(filename) != m_failed.end())
+    return FAILED;
+  else
+    return UNKNOWN;
+}
+
+ALuint
+SoundBufferCache::get(const std::string& filename, std::unique_ptr<SoundFile>& stream_file)
+{
+  auto it = m_buffers.find(filename);
+  if(it != m_buffers.end())
+  {
+    m_hits += 1;
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+    return it->second.buffer;
+  }
+
+  if(m_streamed.find(filename) == m_streamed.end())
+  {
+    auto failed = m_failed.find(filename);
+    if(failed != m_failed.end())
+      throw std::runtime_error(failed->second);
+
+    m_misses += 1;
+    std::shared_ptr<Decode> job;
+    auto pending = m_pending.find(filename);
+    if(pending != m_pending.end())
+    {
+      job = pending->second;
+      m_pending.erase(pending);
+
+      // decode it here unless the worker is already busy with it
+      bool decode_here;
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        decode_here = !job->started;
+        job->started = true;
+        if(!decode_here)
+          m_cond.wait(lock, [&job]{ return job->done; });
+      }
+      if(decode_here)
+        decode(*job);
+    }
+    else
+    {
+      job = std::make_shared<Decode>(filename);
+      job->started = true;
+      decode(*job);
+    }
+
+    log_debug << "Uncached sound \"" << filename << "\" requested to be played" << std::endl;
+    finish(*job);
+
+    it = m_buffers.find(filename);
+    if(it != m_buffers.end())
+      return it->second.buffer;
+
+    if(m_streamed.find(filename) == m_streamed.end())
+      throw std::runtime_error(m_failed[filename]);
+  }
+
+  stream_file = load_sound_file(filename);
+  return 0;
+}
+
+void
+SoundBufferCache::preload(const std::string& filename, bool urgent)
+{
+  std::shared_ptr<Decode> job;
+  State state = get_state(filename);
+  if(state == PENDING && urgent)
+  {
+    // queue it again in front, run() skips whichever copy comes second
+    job = m_pending[filename];
+  }
+  else if(state == UNKNOWN)
+  {
+    job = std::make_shared<Decode>(filename);
+    m_pending[filename] = job;
+  }
+  else
+  {
+    return;
+  }
+
+  if(urgent)
+    m_pool->post_front([this, job]{ run(job); });
+  else
+    m_pool->post([this, job]{ run(job); });
+}
+
+void
+SoundBufferCache::update()
+{
+  std::vector<std::shared_ptr<Decode> > finished;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for(auto it = m_pending.begin(); it != m_pending.end(); )
+    {
+      if(it->second->done)
+      {
+        finished.push_back(it->second);
+        it = m_pending.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+  }
+
+  for(const auto& job : finished)
+  {
+    m_background_decodes += 1;
+    finish(*job);
+    if(!job->error.empty())
+    {
+      log_warning << "Error while preloading sound file: " << job->error << std::endl;
+    }
+  }
+}
+
+void
+SoundBufferCache::decode(Decode& job)
+{
+  typedef std::chrono::steady_clock Clock;
+  Clock::time_point start = Clock::now();
+
+  try
+  {
+    std::unique_ptr<SoundFile> file = load_sound_file(job.filename);
+    if(file->size >= STREAM_THRESHOLD)
+    {
+      job.stream = true;
+    }
+    else
+    {
+      job.format = SoundManager::get_sample_format(*file);
+      job.rate = file->rate;
+      job.samples.resize(file->size);
+      file->read(job.samples.data(), file->size);
+    }
+  }
+  catch(const std::exception& err)
+  {
+    job.error = err.what();
+    if(job.error.empty())
+      job.error = "Couldn't decode '" + job.filename + "'";
+  }
+
+  job.usec = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+}
+
+void
+SoundBufferCache::run(std::shared_ptr<Decode> job)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(job->started)
+      return;
+    job->started = true;
+  }
+
+  decode(*job);
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    job->done = true;
+  }
+  m_cond.notify_all();
+}
+
+void
+SoundBufferCache::finish(Decode& job)
+{
+  m_decode_usec += job.usec;
+
+  if(!job.error.empty())
+  {
+    m_failed[job.filename] = job.error;
+    return;
+  }
+
+  if(job.stream)
+  {
+    m_streamed.insert(job.filename);
+    return;
+  }
+
+  ALuint buffer = 0;
+  try
+  {
+    alGenBuffers(1, &buffer);
+    SoundManager::check_al_error("Couldn't create audio buffer: ");
+    alBufferData(buffer, job.format, job.samples.data(),
+                 static_cast<ALsizei>(job.samples.size()),
+                 static_cast<ALsizei>(job.rate));
+    SoundManager::check_al_error("Couldn't fill audio buffer: ");
+  }
+  catch(const std::exception& err)
+  {
+    if(buffer)
+      alDeleteBuffers(1, &buffer);
+    job.error = err.what();
+    m_failed[job.filename] = job.error;
+    return;
+  }
+
+  m_lru.push_front(job.filename);
+  Entry entry;
+  entry.buffer = buffer;
+  entry.bytes = job.samples.size();
+  entry.lru = m_lru.begin();
+  m_buffers[job.filename] = entry;
+  m_resident_bytes += entry.bytes;
+  std::vector<char>().swap(job.samples);
+
+  evict(job.filename);
+}
+
+void
+SoundBufferCache::evict(const std::string& keep)
+{
+  size_t candidates = m_lru.size();
+  while(m_resident_bytes > m_budget && candidates-- > 0)
+  {
+    auto it = m_buffers.find(m_lru.back());
+    if(it->first == keep)
+    {
+      m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+      continue;
+    }
+
+    // OpenAL refuses to delete a buffer that is still attached to a
+    // source, such buffers are simply kept a while longer
+    alGetError();
+    alDeleteBuffers(1, &it->second.buffer);
+    if(alGetError() != AL_NO_ERROR)
+    {
+      m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+      continue;
+    }
+
+    m_resident_bytes -= it->second.bytes;
+    m_lru.erase(it->second.lru);
+    m_buffers.erase(it);
+    m_evictions += 1;
+  }
+}
+
+void
+SoundBufferCache::print_stats(std::ostream& out) const
+{
+  int lookups = m_hits + m_misses;
+  out << "Sound buffers: " << m_buffers.size()
+      << " resident, " << m_resident_bytes / 1024 << " KiB, budget "
+      << m_budget / 1024 << " KiB" << std::endl;
+  out << "Hits: " << m_hits << ", misses: " << m_misses
+      << " (" << (lookups ? 100 * m_hits / lookups : 0) << "% hit rate)"
+      << ", evictions: " << m_evictions << std::endl;
+  out << "Decoded in background: " << m_background_decodes
+      << ", pending: " << m_pending.size()
+      << ", total decode time: " << m_decode_usec / 1000 << " ms"
+      << ", streamed: " << m_streamed.size()
+      << ", failed: " << m_failed.size() << std::endl;
+}
+
+/* EOF */
@@ -0,0 +1,129 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADER_SUPERTUX_AUDIO_SOUND_BUFFER_CACHE_HPP
+#define HEADER_SUPERTUX_AUDIO_SOUND_BUFFER_CACHE_HPP
+
+#include <al.h>
+
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class SoundFile;
+class ThreadPool;
+
+/** OpenAL buffers of the sound effects, decoded on a background thread
+    and kept in memory up to a byte budget. When the budget is exceeded
+    the least recently used buffers that no source plays anymore are
+    deleted. All functions must be called from the main thread. */
+class SoundBufferCache
+{
+public:
+  /** files at least this large are streamed instead of decoded */
+  static const size_t STREAM_THRESHOLD = 100000;
+
+  enum State { UNKNOWN, PENDING, READY, STREAM, FAILED };
+
+public:
+  /** @param budget  bytes of sample data to keep in buffers */
+  SoundBufferCache(size_t budget);
+  ~SoundBufferCache();
+
+  State get_state(const std::string& filename) const;
+
+  /** Returns the buffer of @c filename, waiting for a running
+      background decode or decoding right away on a miss. Returns 0
+      and sets @c stream_file if the file must be streamed instead.
+      Throws if the file can't be decoded. */
+  ALuint get(const std::string& filename, std::unique_ptr<SoundFile>& stream_file);
+
+  /** Starts decoding @c filename in the background. An @c urgent
+      decode, e.g. for a sound that should play right now, runs before
+      the queued preloads. */
+  void preload(const std::string& filename, bool urgent = false);
+
+  /** Uploads finished background decodes into buffers */
+  void update();
+
+  void print_stats(std::ostream& out) const;
+
+private:
+  struct Decode
+  {
+    Decode(const std::string& filename_);
+
+    std::string filename;
+    /** guarded by m_mutex */
+    bool started;
+    bool done;
+
+    bool stream;
+    std::string error;
+    std::vector<char> samples;
+    ALenum format;
+    int rate;
+    int64_t usec;
+  };
+
+  struct Entry
+  {
+    ALuint buffer;
+    size_t bytes;
+    std::list<std::string>::iterator lru;
+  };
+
+  static void decode(Decode& job);
+  void run(std::shared_ptr<Decode> job);
+  /** Turns a finished decode into a buffer or remembers why it failed */
+  void finish(Decode& job);
+  void evict(const std::string& keep);
+
+private:
+  size_t m_budget;
+  std::unique_ptr<ThreadPool> m_pool;
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+
+  std::map<std::string, std::shared_ptr<Decode> > m_pending;
+  std::map<std::string, Entry> m_buffers;
+  /** most recently used first */
+  std::list<std::string> m_lru;
+  std::set<std::string> m_streamed;
+  std::map<std::string, std::string> m_failed;
+
+  size_t m_resident_bytes;
+  int m_hits;
+  int m_misses;
+  int m_background_decodes;
+  int m_evictions;
+  int64_t m_decode_usec;
+
+private:
+  SoundBufferCache(const SoundBufferCache&) = delete;
+  SoundBufferCache& operator=(const SoundBufferCache&) = delete;
+};
+
+#endif
+
+/* EOF */
@@ -17,27 +17,76 @@
 #include "audio/sound_manager.hpp"
 
 #include <SDL.h>
+#include <algorithm>
 #include <assert.h>
 #include <stdexcept>
 #include <sstream>
 #include <memory>
 
+#include "audio/audio_stream_thread.hpp"
 #include "audio/dummy_sound_source.hpp"
+#include "audio/music_intro_cache.hpp"
+#include "audio/software_mixer.hpp"
+#include "audio/software_sound_source.hpp"
+#include "audio/sound_buffer_cache.hpp"
 #include "audio/sound_file.hpp"
+#include "audio/sound_preload_manifest.hpp"
+#include "audio/sound_voice_pool.hpp"
+#include "audio/sound_sink.hpp"
 #include "audio/stream_sound_source.hpp"
+#include "supertux/constants.hpp"
 #include "util/log.hpp"
 
+namespace {
+
+/** bytes of decoded sound effects kept in OpenAL buffers */
+const size_t SOUND_BUFFER_BUDGET = 32 * 1024 * 1024;
+
+/** Positioned sounds further away from the listener than this are not
+    played, with the listener 300 units in front of the level they are
+    attenuated by about 20dB at that point */
+const float MAX_SOUND_DISTANCE = 1200.0f;
+
+} // namespace
+
 SoundManager::SoundManager() :
-  device(alcOpenDevice(0)),
-  context(alcCreateContext(device, /* attributes = */ 0)),
+  SoundManager(std::unique_ptr<SoundSink>())
+{
+}
+
+SoundManager::SoundManager(std::unique_ptr<SoundSink> sink) :
+  device(sink ? NULL : alcOpenDevice(0)),
+  context(device ? alcCreateContext(device, /* attributes = */ 0) : NULL),
   sound_enabled(false),
-  buffers(),
+  m_buffer_cache(),
+  m_manifest(),
+  m_deferred_plays(),
+  m_deferred_count(0),
+  m_late_count(0),
+  m_lost_count(0),
+  m_voices(),
+  m_listener_position(),
+  m_culled_count(0),
   sources(),
-  update_list(),
+  m_stream_thread(),
   music_source(),
+  m_previous_music(),
+  m_previous_music_ticks(0),
+  m_music_intros(),
+  m_mixer(),
+  m_software_sources(),
+  m_software_music(),
   music_enabled(false),
   current_music()
 {
+  if(sink) {
+    m_mixer.reset(new SoftwareMixer(SOFTWARE_MIXER_RATE, static_cast<int>(LOGICAL_FPS),
+                                    std::move(sink)));
+    sound_enabled = true;
+    music_enabled = true;
+    return;
+  }
+
   try {
     if (device == NULL) {
       throw std::runtime_error("Couldn't open audio device.");
@@ -49,6 +98,10 @@ SoundManager::SoundManager() :
     check_al_error("Audio error after init: ");
     sound_enabled = true;
     music_enabled = true;
+    m_stream_thread.reset(new AudioStreamThread);
+    m_buffer_cache.reset(new SoundBufferCache(SOUND_BUFFER_BUDGET));
+    m_voices.reset(new SoundVoicePool(VOICE_COUNT));
+    m_music_intros.reset(new MusicIntroCache(MUSIC_INTRO_CACHE_SIZE));
 
     set_listener_orientation(Vector(0.0f, 0.0f), Vector(0.0f, -1.0f));
   } catch(std::exception& e) {
@@ -67,12 +120,21 @@ SoundManager::SoundManager() :
 
 SoundManager::~SoundManager()
 {
+  if(m_manifest) {
+    m_manifest->save();
+  }
+
+  m_software_music.reset();
+  m_software_sources.clear();
+  m_mixer.reset();
+
+  m_previous_music.reset();
   music_source.reset();
   sources.clear();
-
-  for(const auto& buffer : buffers) {
-    alDeleteBuffers(1, &buffer.second);
-  }
+  m_voices.reset();
+  m_stream_thread.reset();
+  m_music_intros.reset();
+  m_buffer_cache.reset();
 
   if(context != NULL) {
     alcDestroyContext(context);
@@ -84,58 +146,24 @@ SoundManager::~SoundManager()
   }
 }
 
-ALuint
-SoundManager::load_file_into_buffer(SoundFile& file)
-{
-  ALenum format = get_sample_format(file);
-  ALuint buffer;
-  alGenBuffers(1, &buffer);
-  check_al_error("Couldn't create audio buffer: ");
-  std::unique_ptr<char[]> samples(new char[file.size]);
-  file.read(samples.get(), file.size);
-  log_debug << "buffer: " << buffer << "\n"
-            << "format: " << format << "\n"
-            << "samples: " << samples.get() << "\n"
-            << "file size: " << static_cast<ALsizei>(file.size) << "\n"
-            << "file rate: " << static_cast<ALsizei>(file.rate) << "\n";
-
-  alBufferData(buffer, format, samples.get(),
-               static_cast<ALsizei>(file.size),
-               static_cast<ALsizei>(file.rate));
-  check_al_error("Couldn't fill audio buffer: ");
-
-  return buffer;
-}
-
 std::unique_ptr<OpenALSoundSource>
 SoundManager::intern_create_sound_source(const std::string& filename)
 {
   assert(sound_enabled);
 
-  std::unique_ptr<OpenALSoundSource> source(new OpenALSoundSource);
-
-  ALuint buffer;
-
-  // reuse an existing static sound buffer
-  SoundBuffers::iterator i = buffers.find(filename);
-  if(i != buffers.end()) {
-    buffer = i->second;
-  } else {
-    // Load sound file
-    std::unique_ptr<SoundFile> file(load_sound_file(filename));
-
-    if(file->size < 100000) {
-      buffer = load_file_into_buffer(*file);
-      buffers.insert(std::make_pair(filename, buffer));
-    } else {
-      std::unique_ptr<StreamSoundSource> source_(new StreamSoundSource);
-      source_->set_sound_file(std::move(file));
-      return std::move(source_);
-    }
+  if(m_manifest) {
+    m_manifest->add(filename);
+  }
 
-    log_debug << "Uncached sound \"" << filename << "\" requested to be played" << std::endl;
+  std::unique_ptr<SoundFile> stream_file;
+  ALuint buffer = m_buffer_cache->get(filename, stream_file);
+  if(stream_file) {
+    std::unique_ptr<StreamSoundSource> source_(new StreamSoundSource);
+    source_->set_sound_file(std::move(stream_file));
+    return std::move(source_);
   }
 
+  std::unique_ptr<OpenALSoundSource> source(new OpenALSoundSource);
   alSourcei(source->source, AL_BUFFER, buffer);
   return source;
 }
@@ -147,6 +175,9 @@ SoundManager::create_sound_source(const std::string& filename)
     return create_dummy_sound_source();
 
   try {
+    if(m_mixer) {
+      return m_mixer->create_source(filename);
+    }
     return intern_create_sound_source(filename);
   } catch(std::exception &e) {
     log_warning << "Couldn't create audio source: " << e.what() << std::endl;
@@ -156,48 +187,179 @@ SoundManager::create_sound_source(const std::string& filename)
 
 void
 SoundManager::preload(const std::string& filename)
+{
+  // the software mixer decodes on first use, which keeps it deterministic
+  if(!sound_enabled || m_mixer)
+    return;
+
+  if(m_manifest) {
+    m_manifest->add(filename);
+  }
+  m_buffer_cache->preload(filename);
+}
+
+void
+SoundManager::begin_preload_manifest(const std::string& level_filename)
+{
+  if(m_manifest && m_manifest->get_level_filename() == level_filename)
+    return;
+
+  if(m_manifest) {
+    m_manifest->save();
+  }
+  m_manifest.reset(new SoundPreloadManifest(level_filename));
+
+  if(!sound_enabled || !m_buffer_cache)
+    return;
+
+  for(const auto& sound : m_manifest->get_sounds()) {
+    m_buffer_cache->preload(sound);
+  }
+}
+
+void
+SoundManager::end_preload_manifest()
+{
+  if(!m_manifest)
+    return;
+
+  m_manifest->save();
+  m_manifest.reset();
+}
+
+void
+SoundManager::play(const std::string& filename, const Vector& pos,
+                   SoundPriority priority)
 {
   if(!sound_enabled)
     return;
 
-  SoundBuffers::iterator i = buffers.find(filename);
-  // already loaded?
-  if(i != buffers.end())
+  if(m_mixer) {
+    play_software(filename, pos);
+    return;
+  }
+
+  switch(m_buffer_cache->get_state(filename)) {
+    case SoundBufferCache::READY:
+    case SoundBufferCache::STREAM:
+      start_sound(filename, pos, priority);
+      break;
+
+    case SoundBufferCache::FAILED:
+      break;
+
+    case SoundBufferCache::UNKNOWN:
+    case SoundBufferCache::PENDING:
+      // don't decode on the main thread, play it once it's ready
+      if(m_manifest) {
+        m_manifest->add(filename);
+      }
+      m_buffer_cache->preload(filename, true);
+      m_deferred_plays.push_back(DeferredPlay{filename, pos, priority, SDL_GetTicks()});
+      m_deferred_count += 1;
+      break;
+  }
+}
+
+void
+SoundManager::start_sound(const std::string& filename, const Vector& pos,
+                          SoundPriority priority)
+{
+  bool relative = pos.x < 0 || pos.y < 0;
+  if(!relative && (pos - m_listener_position).norm() > MAX_SOUND_DISTANCE) {
+    m_culled_count += 1;
     return;
+  }
+
   try {
-    std::unique_ptr<SoundFile> file (load_sound_file(filename));
-    // only keep small files
-    if(file->size >= 100000)
+    std::unique_ptr<SoundFile> stream_file;
+    ALuint buffer = m_buffer_cache->get(filename, stream_file);
+    if(!stream_file) {
+      m_voices->play(buffer, filename, priority, pos);
       return;
+    }
 
-    ALuint buffer = load_file_into_buffer(*file);
-    buffers.insert(std::make_pair(filename, buffer));
+    // too long to be decoded at once, give it a source of its own
+    std::unique_ptr<StreamSoundSource> source(new StreamSoundSource);
+    source->set_sound_file(std::move(stream_file));
+    if(relative) {
+      source->set_relative(true);
+    } else {
+      source->set_position(pos);
+    }
+    source->play();
+    sources.push_back(std::move(source));
   } catch(std::exception& e) {
-    log_warning << "Error while preloading sound file: " << e.what() << std::endl;
+    log_warning << "Couldn't play sound " << filename << ": " << e.what() << std::endl;
   }
 }
 
 void
-SoundManager::play(const std::string& filename, const Vector& pos)
+SoundManager::play_software(const std::string& filename, const Vector& pos)
 {
-  if(!sound_enabled)
-    return;
+  m_mixer->record_event(filename);
 
   try {
-    std::unique_ptr<OpenALSoundSource> source(intern_create_sound_source(filename));
-
+    std::unique_ptr<SoftwareSoundSource> source = m_mixer->create_source(filename);
     if(pos.x < 0 || pos.y < 0) {
       source->set_relative(true);
     } else {
       source->set_position(pos);
     }
     source->play();
-    sources.push_back(std::move(source));
+    m_software_sources.push_back(std::move(source));
   } catch(std::exception& e) {
     log_warning << "Couldn't play sound " << filename << ": " << e.what() << std::endl;
   }
 }
 
+void
+SoundManager::play_deferred()
+{
+  Uint32 now = SDL_GetTicks();
+  for(auto it = m_deferred_plays.begin(); it != m_deferred_plays.end(); ) {
+    SoundBufferCache::State state = m_buffer_cache->get_state(it->filename);
+    bool late = now - it->ticks > MAX_PLAY_LATENCY;
+    if(state == SoundBufferCache::PENDING && !late) {
+      ++it;
+      continue;
+    }
+
+    if(state == SoundBufferCache::FAILED) {
+      m_lost_count += 1;
+    } else {
+      // a sound still pending is decoded right here by start_sound()
+      if(late) {
+        m_late_count += 1;
+      }
+      start_sound(it->filename, it->pos, it->priority);
+    }
+    it = m_deferred_plays.erase(it);
+  }
+}
+
+void
+SoundManager::print_stats(std::ostream& out) const
+{
+  if(m_mixer) {
+    m_mixer->print_stats(out);
+    return;
+  }
+
+  if(!m_buffer_cache) {
+    out << "Sound is disabled" << std::endl;
+    return;
+  }
+
+  m_buffer_cache->print_stats(out);
+  m_voices->print_stats(out);
+  m_music_intros->print_stats(out);
+  out << "Culled by distance: " << m_culled_count << std::endl;
+  out << "Plays waiting for a decode: " << m_deferred_count
+      << ", played late: " << m_late_count
+      << ", lost to failed decodes: " << m_lost_count << std::endl;
+}
+
 void
 SoundManager::manage_source(std::unique_ptr<SoundSource> source)
 {
@@ -207,37 +369,35 @@ SoundManager::manage_source(std::unique_ptr<SoundSource> source)
     std::unique_ptr<OpenALSoundSource> openal_source(dynamic_cast<OpenALSoundSource*>(source.release()));
     sources.push_back(std::move(openal_source));
   }
+  else if (dynamic_cast<SoftwareSoundSource*>(source.get()))
+  {
+    std::unique_ptr<SoftwareSoundSource> software_source(dynamic_cast<SoftwareSoundSource*>(source.release()));
+    m_software_sources.push_back(std::move(software_source));
+  }
 }
 
 void
 SoundManager::register_for_update(StreamSoundSource* sss)
 {
-  if (sss)
+  if (sss && m_stream_thread)
   {
-    update_list.push_back(sss);
+    m_stream_thread->add(sss);
   }
 }
 
 void
 SoundManager::remove_from_update(StreamSoundSource* sss)
 {
-  if (sss)
+  if (sss && m_stream_thread)
   {
-    StreamSoundSources::iterator i = update_list.begin();
-    while( i != update_list.end() ){
-      if( *i == sss ){
-        i = update_list.erase(i);
-      } else {
-        ++i;
-      }
-    }
+    m_stream_thread->remove(sss);
   }
 }
 
 void
 SoundManager::enable_sound(bool enable)
 {
-  if(device == NULL)
+  if(!is_audio_enabled())
     return;
 
   sound_enabled = enable;
@@ -246,7 +406,7 @@ SoundManager::enable_sound(bool enable)
 void
 SoundManager::enable_music(bool enable)
 {
-  if(device == NULL)
+  if(!is_audio_enabled())
     return;
 
   music_enabled = enable;
@@ -256,18 +416,24 @@ SoundManager::enable_music(bool enable)
     if(music_source) {
       music_source.reset();
     }
+    m_previous_music.reset();
+    m_software_music.reset();
   }
 }
 
 void
 SoundManager::stop_music(float fadetime)
 {
+  // the software mixer doesn't fade
+  m_software_music.reset();
+
   if(fadetime > 0) {
     if(music_source
        && music_source->get_fade_state() != StreamSoundSource::FadingOff)
       music_source->set_fading(StreamSoundSource::FadingOff, fadetime);
   } else {
     music_source.reset();
+    m_previous_music.reset();
   }
   current_music = "";
 }
@@ -275,6 +441,11 @@ SoundManager::stop_music(float fadetime)
 void
 SoundManager::play_music(const std::string& filename, bool fade)
 {
+  if(m_mixer) {
+    play_software_music(filename);
+    return;
+  }
+
   if(filename == current_music && music_source != NULL)
   {
     if(music_source->paused())
@@ -287,25 +458,39 @@ SoundManager::play_music(const std::string& filename, bool fade)
     }
     return;
   }
+  std::string replaced_music = current_music;
   current_music = filename;
   if(!music_enabled)
     return;
 
   if(filename.empty()) {
     music_source.reset();
+    m_previous_music.reset();
     return;
   }
 
   try {
+    // the file is opened and decoded by the stream thread, or comes
+    // from the intro cache
     std::unique_ptr<StreamSoundSource> newmusic (new StreamSoundSource());
-    newmusic->set_sound_file(load_sound_file(filename));
+    newmusic->set_sound_file(m_music_intros->open(filename));
     newmusic->set_looping(true);
     newmusic->set_relative(true);
     if(fade)
       newmusic->set_fading(StreamSoundSource::FadingOn, .5f);
     newmusic->play();
 
+    // keep the old music until the new one plays, so there's no gap
+    m_previous_music = std::move(music_source);
+    m_previous_music_ticks = SDL_GetTicks();
+    if(m_previous_music && fade
+       && m_previous_music->get_fade_state() != StreamSoundSource::FadingOff)
+      m_previous_music->set_fading(StreamSoundSource::FadingOff, .5f);
+
     music_source = std::move(newmusic);
+
+    // the game often switches back (herring, sector changes)
+    m_music_intros->prefetch(replaced_music);
   } catch(std::exception& e) {
     log_warning << "Couldn't play music file '" << filename << "': " << e.what() << std::endl;
     // When this happens, previous music continued playing, stop it, just in case.
@@ -313,9 +498,66 @@ SoundManager::play_music(const std::string& filename, bool fade)
   }
 }
 
+void
+SoundManager::preload_music(const std::string& filename)
+{
+  if(m_music_intros && music_enabled) {
+    m_music_intros->prefetch(filename);
+  }
+}
+
+void
+SoundManager::update_previous_music()
+{
+  if(!m_previous_music)
+    return;
+
+  m_previous_music->update();
+
+  bool handed_off = !music_source || music_source->started() || !music_source->playing() ||
+    SDL_GetTicks() - m_previous_music_ticks > MUSIC_HANDOFF_TIMEOUT;
+  if(!m_previous_music->playing() ||
+     (handed_off && m_previous_music->get_fade_state() == StreamSoundSource::NoFading)) {
+    m_previous_music.reset();
+  }
+}
+
+void
+SoundManager::play_software_music(const std::string& filename)
+{
+  if(filename == current_music && m_software_music) {
+    if(m_software_music->paused()) {
+      m_software_music->resume();
+    } else if(!m_software_music->playing()) {
+      m_software_music->play();
+    }
+    return;
+  }
+  current_music = filename;
+  m_software_music.reset();
+  if(!music_enabled || filename.empty())
+    return;
+
+  m_mixer->record_event(filename);
+  try {
+    m_software_music = m_mixer->create_source(filename);
+    m_software_music->set_looping(true);
+    m_software_music->set_relative(true);
+    m_software_music->play();
+  } catch(std::exception& e) {
+    log_warning << "Couldn't play music file '" << filename << "': " << e.what() << std::endl;
+  }
+}
+
 void
 SoundManager::pause_music(float fadetime)
 {
+  if(m_software_music) {
+    m_software_music->pause();
+    return;
+  }
+
+  m_previous_music.reset();
   if(music_source == NULL)
     return;
 
@@ -331,6 +573,14 @@ SoundManager::pause_music(float fadetime)
 void
 SoundManager::pause_sounds()
 {
+  for(auto& source : m_software_sources) {
+    source->pause();
+  }
+
+  if(m_voices) {
+    m_voices->pause();
+  }
+
   for(auto& source : sources) {
     if(source->playing()) {
       source->pause();
@@ -341,6 +591,14 @@ SoundManager::pause_sounds()
 void
 SoundManager::resume_sounds()
 {
+  for(auto& source : m_software_sources) {
+    source->resume();
+  }
+
+  if(m_voices) {
+    m_voices->resume();
+  }
+
   for(auto& source : sources) {
     if(source->paused()) {
       source->resume();
@@ -351,6 +609,14 @@ SoundManager::resume_sounds()
 void
 SoundManager::stop_sounds()
 {
+  for(auto& source : m_software_sources) {
+    source->stop();
+  }
+
+  if(m_voices) {
+    m_voices->stop();
+  }
+
   for(auto& source : sources) {
     source->stop();
   }
@@ -359,6 +625,11 @@ SoundManager::stop_sounds()
 void
 SoundManager::resume_music(float fadetime)
 {
+  if(m_software_music) {
+    m_software_music->resume();
+    return;
+  }
+
   if(music_source == NULL)
     return;
 
@@ -374,6 +645,12 @@ SoundManager::resume_music(float fadetime)
 void
 SoundManager::set_listener_position(const Vector& pos)
 {
+  m_listener_position = pos;
+  if(m_mixer) {
+    m_mixer->set_listener_position(pos);
+    return;
+  }
+
   static Uint32 lastticks = SDL_GetTicks();
 
   Uint32 current_ticks = SDL_GetTicks();
@@ -400,6 +677,25 @@ SoundManager::set_listener_orientation(const Vector& at, const Vector& up)
 void
 SoundManager::update()
 {
+  if(m_mixer) {
+    m_software_sources.erase(
+      std::remove_if(m_software_sources.begin(), m_software_sources.end(),
+                     [](const std::unique_ptr<SoftwareSoundSource>& source) {
+                       return !source->playing() && !source->paused();
+                     }),
+      m_software_sources.end());
+    return;
+  }
+
+  // finished decodes and voices, and the sounds waiting for a decode, are
+  // handled every frame
+  if(m_buffer_cache) {
+    m_buffer_cache->update();
+    m_voices->update();
+    play_deferred();
+  }
+  update_previous_music();
+
   static Uint32 lasttime = SDL_GetTicks();
   Uint32 now = SDL_GetTicks();
 
@@ -419,7 +715,7 @@ SoundManager::update()
       ++i;
     }
   }
-  // check streaming sounds
+  // fade the music, its buffers are refilled by the stream thread
   if(music_source) {
     music_source->update();
   }
@@ -429,12 +725,13 @@ SoundManager::update()
     alcProcessContext(context);
     check_alc_error("Error while processing audio context: ");
   }
+}
 
-  //run update() for stream_sound_source
-  StreamSoundSources::iterator s = update_list.begin();
-  while( s != update_list.end() ){
-    (*s)->update();
-    ++s;
+void
+SoundManager::mix_frame()
+{
+  if(m_mixer) {
+    m_mixer->mix_frame();
   }
 }
 
@@ -17,26 +17,45 @@
 #ifndef HEADER_SUPERTUX_AUDIO_SOUND_MANAGER_HPP
 #define HEADER_SUPERTUX_AUDIO_SOUND_MANAGER_HPP
 
-#include <map>
 #include <memory>
+#include <ostream>
+#include <stdint.h>
 #include <string>
 #include <vector>
 
 #include <al.h>
 #include <alc.h>
 
+#include "audio/sound_priority.hpp"
 #include "math/vector.hpp"
 #include "util/currenton.hpp"
 
+class AudioStreamThread;
+class MusicIntroCache;
+class SoftwareMixer;
+class SoftwareSoundSource;
+class SoundBufferCache;
 class SoundFile;
+class SoundPreloadManifest;
+class SoundSink;
 class SoundSource;
+class SoundVoicePool;
 class StreamSoundSource;
 class OpenALSoundSource;
 
 class SoundManager : public Currenton<SoundManager>
 {
+public:
+  /** output rate of the software mixer */
+  static const int SOFTWARE_MIXER_RATE = 44100;
+
 public:
   SoundManager();
+  /**
+   * Mixes in software into @c sink instead of playing through OpenAL,
+   * OpenAL is used if @c sink is NULL
+   */
+  explicit SoundManager(std::unique_ptr<SoundSink> sink);
   virtual ~SoundManager();
 
   void enable_sound(bool sound_enabled);
@@ -49,22 +68,47 @@ public:
   std::unique_ptr<SoundSource> create_sound_source(const std::string& filename);
   /**
    * Convenience function to simply play a sound at a given position.
+   * Sounds far away from the listener are not played at all, and when
+   * all voices are busy the sound may replace one with a lower or the
+   * same @c priority.
    */
-  void play(const std::string& name, const Vector& pos = Vector(-1, -1));
+  void play(const std::string& name, const Vector& pos = Vector(-1, -1),
+            SoundPriority priority = SOUND_PRIORITY_NORMAL);
   /**
    * Adds the source to the list of managed sources (= the source gets deleted
    * when it finished playing)
    */
   void manage_source(std::unique_ptr<SoundSource> source);
-  /// preloads a sound, so that you don't get a lag later when playing it
+  /// preloads a sound in the background, so that you don't get a lag later when playing it
   void preload(const std::string& name);
 
+  /**
+   * Starts preloading the sounds @c level_filename used the last time
+   * it was played and records the sounds it uses this time, until
+   * end_preload_manifest() is called.
+   */
+  void begin_preload_manifest(const std::string& level_filename);
+
+  /** Stops recording sounds for the current level and saves its
+      manifest, called when the level session ends */
+  void end_preload_manifest();
+
+  /** print buffer cache statistics (resident bytes, hit rate, decode time) */
+  void print_stats(std::ostream& out) const;
+
   void set_listener_position(const Vector& position);
   void set_listener_velocity(const Vector& velocity);
   void set_listener_orientation(const Vector& at, const Vector& up);
 
   void enable_music(bool music_enabled);
+  /**
+   * Switches to @c filename. The old music keeps playing until the new
+   * one is buffered, or fades out if @c fade is set.
+   */
   void play_music(const std::string& filename, bool fade = false);
+  /** decodes the beginning of @c filename in the background, so that
+      play_music() can start it right away */
+  void preload_music(const std::string& filename);
   void pause_music(float fadetime = 0);
   void resume_music(float fadetime = 0);
   void stop_music(float fadetime = 0);
@@ -77,29 +121,67 @@ public:
   bool is_sound_enabled() const { return sound_enabled; }
 
   bool is_audio_enabled() const {
-    return device != 0 && context != 0;
+    return (device != 0 && context != 0) || m_mixer;
   }
   std::string get_current_music() const {
     return current_music;
   }
   void update();
 
+  /**
+   * Mixes the audio of one game frame when mixing in software, called
+   * once per game logic update
+   */
+  void mix_frame();
+
+  /** the software mixer or NULL when playing through OpenAL */
+  SoftwareMixer* get_software_mixer() const { return m_mixer.get(); }
+
   /*
-   * Tell soundmanager to call update() for stream_sound_source.
+   * Let the stream thread refill the buffers of stream_sound_source.
    */
   void register_for_update( StreamSoundSource* sss );
   /*
-   * Unsubscribe from updates for stream_sound_source.
+   * Stop refilling stream_sound_source, doesn't wait for the stream thread.
    */
   void remove_from_update( StreamSoundSource* sss );
 
 private:
   friend class OpenALSoundSource;
+  friend class SoundBufferCache;
+  friend class SoundVoicePool;
   friend class StreamSoundSource;
 
+  /** play() requests for sounds that are still being decoded */
+  struct DeferredPlay
+  {
+    std::string filename;
+    Vector pos;
+    SoundPriority priority;
+    uint32_t ticks;
+  };
+
+  /** play() requests still waiting for the worker after this long
+      decode on the main thread instead */
+  static const uint32_t MAX_PLAY_LATENCY = 150;
+
+  /** number of OpenAL sources shared by play() */
+  static const int VOICE_COUNT = 24;
+
+  /** number of music files whose beginning is kept decoded */
+  static const size_t MUSIC_INTRO_CACHE_SIZE = 4;
+
+  /** the replaced music is stopped after this long even if the new
+      music didn't start yet */
+  static const uint32_t MUSIC_HANDOFF_TIMEOUT = 1000;
   /** creates a new sound source, might throw exceptions, never returns NULL */
   std::unique_ptr<OpenALSoundSource> intern_create_sound_source(const std::string& filename);
-  static ALuint load_file_into_buffer(SoundFile& file);
+  void start_sound(const std::string& filename, const Vector& pos, SoundPriority priority);
+  void play_deferred();
+  void play_software(const std::string& filename, const Vector& pos);
+  void play_software_music(const std::string& filename);
+  /** fades and stops the replaced music once the new one plays */
+  void update_previous_music();
   static ALenum get_sample_format(const SoundFile& file);
 
   static void print_openal_version();
@@ -110,15 +192,31 @@ private:
   ALCcontext* context;
   bool sound_enabled;
 
-  typedef std::map<std::string, ALuint> SoundBuffers;
-  SoundBuffers buffers;
+  std::unique_ptr<SoundBufferCache> m_buffer_cache;
+  std::unique_ptr<SoundPreloadManifest> m_manifest;
+  std::vector<DeferredPlay> m_deferred_plays;
+  int m_deferred_count;
+  int m_late_count;
+  int m_lost_count;
+
+  std::unique_ptr<SoundVoicePool> m_voices;
+  Vector m_listener_position;
+  int m_culled_count;
+
   typedef std::vector<std::unique_ptr<OpenALSoundSource> > SoundSources;
   SoundSources sources;
 
-  typedef std::vector<StreamSoundSource*> StreamSoundSources;
-  StreamSoundSources update_list;
+  std::unique_ptr<AudioStreamThread> m_stream_thread;
 
   std::unique_ptr<StreamSoundSource> music_source;
+  /** the music that music_source replaced, until music_source plays */
+  std::unique_ptr<StreamSoundSource> m_previous_music;
+  uint32_t m_previous_music_ticks;
+  std::unique_ptr<MusicIntroCache> m_music_intros;
+
+  std::unique_ptr<SoftwareMixer> m_mixer;
+  std::vector<std::unique_ptr<SoftwareSoundSource> > m_software_sources;
+  std::unique_ptr<SoftwareSoundSource> m_software_music;
 
   bool music_enabled;
   std::string current_music;
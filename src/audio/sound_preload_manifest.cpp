@@ -0,0 +1,114 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "audio/sound_preload_manifest.hpp"
+
+#include <ctype.h>
+#include <vector>
+
+#include "physfs/physfs_file_system.hpp"
+#include "util/file_system.hpp"
+#include "util/log.hpp"
+#include "util/reader_document.hpp"
+#include "util/reader_mapping.hpp"
+#include "util/writer.hpp"
+
+namespace {
+
+const int MANIFEST_VERSION = 1;
+const char* const MANIFEST_DIRECTORY = "cache/sounds";
+
+} // namespace
+
+SoundPreloadManifest::SoundPreloadManifest(const std::string& level_filename) :
+  m_level_filename(level_filename),
+  m_sounds(),
+  m_changed(false)
+{
+  std::string filename = get_manifest_filename();
+  if (!PhysFSFileSystem::exists(filename))
+    return;
+
+  try
+  {
+    auto doc = ReaderDocument::parse(filename);
+    auto root = doc.get_root();
+    if (root.get_name() != "supertux-sound-manifest")
+      return;
+
+    auto mapping = root.get_mapping();
+    int version = 0;
+    mapping.get("version", version);
+    if (version != MANIFEST_VERSION)
+      return;
+
+    std::vector<std::string> sounds;
+    mapping.get("sounds", sounds);
+    m_sounds.insert(sounds.begin(), sounds.end());
+  }
+  catch(const std::exception& err)
+  {
+    log_warning << "Couldn't read sound manifest '" << filename << "': " << err.what() << std::endl;
+  }
+}
+
+std::string
+SoundPreloadManifest::get_manifest_filename() const
+{
+  std::string name = m_level_filename;
+  for (auto& c : name)
+  {
+    if (!isalnum(static_cast<unsigned char>(c)) && c != '-')
+      c = '_';
+  }
+  return FileSystem::join(MANIFEST_DIRECTORY, name + ".stsm");
+}
+
+void
+SoundPreloadManifest::add(const std::string& sound)
+{
+  if (m_sounds.insert(sound).second)
+    m_changed = true;
+}
+
+void
+SoundPreloadManifest::save()
+{
+  if (!m_changed)
+    return;
+
+  try
+  {
+    if (!PhysFSFileSystem::exists(MANIFEST_DIRECTORY) && !PhysFSFileSystem::mkdir(MANIFEST_DIRECTORY))
+    {
+      log_warning << "Couldn't create directory '" << MANIFEST_DIRECTORY << "'" << std::endl;
+      return;
+    }
+
+    Writer writer(get_manifest_filename());
+    writer.start_list("supertux-sound-manifest");
+    writer.write("version", MANIFEST_VERSION);
+    writer.write("sounds", std::vector<std::string>(m_sounds.begin(), m_sounds.end()));
+    writer.end_list("supertux-sound-manifest");
+    m_changed = false;
+  }
+  catch(const std::exception& err)
+  {
+    log_warning << "Couldn't write sound manifest for '" << m_level_filename << "': " << err.what() << std::endl;
+  }
+}
+
+/* EOF */
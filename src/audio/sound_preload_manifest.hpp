@@ -0,0 +1,61 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADER_SUPERTUX_AUDIO_SOUND_PRELOAD_MANIFEST_HPP
+#define HEADER_SUPERTUX_AUDIO_SOUND_PRELOAD_MANIFEST_HPP
+
+#include <set>
+#include <string>
+
+/** The sound files a level used while it was played. Most sounds are
+    named in the code of the objects rather than in the level file, so
+    the list can't be derived from the level itself; instead it records
+    what is preloaded and played between
+    SoundManager::begin_preload_manifest() and end_preload_manifest(),
+    i.e. during one GameSession. The list is stored in the user dir, so
+    the next time the level is loaded all of its sounds can be decoded
+    in the background right away, before the sectors that create the
+    objects are even entered. */
+class SoundPreloadManifest
+{
+public:
+  /** Reads the manifest of @c level_filename if there is one */
+  SoundPreloadManifest(const std::string& level_filename);
+
+  const std::string& get_level_filename() const { return m_level_filename; }
+  const std::set<std::string>& get_sounds() const { return m_sounds; }
+
+  void add(const std::string& sound);
+
+  /** Writes the manifest back if sounds were added */
+  void save();
+
+private:
+  std::string get_manifest_filename() const;
+
+private:
+  std::string m_level_filename;
+  std::set<std::string> m_sounds;
+  bool m_changed;
+
+private:
+  SoundPreloadManifest(const SoundPreloadManifest&) = delete;
+  SoundPreloadManifest& operator=(const SoundPreloadManifest&) = delete;
+};
+
+#endif
+
+/* EOF */
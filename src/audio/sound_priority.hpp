@@ -0,0 +1,34 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HEADER_SUPERTUX_AUDIO_SOUND_PRIORITY_HPP
+#define HEADER_SUPERTUX_AUDIO_SOUND_PRIORITY_HPP
+
+/** When all voices are busy, a sound may take over the voice of a
+    sound with the same or a lower priority */
+enum SoundPriority
+{
+  /** frequent, interchangeable sounds (coins, bricks) */
+  SOUND_PRIORITY_LOW,
+  SOUND_PRIORITY_NORMAL,
+  /** feedback the player must not miss (life up, hurt) */
+  SOUND_PRIORITY_HIGH
+};
+
+#endif
+
+/* EOF */
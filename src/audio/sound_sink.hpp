@@ -0,0 +1,46 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HEADER_SUPERTUX_AUDIO_SOUND_SINK_HPP
+#define HEADER_SUPERTUX_AUDIO_SOUND_SINK_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+/** Receives the output of the SoftwareMixer, interleaved 16 bit
+    stereo samples */
+class SoundSink
+{
+public:
+  SoundSink() {}
+  virtual ~SoundSink() {}
+
+  virtual void write(const int16_t* samples, size_t frames) = 0;
+
+  /** Called for every sound started with SoundManager::play() and for
+      every music change, with the output frame it starts at */
+  virtual void write_event(uint64_t /*frame*/, const std::string& /*filename*/) {}
+
+private:
+  SoundSink(const SoundSink&) = delete;
+  SoundSink& operator=(const SoundSink&) = delete;
+};
+
+#endif
+
+/* EOF */
@@ -0,0 +1,217 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "audio/sound_voice_pool.hpp"
+
+#include "audio/sound_manager.hpp"
+#include "math/vector.hpp"
+#include "util/log.hpp"
+
+SoundVoicePool::SoundVoicePool(int size) :
+  m_voices(),
+  m_active(0),
+  m_serial(0),
+  m_frame(0),
+  m_played(0),
+  m_duplicates(0),
+  m_stolen(0),
+  m_rejected(0),
+  m_peak(0)
+{
+  m_voices.reserve(size);
+  for(int i = 0; i < size; ++i) {
+    Voice voice;
+    alGenSources(1, &voice.source);
+    if(alGetError() != AL_NO_ERROR) {
+      log_warning << "Couldn't create more than " << i << " sound effect voices" << std::endl;
+      break;
+    }
+    voice.active = false;
+    voice.priority = SOUND_PRIORITY_LOW;
+    voice.serial = 0;
+    voice.frame = 0;
+    m_voices.push_back(voice);
+  }
+}
+
+SoundVoicePool::~SoundVoicePool()
+{
+  for(auto& voice : m_voices) {
+    alSourceStop(voice.source);
+    alSourcei(voice.source, AL_BUFFER, AL_NONE);
+    alDeleteSources(1, &voice.source);
+  }
+}
+
+bool
+SoundVoicePool::play(ALuint buffer, const std::string& filename,
+                     SoundPriority priority, const Vector& pos)
+{
+  // a dozen coins collected in the same frame sound like one coin anyway
+  for(const auto& voice : m_voices) {
+    if(voice.active && voice.frame == m_frame && voice.filename == filename) {
+      m_duplicates += 1;
+      return false;
+    }
+  }
+
+  Voice* voice = find_voice(priority);
+  if(!voice) {
+    m_rejected += 1;
+    return false;
+  }
+
+  if(voice->active) {
+    m_stolen += 1;
+    alSourceStop(voice->source);
+    on_stopped(*voice);
+  }
+
+  ALuint source = voice->source;
+  alSourcei(source, AL_BUFFER, buffer);
+  alSourcei(source, AL_LOOPING, AL_FALSE);
+  alSourcef(source, AL_GAIN, 1.0f);
+  alSourcef(source, AL_PITCH, 1.0f);
+  alSourcef(source, AL_REFERENCE_DISTANCE, 128);
+  if(pos.x < 0 || pos.y < 0) {
+    alSourcei(source, AL_SOURCE_RELATIVE, AL_TRUE);
+    alSource3f(source, AL_POSITION, 0, 0, 0);
+  } else {
+    alSourcei(source, AL_SOURCE_RELATIVE, AL_FALSE);
+    alSource3f(source, AL_POSITION, pos.x, pos.y, 0);
+  }
+  alSourcePlay(source);
+
+  try {
+    SoundManager::check_al_error("Couldn't start sound effect voice: ");
+  } catch(const std::exception& e) {
+    log_warning << e.what() << std::endl;
+    alSourcei(source, AL_BUFFER, AL_NONE);
+    return false;
+  }
+
+  voice->active = true;
+  voice->filename = filename;
+  voice->priority = priority;
+  voice->serial = m_serial++;
+  voice->frame = m_frame;
+
+  m_active += 1;
+  m_played += 1;
+  if(m_active > m_peak) {
+    m_peak = m_active;
+  }
+  return true;
+}
+
+SoundVoicePool::Voice*
+SoundVoicePool::find_voice(SoundPriority priority)
+{
+  Voice* victim = NULL;
+  for(auto& voice : m_voices) {
+    if(!voice.active)
+      return &voice;
+
+    if(voice.priority > priority)
+      continue;
+
+    if(!victim || voice.priority < victim->priority ||
+       (voice.priority == victim->priority && voice.serial < victim->serial)) {
+      victim = &voice;
+    }
+  }
+  return victim;
+}
+
+void
+SoundVoicePool::update()
+{
+  m_frame += 1;
+
+  if(m_active == 0)
+    return;
+
+  for(auto& voice : m_voices) {
+    if(!voice.active)
+      continue;
+
+    ALint state;
+    alGetSourcei(voice.source, AL_SOURCE_STATE, &state);
+    if(state == AL_STOPPED || state == AL_INITIAL) {
+      on_stopped(voice);
+    }
+  }
+}
+
+void
+SoundVoicePool::on_stopped(Voice& voice)
+{
+  // detach the buffer, so that the buffer cache may evict it
+  alSourcei(voice.source, AL_BUFFER, AL_NONE);
+  voice.active = false;
+  voice.filename.clear();
+  m_active -= 1;
+}
+
+void
+SoundVoicePool::pause()
+{
+  for(auto& voice : m_voices) {
+    if(voice.active) {
+      alSourcePause(voice.source);
+    }
+  }
+}
+
+void
+SoundVoicePool::resume()
+{
+  for(auto& voice : m_voices) {
+    if(!voice.active)
+      continue;
+
+    ALint state;
+    alGetSourcei(voice.source, AL_SOURCE_STATE, &state);
+    if(state == AL_PAUSED) {
+      alSourcePlay(voice.source);
+    }
+  }
+}
+
+void
+SoundVoicePool::stop()
+{
+  for(auto& voice : m_voices) {
+    if(voice.active) {
+      alSourceStop(voice.source);
+      on_stopped(voice);
+    }
+  }
+}
+
+void
+SoundVoicePool::print_stats(std::ostream& out) const
+{
+  out << "Voices: " << m_active << " of " << m_voices.size() << " playing"
+      << " (peak " << m_peak << ")" << std::endl;
+  out << "Played: " << m_played
+      << ", same frame duplicates: " << m_duplicates
+      << ", taken over: " << m_stolen
+      << ", rejected: " << m_rejected << std::endl;
+}
+
+/* EOF */
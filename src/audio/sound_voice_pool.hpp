@@ -0,0 +1,97 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HEADER_SUPERTUX_AUDIO_SOUND_VOICE_POOL_HPP
+#define HEADER_SUPERTUX_AUDIO_SOUND_VOICE_POOL_HPP
+
+#include <al.h>
+
+#include <ostream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "audio/sound_priority.hpp"
+
+class Vector;
+
+/** A fixed set of OpenAL sources shared by all fire-and-forget sound
+    effects, so that a burst of sounds can't exhaust the voices of the
+    device. A voice is handed back to the pool by its stop handler
+    once OpenAL reports that it finished playing. */
+class SoundVoicePool
+{
+public:
+  SoundVoicePool(int size);
+  ~SoundVoicePool();
+
+  /** Plays @c buffer on a free voice, taking over the oldest voice of
+      the lowest priority if none is free. Returns false if the sound
+      was dropped, either because the same sound already started this
+      frame or because all voices play more important sounds. A
+      negative @c pos plays the sound relative to the listener. */
+  bool play(ALuint buffer, const std::string& filename,
+            SoundPriority priority, const Vector& pos);
+
+  /** Releases the voices that finished playing, call once a frame */
+  void update();
+
+  void pause();
+  void resume();
+  void stop();
+
+  int get_size() const { return static_cast<int>(m_voices.size()); }
+  int get_active() const { return m_active; }
+
+  void print_stats(std::ostream& out) const;
+
+private:
+  struct Voice
+  {
+    ALuint source;
+    bool active;
+    std::string filename;
+    SoundPriority priority;
+    /** m_serial at the time the voice was started, lower is older */
+    uint64_t serial;
+    /** m_frame at the time the voice was started */
+    uint64_t frame;
+  };
+
+  Voice* find_voice(SoundPriority priority);
+  void on_stopped(Voice& voice);
+
+private:
+  std::vector<Voice> m_voices;
+  int m_active;
+  uint64_t m_serial;
+  uint64_t m_frame;
+
+  int m_played;
+  int m_duplicates;
+  int m_stolen;
+  int m_rejected;
+  int m_peak;
+
+private:
+  SoundVoicePool(const SoundVoicePool&) = delete;
+  SoundVoicePool& operator=(const SoundVoicePool&) = delete;
+};
+
+#endif
+
+/* EOF */
@@ -20,11 +20,15 @@
 #include "supertux/timer.hpp"
 #include "util/log.hpp"
 
-StreamSoundSource::StreamSoundSource() :
+StreamSoundSource::Stream::Stream(ALuint source_) :
+  source(source_),
+  buffers(),
+  mutex(),
   file(),
-  fade_state(NoFading),
-  fade_start_time(),
-  fade_time(),
+  unused_buffers(STREAMFRAGMENTS),
+  generation(0),
+  closed(false),
+  play_requested(false),
   looping(false)
 {
   alGenBuffers(STREAMFRAGMENTS, buffers);
@@ -36,16 +40,13 @@ StreamSoundSource::StreamSoundSource() :
   {
     log_warning << e.what() << std::endl;
   }
-  //add me to update list
-  SoundManager::current()->register_for_update( this );
 }
 
-StreamSoundSource::~StreamSoundSource()
+StreamSoundSource::Stream::~Stream()
 {
-  //don't update me any longer
-  SoundManager::current()->remove_from_update( this );
-  file.reset();
-  stop();
+  alSourceRewindv(1, &source);
+  alSourcei(source, AL_BUFFER, AL_NONE);
+  alDeleteSources(1, &source);
   alDeleteBuffers(STREAMFRAGMENTS, buffers);
   try
   {
@@ -59,48 +60,227 @@ StreamSoundSource::~StreamSoundSource()
 }
 
 void
-StreamSoundSource::set_sound_file(std::unique_ptr<SoundFile> newfile)
-{
-  file = std::move(newfile);
-
-  ALint queued;
-  alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
-  for(size_t i = 0; i < STREAMFRAGMENTS - queued; ++i) {
-    if(fillBufferAndQueue(buffers[i]) == false)
-      break;
-  }
-}
-
-void
-StreamSoundSource::update()
+StreamSoundSource::Stream::refill(char* decode_buffer)
 {
+  ALuint fill[STREAMFRAGMENTS];
+  size_t fill_count = 0;
   ALint processed = 0;
-  alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
-  for(ALint i = 0; i < processed; ++i) {
-    ALuint buffer;
-    alSourceUnqueueBuffers(source, 1, &buffer);
+  uint64_t fill_generation;
+  std::unique_ptr<SoundFile> decoding;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if(closed || !file)
+      return;
+
     try
     {
-      SoundManager::check_al_error("Couldn't unqueue audio buffer: ");
+      while(unused_buffers > 0) {
+        fill[fill_count++] = buffers[STREAMFRAGMENTS - unused_buffers];
+        unused_buffers -= 1;
+      }
+
+      alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
+      for(ALint i = 0; i < processed && fill_count < STREAMFRAGMENTS; ++i) {
+        ALuint buffer;
+        alSourceUnqueueBuffers(source, 1, &buffer);
+        SoundManager::check_al_error("Couldn't unqueue audio buffer: ");
+        fill[fill_count++] = buffer;
+      }
     }
     catch(std::exception& e)
     {
       log_warning << e.what() << std::endl;
     }
 
-    if(fillBufferAndQueue(buffer) == false)
-      break;
+    fill_generation = generation;
+    if(fill_count > 0)
+      decoding = std::move(file);
   }
 
-  if(!playing()) {
-    if(processed == 0 || !looping)
-      return;
+  if(decoding) {
+    ALenum format = SoundManager::get_sample_format(*decoding);
+    for(size_t i = 0; i < fill_count; ++i) {
+      size_t bytesread = decode(*decoding, decode_buffer);
+
+      std::lock_guard<std::mutex> lock(mutex);
+      // after a stop() all buffers count as unused again
+      if(closed || generation != fill_generation)
+        break;
 
-    // we might have to restart the source if we had a buffer underrun
-    log_info << "Restarting audio source because of buffer underrun" << std::endl;
-    play();
+      if(bytesread > 0) {
+        try
+        {
+          alBufferData(fill[i], format, decode_buffer, bytesread, decoding->rate);
+          SoundManager::check_al_error("Couldn't refill audio buffer: ");
+
+          alSourceQueueBuffers(source, 1, &fill[i]);
+          SoundManager::check_al_error("Couldn't queue audio buffer: ");
+        }
+        catch(std::exception& e)
+        {
+          log_warning << e.what() << std::endl;
+        }
+      }
+
+      // the remaining buffers drop out until the next stop()
+      if(bytesread < STREAMFRAGMENTSIZE)
+        break;
+    }
   }
 
+  std::lock_guard<std::mutex> lock(mutex);
+  // set_sound_file() might have replaced the file meanwhile
+  if(decoding && !file)
+    file = std::move(decoding);
+  if(closed)
+    return;
+
+  try
+  {
+    ALint state = AL_PLAYING;
+    alGetSourcei(source, AL_SOURCE_STATE, &state);
+    if(play_requested) {
+      ALint queued = 0;
+      alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
+      if(queued > 0) {
+        play_requested = false;
+        alSourcePlay(source);
+        SoundManager::check_al_error("Couldn't start audio source: ");
+      }
+    } else if(state != AL_PLAYING && processed > 0 && looping) {
+      // we might have to restart the source if we had a buffer underrun
+      log_info << "Restarting audio source because of buffer underrun" << std::endl;
+      alSourcePlay(source);
+      SoundManager::check_al_error("Couldn't start audio source: ");
+    }
+  }
+  catch(std::exception& e)
+  {
+    log_warning << e.what() << std::endl;
+  }
+}
+
+size_t
+StreamSoundSource::Stream::decode(SoundFile& sound_file, char* decode_buffer)
+{
+  size_t bytesread = 0;
+  bool rewound = false;
+  try
+  {
+    do {
+      size_t count = sound_file.read(decode_buffer + bytesread,
+                                     STREAMFRAGMENTSIZE - bytesread);
+      bytesread += count;
+      // end of sound file, give up if it stays empty after rewinding
+      if(bytesread < STREAMFRAGMENTSIZE) {
+        if(looping && !(rewound && count == 0)) {
+          sound_file.reset();
+          rewound = true;
+        } else {
+          break;
+        }
+      }
+    } while(bytesread < STREAMFRAGMENTSIZE);
+  }
+  catch(std::exception& e)
+  {
+    log_warning << e.what() << std::endl;
+  }
+  return bytesread;
+}
+
+StreamSoundSource::StreamSoundSource() :
+  m_stream(),
+  fade_state(NoFading),
+  fade_start_time(),
+  fade_time()
+{
+  m_stream = std::make_shared<Stream>(source);
+  //add me to the stream thread
+  SoundManager::current()->register_for_update( this );
+}
+
+StreamSoundSource::~StreamSoundSource()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_stream->mutex);
+    m_stream->closed = true;
+    m_stream->play_requested = false;
+    OpenALSoundSource::stop();
+  }
+
+  // doesn't wait for the stream thread, the last one to let go of the
+  // stream deletes the OpenAL source and buffers
+  SoundManager::current()->remove_from_update( this );
+  m_stream.reset();
+  source = 0;
+}
+
+void
+StreamSoundSource::set_sound_file(std::unique_ptr<SoundFile> newfile)
+{
+  // a new file starts over with all buffers, the stream thread queues
+  // the first ones on its next refill()
+  std::lock_guard<std::mutex> lock(m_stream->mutex);
+  bool was_playing = m_stream->play_requested || OpenALSoundSource::playing();
+  OpenALSoundSource::stop();
+  m_stream->unused_buffers = STREAMFRAGMENTS;
+  m_stream->generation += 1;
+  m_stream->file = std::move(newfile);
+  m_stream->play_requested = was_playing;
+}
+
+void
+StreamSoundSource::play()
+{
+  std::lock_guard<std::mutex> lock(m_stream->mutex);
+  ALint queued = 0;
+  alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
+  if(queued > 0) {
+    m_stream->play_requested = false;
+    OpenALSoundSource::play();
+  } else {
+    m_stream->play_requested = true;
+  }
+}
+
+void
+StreamSoundSource::stop()
+{
+  std::lock_guard<std::mutex> lock(m_stream->mutex);
+  m_stream->play_requested = false;
+  OpenALSoundSource::stop();
+  // stopping detaches all buffers from the source
+  m_stream->unused_buffers = STREAMFRAGMENTS;
+  m_stream->generation += 1;
+}
+
+void
+StreamSoundSource::pause()
+{
+  std::lock_guard<std::mutex> lock(m_stream->mutex);
+  m_stream->play_requested = false;
+  OpenALSoundSource::pause();
+}
+
+bool
+StreamSoundSource::playing() const
+{
+  return m_stream->play_requested || OpenALSoundSource::playing();
+}
+
+bool
+StreamSoundSource::started() const
+{
+  return !m_stream->play_requested && OpenALSoundSource::playing();
+}
+
+void
+StreamSoundSource::update()
+{
+  if(!playing())
+    return;
+
   if(fade_state == FadingOn || fade_state == FadingResume) {
     float time = real_time - fade_start_time;
     if(time >= fade_time) {
@@ -131,42 +311,4 @@ StreamSoundSource::set_fading(FadeState state, float fade_time_)
   this->fade_start_time = real_time;
 }
 
-bool
-StreamSoundSource::fillBufferAndQueue(ALuint buffer)
-{
-  // fill buffer
-  std::unique_ptr<char[]> bufferdata(new char[STREAMFRAGMENTSIZE]);
-  size_t bytesread = 0;
-  do {
-    bytesread += file->read(bufferdata.get() + bytesread,
-                            STREAMFRAGMENTSIZE - bytesread);
-    // end of sound file
-    if(bytesread < STREAMFRAGMENTSIZE) {
-      if(looping)
-        file->reset();
-      else
-        break;
-    }
-  } while(bytesread < STREAMFRAGMENTSIZE);
-
-  if(bytesread > 0) {
-    ALenum format = SoundManager::get_sample_format(*file);
-    try
-    {
-      alBufferData(buffer, format, bufferdata.get(), bytesread, file->rate);
-      SoundManager::check_al_error("Couldn't refill audio buffer: ");
-
-      alSourceQueueBuffers(source, 1, &buffer);
-      SoundManager::check_al_error("Couldn't queue audio buffer: ");
-    }
-    catch(std::exception& e)
-    {
-      log_warning << e.what() << std::endl;
-    }
-  }
-
-  // return false if there aren't more buffers to fill
-  return bytesread >= STREAMFRAGMENTSIZE;
-}
-
 /* EOF */
@@ -17,12 +17,68 @@
 #ifndef HEADER_SUPERTUX_AUDIO_STREAM_SOUND_SOURCE_HPP
 #define HEADER_SUPERTUX_AUDIO_STREAM_SOUND_SOURCE_HPP
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+
 #include "audio/openal_sound_source.hpp"
 
 class SoundFile;
 
+/** A source that plays a sound file in small fragments. Decoding and
+    queueing happen on the AudioStreamThread, see Stream::refill(),
+    everything else is called from the main thread. */
 class StreamSoundSource : public OpenALSoundSource
 {
+public:
+  static const size_t STREAMBUFFERSIZE = 1024 * 500;
+  static const size_t STREAMFRAGMENTS = 5;
+  static const size_t STREAMFRAGMENTSIZE
+  = STREAMBUFFERSIZE / STREAMFRAGMENTS;
+
+  /** Everything the stream thread touches. The thread keeps it alive
+      until it has let go of it, so destroying a StreamSoundSource never
+      waits for a refill. Its destructor deletes the OpenAL source and
+      buffers on whichever thread drops it last. */
+  class Stream
+  {
+  public:
+    Stream(ALuint source);
+    ~Stream();
+
+    /** Decodes into @c decode_buffer (STREAMFRAGMENTSIZE bytes) and
+        queues buffers that OpenAL has finished playing, called from
+        the AudioStreamThread. Decoding happens without holding the
+        mutex, it is only taken to queue the decoded buffers. */
+    void refill(char* decode_buffer);
+
+    /** Decodes the next fragment of @c file, returns the size */
+    size_t decode(SoundFile& file, char* decode_buffer);
+
+    const ALuint source;
+    ALuint buffers[STREAMFRAGMENTS];
+
+    /** guards file, unused_buffers, generation and the buffer queue */
+    std::mutex mutex;
+    /** null while the stream thread decodes from it */
+    std::unique_ptr<SoundFile> file;
+    /** number of buffers that were never queued yet */
+    size_t unused_buffers;
+    /** changes whenever the queue is reset, so that buffers decoded
+        meanwhile are not queued */
+    uint64_t generation;
+    /** set when the StreamSoundSource is gone */
+    bool closed;
+
+    std::atomic<bool> play_requested;
+    std::atomic<bool> looping;
+
+  private:
+    Stream(const Stream&) = delete;
+    Stream& operator=(const Stream&) = delete;
+  };
+
 public:
   StreamSoundSource();
   virtual ~StreamSoundSource();
@@ -36,31 +92,36 @@ public:
   {
     return fade_state;
   }
+
+  /** Updates the fading, called from the main thread */
   void update();
 
+  const std::shared_ptr<Stream>& get_stream() const { return m_stream; }
+
+  /** Playback starts once the stream thread has queued the first
+      buffers, playing() is true from this call on */
+  virtual void play();
+  virtual void stop();
+  virtual void pause();
+  virtual bool playing() const;
+  /** true once the first buffers are queued and OpenAL plays them */
+  bool started() const;
+
   void set_looping(bool looping_)
   {
-    this->looping = looping_;
+    m_stream->looping = looping_;
   }
   bool get_looping() const
   {
-    return looping;
+    return m_stream->looping;
   }
 
 private:
-  static const size_t STREAMBUFFERSIZE = 1024 * 500;
-  static const size_t STREAMFRAGMENTS = 5;
-  static const size_t STREAMFRAGMENTSIZE
-  = STREAMBUFFERSIZE / STREAMFRAGMENTS;
-
-  bool fillBufferAndQueue(ALuint buffer);
-  std::unique_ptr<SoundFile> file;
-  ALuint buffers[STREAMFRAGMENTS];
+  std::shared_ptr<Stream> m_stream;
 
   FadeState fade_state;
   float fade_start_time;
   float fade_time;
-  bool looping;
 
 private:
   StreamSoundSource(const StreamSoundSource&);
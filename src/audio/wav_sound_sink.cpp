@@ -0,0 +1,126 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "audio/wav_sound_sink.hpp"
+
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "util/log.hpp"
+
+namespace {
+
+void write32(std::ostream& out, uint32_t value)
+{
+  char bytes[4] = {
+    static_cast<char>(value & 0xff),
+    static_cast<char>((value >> 8) & 0xff),
+    static_cast<char>((value >> 16) & 0xff),
+    static_cast<char>((value >> 24) & 0xff)
+  };
+  out.write(bytes, 4);
+}
+
+void write16(std::ostream& out, uint16_t value)
+{
+  char bytes[2] = {
+    static_cast<char>(value & 0xff),
+    static_cast<char>((value >> 8) & 0xff)
+  };
+  out.write(bytes, 2);
+}
+
+} // namespace
+
+WavSoundSink::WavSoundSink(const std::string& filename, int rate) :
+  m_filename(filename),
+  m_out(filename.c_str(), std::ios::binary),
+  m_events(),
+  m_rate(rate),
+  m_data_bytes(0)
+{
+  if(!m_out.good()) {
+    std::stringstream msg;
+    msg << "Couldn't open sound file '" << filename << "' for writing.";
+    throw std::runtime_error(msg.str());
+  }
+  write_header();
+}
+
+WavSoundSink::~WavSoundSink()
+{
+  m_out.seekp(0);
+  write_header();
+  m_out.close();
+  if(m_out.fail()) {
+    log_warning << "Error while writing sound file '" << m_filename << "'" << std::endl;
+  }
+}
+
+void
+WavSoundSink::write_header()
+{
+  const uint16_t channels = 2;
+  const uint16_t bits_per_sample = 16;
+  const uint16_t block_align = channels * bits_per_sample / 8;
+
+  m_out.write("RIFF", 4);
+  write32(m_out, 36 + m_data_bytes);
+  m_out.write("WAVE", 4);
+
+  m_out.write("fmt ", 4);
+  write32(m_out, 16);
+  write16(m_out, 1); // PCM
+  write16(m_out, channels);
+  write32(m_out, m_rate);
+  write32(m_out, m_rate * block_align);
+  write16(m_out, block_align);
+  write16(m_out, bits_per_sample);
+
+  m_out.write("data", 4);
+  write32(m_out, m_data_bytes);
+}
+
+void
+WavSoundSink::write(const int16_t* samples, size_t frames)
+{
+  // WAV is little endian regardless of the host
+  std::vector<char> bytes(frames * 4);
+  for(size_t i = 0; i < frames * 2; ++i) {
+    uint16_t value = static_cast<uint16_t>(samples[i]);
+    bytes[i * 2] = static_cast<char>(value & 0xff);
+    bytes[i * 2 + 1] = static_cast<char>(value >> 8);
+  }
+  m_out.write(bytes.data(), bytes.size());
+  m_data_bytes += static_cast<uint32_t>(frames * 4);
+}
+
+void
+WavSoundSink::write_event(uint64_t frame, const std::string& filename)
+{
+  if(!m_events.is_open()) {
+    std::string events_filename = m_filename + ".events";
+    m_events.open(events_filename.c_str());
+    if(!m_events.good()) {
+      log_warning << "Couldn't open '" << events_filename << "' for writing" << std::endl;
+    }
+  }
+  m_events << frame << ' ' << filename << '\n';
+}
+
+/* EOF */
@@ -0,0 +1,57 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HEADER_SUPERTUX_AUDIO_WAV_SOUND_SINK_HPP
+#define HEADER_SUPERTUX_AUDIO_WAV_SOUND_SINK_HPP
+
+#include <fstream>
+#include <string>
+
+#include "audio/sound_sink.hpp"
+
+/** Writes the mixed samples into a 16 bit stereo WAV file, the sizes in
+    the header are filled in when the sink is destroyed. The sounds that
+    were started go to FILENAME.events, one "FRAME SOUNDFILE" per line. */
+class WavSoundSink : public SoundSink
+{
+public:
+  /** @param filename  native path of the file to write */
+  WavSoundSink(const std::string& filename, int rate);
+  virtual ~WavSoundSink();
+
+  virtual void write(const int16_t* samples, size_t frames) override;
+  virtual void write_event(uint64_t frame, const std::string& filename) override;
+
+private:
+  void write_header();
+
+private:
+  std::string m_filename;
+  std::ofstream m_out;
+  /** opened on the first event */
+  std::ofstream m_events;
+  int m_rate;
+  uint32_t m_data_bytes;
+
+private:
+  WavSoundSink(const WavSoundSink&) = delete;
+  WavSoundSink& operator=(const WavSoundSink&) = delete;
+};
+
+#endif
+
+/* EOF */
@@ -24,6 +24,8 @@ class AngryStone : public BadGuy
 public:
   AngryStone(const ReaderMapping& reader);
 
+  static bool counted_by_default() { return false; }
+
   void collision_solid(const CollisionHit& hit);
   HitResponse collision_badguy(BadGuy& badguy, const CollisionHit& hit);
   void active_update(float elapsed_time);
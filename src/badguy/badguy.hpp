@@ -257,6 +257,12 @@ public:
       changed during runtime. */
   bool countMe;
 
+  /** Initial value of countMe for objects created from a level file.
+      Subclasses whose constructor clears countMe hide this with a
+      version returning false, so ObjectFactory::is_counted_badguy()
+      can answer without creating the object. */
+  static bool counted_by_default() { return true; }
+
 protected:
   /** true if initialize() has already been called */
   bool is_initialized;
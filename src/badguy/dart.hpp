@@ -30,6 +30,8 @@ public:
   Dart(const ReaderMapping& reader);
   Dart(const Vector& pos, Direction d, const BadGuy* parent);
 
+  static bool counted_by_default() { return false; }
+
   void initialize();
   void activate();
   void deactivate();
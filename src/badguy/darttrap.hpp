@@ -25,6 +25,8 @@ class DartTrap : public BadGuy
 public:
   DartTrap(const ReaderMapping& reader);
 
+  static bool counted_by_default() { return false; }
+
   void initialize();
   void activate();
   void active_update(float elapsed_time);
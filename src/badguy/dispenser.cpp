@@ -153,7 +153,7 @@ Dispenser::collision_squished(GameObject& object)
   if (player){
     player->bounce(*this);
   }
-  SoundManager::current()->play("sounds/squish.wav", get_pos());
+  SoundManager::current()->play("sounds/squish.wav", get_pos(), SOUND_PRIORITY_LOW);
   broken = true;
   return true;
 }
@@ -24,6 +24,8 @@ class Dispenser : public BadGuy
 public:
   Dispenser(const ReaderMapping& reader);
 
+  static bool counted_by_default() { return false; }
+
   void draw(DrawingContext& context);
   void activate();
   void deactivate();
@@ -26,6 +26,8 @@ class Flame : public BadGuy
 public:
   Flame(const ReaderMapping& reader);
 
+  static bool counted_by_default() { return false; }
+
   void activate();
   void deactivate();
 
@@ -24,6 +24,8 @@ class Kugelblitz : public BadGuy
 public:
   Kugelblitz(const ReaderMapping& reader);
 
+  static bool counted_by_default() { return false; }
+
   void initialize();
   HitResponse collision_badguy(BadGuy& other, const CollisionHit& hit);
   void collision_solid(const CollisionHit& hit);
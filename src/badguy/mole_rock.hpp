@@ -28,6 +28,8 @@ public:
   MoleRock(const ReaderMapping& reader);
   MoleRock(const Vector& pos, const Vector& velocity, const BadGuy* parent);
 
+  static bool counted_by_default() { return false; }
+
   void initialize();
   void deactivate();
 
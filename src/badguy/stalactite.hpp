@@ -24,6 +24,8 @@ class Stalactite : public BadGuy
 public:
   Stalactite(const ReaderMapping& reader);
 
+  static bool counted_by_default() { return false; }
+
   void active_update(float elapsed_time);
   void collision_solid(const CollisionHit& hit);
   HitResponse collision_player(Player& player, const CollisionHit& hit);
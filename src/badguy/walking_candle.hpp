@@ -26,6 +26,8 @@ class WalkingCandle : public WalkingBadguy
 public:
   WalkingCandle(const ReaderMapping& reader);
 
+  static bool counted_by_default() { return false; }
+
   bool is_freezable() const;
   bool is_flammable() const;
 
@@ -35,6 +35,8 @@ public:
   WillOWisp(const ReaderMapping& reader);
   virtual void save(Writer& writer);
 
+  static bool counted_by_default() { return false; }
+
   void activate();
   void deactivate();
 
@@ -16,12 +16,11 @@
 
 #include "gui/menu_filesystem.hpp"
 
-#include <physfs.h>
-
 #include "addon/addon_manager.hpp"
 #include "gui/menu_item.hpp"
 #include "gui/menu_manager.hpp"
 #include "gui/item_action.hpp"
+#include "physfs/physfs_directory_index.hpp"
 #include "physfs/physfs_file_system.hpp"
 #include "util/file_system.hpp"
 #include "util/gettext.hpp"
@@ -37,7 +36,11 @@ FileSystemMenu::FileSystemMenu(std::string* filename_, const std::vector<std::st
 {
   AddonManager::current()->unmount_old_addons();
 
-  if (!PHYSFS_exists(directory.c_str())) {
+  // show files that were added outside of the game since the
+  // directory index was filled
+  PhysFSDirectoryIndex::invalidate();
+
+  if (!PhysFSFileSystem::exists(directory)) {
     directory = "/"; //The filename is probably included in an old add-on.
   }
 
@@ -67,29 +70,24 @@ FileSystemMenu::refresh_items()
     directories.push_back("..");
   }
 
-  char** dir_files = PHYSFS_enumerateFiles(directory.c_str());
-  if (dir_files)
+  for(const auto& file : PhysFSDirectoryIndex::enumerate(directory))
   {
-    for(const char* const* file = dir_files; *file != 0; ++file)
+    std::string filepath = FileSystem::join(directory, file);
+    if(PhysFSFileSystem::is_directory(filepath))
     {
-      std::string filepath = FileSystem::join(directory, *file);
-      if(PhysFSFileSystem::is_directory(filepath))
-      {
-        directories.push_back(*file);
+      directories.push_back(file);
+    }
+    else
+    {
+      if (AddonManager::current()->is_from_old_addon(filepath)) {
+        continue;
       }
-      else
+
+      if(has_right_suffix(file))
       {
-        if (AddonManager::current()->is_from_old_addon(filepath)) {
-          continue;
-        }
-
-        if(has_right_suffix(*file))
-        {
-          files.push_back(*file);
-        }
+        files.push_back(file);
       }
     }
-    PHYSFS_freeList(dir_files);
   }
 
   for(const auto& item : directories)
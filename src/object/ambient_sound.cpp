@@ -14,6 +14,7 @@
 //  You should have received a copy of the GNU General Public License
 //  along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <algorithm>
 #include <limits>
 #include <math.h>
 
@@ -21,24 +22,29 @@
 #include "audio/sound_source.hpp"
 #include "editor/editor.hpp"
 #include "object/ambient_sound.hpp"
-#include "object/camera.hpp"
 #include "scripting/squirrel_util.hpp"
 #include "supertux/object_factory.hpp"
-#include "supertux/sector.hpp"
 #include "util/reader_mapping.hpp"
 #include "video/drawing_context.hpp"
 
+namespace {
+
+/** gain changes smaller than this are not passed on to OpenAL */
+const float GAIN_THRESHOLD = 0.01f;
+
+} // namespace
+
 AmbientSound::AmbientSound(const ReaderMapping& lisp) :
   ExposedObject<AmbientSound, scripting::AmbientSound>(this),
   sample(),
   sound_source(),
-  latency(),
   distance_factor(),
   distance_bias(),
   silence_distance(),
   maximumvolume(),
   targetvolume(),
   currentvolume(0),
+  m_applied_gain(0),
   volume_ptr(),
   new_size()
 {
@@ -75,20 +81,19 @@ AmbientSound::AmbientSound(const ReaderMapping& lisp) :
 
   sound_source.reset(); // not playing at the beginning
   SoundManager::current()->preload(sample);
-  latency=0;
 }
 
 AmbientSound::AmbientSound(const Vector& pos, float factor, float bias, float vol, const std::string& file) :
   ExposedObject<AmbientSound, scripting::AmbientSound>(this),
   sample(file),
   sound_source(),
-  latency(0),
   distance_factor(factor * factor),
   distance_bias(bias * bias),
   silence_distance(),
   maximumvolume(vol),
   targetvolume(),
   currentvolume(),
+  m_applied_gain(0),
   volume_ptr(),
   new_size()
 {
@@ -160,6 +165,7 @@ AmbientSound::start_playing()
     sound_source->set_gain(0);
     sound_source->set_looping(true);
     currentvolume=targetvolume=1e-20f;
+    m_applied_gain=0;
     sound_source->play();
   } catch(std::exception& e) {
     log_warning << "Couldn't play '" << sample << "': " << e.what() << "" << std::endl;
@@ -168,63 +174,44 @@ AmbientSound::start_playing()
   }
 }
 
+float
+AmbientSound::get_square_distance(const Vector& listener) const
+{
+  // Relate to which point in the area
+  float rx = std::max(bbox.p1.x, std::min(listener.x, bbox.p2.x));
+  float ry = std::max(bbox.p1.y, std::min(listener.y, bbox.p2.y));
+
+  // inside the bias: full volume (distance 0)
+  float sqrdistance = (listener.x - rx) * (listener.x - rx) + (listener.y - ry) * (listener.y - ry);
+  return std::max(0.0f, sqrdistance - distance_bias);
+}
+
 void
-AmbientSound::update(float deltat)
+AmbientSound::update_volume(float sqrdistance)
 {
-  if (latency-- <= 0) {
-    float px,py;
-    float rx,ry;
-
-    if (!Sector::current() || !Sector::current()->camera) return;
-    // Camera position
-    px=Sector::current()->camera->get_center().x;
-    py=Sector::current()->camera->get_center().y;
-
-    // Relate to which point in the area
-    rx=px<bbox.p1.x?bbox.p1.x:
-      (px<bbox.p2.x?px:bbox.p2.x);
-    ry=py<bbox.p1.y?bbox.p1.y:
-      (py<bbox.p2.y?py:bbox.p2.y);
-
-    // calculate square of distance
-    float sqrdistance=(px-rx)*(px-rx)+(py-ry)*(py-ry);
-    sqrdistance-=distance_bias;
-
-    // inside the bias: full volume (distance 0)
-    if (sqrdistance<0)
-      sqrdistance=0;
-
-    // calculate target volume - will never become 0
-    targetvolume=1/(1+sqrdistance*distance_factor);
-    float rise=targetvolume/currentvolume;
-
-    // rise/fall half life?
-    currentvolume*=pow(rise,deltat*10);
-    currentvolume += 1e-6f; // volume is at least 1e-6 (0 would never rise)
-
-    if (sound_source != 0) {
-
-      // set the volume
-      sound_source->set_gain(currentvolume*maximumvolume);
-
-      if (sqrdistance>=silence_distance && currentvolume<1e-3)
-        stop_playing();
-      latency=0;
-    } else {
-      if (sqrdistance<silence_distance) {
-        start_playing();
-        latency=0;
-      }
-      else // set a reasonable latency
-        latency=(int)(0.001/distance_factor);
-      //(int)(10*((sqrdistance-silence_distance)/silence_distance));
-    }
+  if (!sound_source) {
+    start_playing();
+    if (!sound_source)
+      return;
   }
 
-  // heuristically measured "good" latency maximum
+  // calculate target volume - will never become 0
+  targetvolume=1/(1+sqrdistance*distance_factor);
+
+  // the volume moves halfway towards the target on a logarithmic
+  // scale, at a fixed rate that is the same as pow(rise, deltat*10)
+  currentvolume*=sqrtf(targetvolume/currentvolume);
+  currentvolume += 1e-6f; // volume is at least 1e-6 (0 would never rise)
+
+  // small steps aren't audible, skip the OpenAL call
+  float gain = currentvolume*maximumvolume;
+  if (fabsf(gain - m_applied_gain) >= GAIN_THRESHOLD) {
+    sound_source->set_gain(gain);
+    m_applied_gain = gain;
+  }
 
-  //  if (latency>0.001/distance_factor)
-  // latency=
+  if (sqrdistance>=silence_distance && currentvolume<1e-3)
+    stop_playing();
 }
 
 #ifndef SCRIPTING_API
@@ -33,6 +33,8 @@
  *    silence_distance   defaults reasonably.
  *    sample             sample to be played back in loop mode
  *
+ *  - the volume is updated by the sector's AmbientSoundManager
+ *
  *      basti_
  */
 
@@ -87,6 +89,16 @@ public:
 
   void draw(DrawingContext& context);
 
+  /** square of the distance from @c listener to the full volume area,
+      minus the square of distance_bias */
+  float get_square_distance(const Vector& listener) const;
+  float get_silence_distance() const { return silence_distance; }
+  bool is_playing() const { return static_cast<bool>(sound_source); }
+
+  /** Moves the volume towards the one at @c sqrdistance, called by the
+      AmbientSoundManager every AmbientSoundManager::UPDATE_INTERVAL */
+  void update_volume(float sqrdistance);
+
   std::string get_display_name() const {
     return _("Ambient sound");
   }
@@ -95,7 +107,7 @@ public:
 
 protected:
   virtual void hit(Player& player);
-  virtual void update(float time);
+  virtual void update(float ) {}
   virtual void start_playing();
   virtual void stop_playing();
 
@@ -103,7 +115,6 @@ private:
 
   std::string sample;
   std::unique_ptr<SoundSource> sound_source;
-  int latency;
 
   float distance_factor;  /// distance scaling
   float distance_bias;    /// 100% volume disc radius
@@ -112,6 +123,7 @@ private:
   float maximumvolume; /// maximum volume
   float targetvolume;  /// how loud we want to be
   float currentvolume; /// how loud we are
+  float m_applied_gain; /// the gain the sound source was last set to
 
   float * volume_ptr; /// this will be used by the volume adjustment effect.
 
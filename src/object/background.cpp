@@ -214,7 +214,7 @@ void
 Background::set_image(const std::string& name_)
 {
   this->imagefile = name_;
-  image = Surface::create(name_);
+  image = Surface::create_async(name_);
   imagefile = name_;
 }
 
@@ -229,13 +229,13 @@ void
 Background::set_images(const std::string& name_top_, const std::string& name_middle_,
                        const std::string& name_bottom_)
 {
-  image_top = Surface::create(name_top_);
+  image_top = Surface::create_async(name_top_);
   imagefile_top = name_top_;
 
-  image = Surface::create(name_middle_);
+  image = Surface::create_async(name_middle_);
   imagefile = name_middle_;
 
-  image_bottom = Surface::create(name_bottom_);
+  image_bottom = Surface::create_async(name_bottom_);
   imagefile_bottom = name_bottom_;
 }
 
@@ -326,7 +326,11 @@ Background::draw(DrawingContext& context)
   if(Editor::is_active() && !EditorInputCenter::render_background)
     return;
 
-  if(image.get() == NULL)
+  // backgrounds are loaded in the background, skip them until ready
+  if(image.get() == NULL || image->is_pending())
+    return;
+  if((image_top.get() != NULL && image_top->is_pending()) ||
+     (image_bottom.get() != NULL && image_bottom->is_pending()))
     return;
 
   Sizef level_size(Sector::current()->get_width(),
@@ -40,6 +40,20 @@
 #include <stdexcept>
 #include <physfs.h>
 
+namespace {
+
+int total_coins(BonusBlock::Contents contents, int hit_counter)
+{
+  if (contents == BonusBlock::CONTENT_COIN)
+    return hit_counter;
+  else if (contents == BonusBlock::CONTENT_RAIN || contents == BonusBlock::CONTENT_EXPLODE)
+    return 10;
+  else
+    return 0;
+}
+
+} // namespace
+
 BonusBlock::BonusBlock(const Vector& pos, int data) :
   Block(SpriteManager::current()->create("images/objects/bonus_block/bonusblock.sprite")),
   contents(),
@@ -101,6 +115,44 @@ BonusBlock::BonusBlock(const ReaderMapping& lisp) :
   }
 }
 
+int
+BonusBlock::get_total_coins() const
+{
+  return total_coins(contents, hit_counter);
+}
+
+int
+BonusBlock::count_total_coins(const ReaderMapping& lisp)
+{
+  // mirrors BonusBlock(const ReaderMapping&) and get_content_by_data()
+  Contents contents = CONTENT_COIN;
+  int hit_counter = 1;
+  auto iter = lisp.get_iter();
+  while(iter.next()) {
+    const std::string& token = iter.get_key();
+    if(token == "count") {
+      iter.get(hit_counter);
+    } else if(token == "data") {
+      int d = 0;
+      iter.get(d);
+      if(d == 10)
+        contents = CONTENT_RAIN;
+      else if(d == 11)
+        contents = CONTENT_EXPLODE;
+      else if(d >= 2 && d <= 14)
+        contents = CONTENT_CUSTOM; // any content without coins
+      else
+        contents = CONTENT_COIN;
+    } else if(token == "contents") {
+      std::string contentstring;
+      iter.get(contentstring);
+      contents = get_content_from_string(contentstring);
+    }
+  }
+
+  return total_coins(contents, hit_counter);
+}
+
 void
 BonusBlock::get_content_by_data(int d)
 {
@@ -507,7 +559,7 @@ BonusBlock::draw(DrawingContext& context){
 }
 
 BonusBlock::Contents
-BonusBlock::get_content_from_string(const std::string& contentstring) const
+BonusBlock::get_content_from_string(const std::string& contentstring)
 {
   if(contentstring == "coin")
     return CONTENT_COIN;
@@ -55,6 +55,13 @@ public:
 
   virtual ObjectSettings get_settings();
 
+  /** Number of coins the block gives, counted in the level's total */
+  int get_total_coins() const;
+
+  /** Same as get_total_coins() for a block that would be read from
+      @c lisp, used to pre-scan levels without creating the block */
+  static int count_total_coins(const ReaderMapping& lisp);
+
 protected:
   virtual void hit(Player& player);
 
@@ -72,7 +79,7 @@ private:
   void get_content_by_data(int d);
   void raise_growup_bonus(Player* player, const BonusType& bonus, const Direction& dir);
   void drop_growup_bonus(const std::string& bonus_sprite_name, bool& countdown);
-  BonusBlock::Contents get_content_from_string(const std::string& contentstring) const;
+  static BonusBlock::Contents get_content_from_string(const std::string& contentstring);
   std::string contents_to_string(const BonusBlock::Contents& content) const;
 };
 
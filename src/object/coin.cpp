@@ -227,7 +227,7 @@ HeavyCoin::collision_solid(const CollisionHit& hit)
   //TODO: colliding HeavyCoins should have their own unique sound
   if(hit.bottom) {
     if(physic.get_velocity_y() > clink_threshold)
-      SoundManager::current()->play("sounds/coin2.ogg");
+      SoundManager::current()->play("sounds/coin2.ogg", Vector(-1, -1), SOUND_PRIORITY_LOW);
     if(physic.get_velocity_y() > 200) {// lets some coins bounce
       physic.set_velocity_y(-99);
     } else {
@@ -237,12 +237,12 @@ HeavyCoin::collision_solid(const CollisionHit& hit)
   }
   if(hit.right || hit.left) {
     if(physic.get_velocity_x() > clink_threshold || physic.get_velocity_x() < clink_threshold)
-      SoundManager::current()->play("sounds/coin2.ogg");
+      SoundManager::current()->play("sounds/coin2.ogg", Vector(-1, -1), SOUND_PRIORITY_LOW);
     physic.set_velocity_x(-physic.get_velocity_x());
   }
   if(hit.top) {
     if(physic.get_velocity_y() < clink_threshold)
-      SoundManager::current()->play("sounds/coin2.ogg");
+      SoundManager::current()->play("sounds/coin2.ogg", Vector(-1, -1), SOUND_PRIORITY_LOW);
     physic.set_velocity_y(-physic.get_velocity_y());
   }
 }
@@ -16,6 +16,8 @@
 
 #include "object/particlesystem_interactive.hpp"
 
+#include <math.h>
+
 #include "math/aatriangle.hpp"
 #include "math/vector.hpp"
 #include "object/tilemap.hpp"
@@ -77,26 +79,27 @@ ParticleSystem_Interactive::collision(Particle* object, const Vector& movement)
   }
   bool water = false;
 
-  // test with all tiles in this rectangle
-  int starttilex = int(x1-1) / 32;
-  int starttiley = int(y1-1) / 32;
-  int max_x = int(x2+1);
-  int max_y = int(y2+1);
-
   Rectf dest(x1, y1, x2, y2);
   dest.move(movement);
   Constraints constraints;
 
   for(const auto& solids : Sector::current()->solid_tilemaps) {
-    // FIXME Handle a nonzero tilemap offset
+    // test with all tiles of this tilemap in the rectangle, the surface map
+    // lets us jump straight to the solid tiles of each column
+    Vector offset = solids->get_offset();
+    int starttilex = int(floorf((x1 - 1 - offset.x) / 32));
+    int starttiley = int(floorf((y1 - 1 - offset.y) / 32));
+    float max_x = x2 + 1 - offset.x;
+    float max_y = y2 + 1 - offset.y;
+    int height = int(solids->get_height());
+
     for(int x = starttilex; x*32 < max_x; ++x) {
-      for(int y = starttiley; y*32 < max_y; ++y) {
+      for(int y = solids->get_next_solid_row(x, starttiley);
+          y < height && y*32 < max_y;
+          y = solids->get_next_solid_row(x, y + 1)) {
         const Tile* tile = solids->get_tile(x, y);
         if(!tile)
           continue;
-        // skip non-solid tiles, except water
-        if(! (tile->getAttributes() & (Tile::WATER | Tile::SOLID)))
-          continue;
 
         Rectf rect = solids->get_tile_bbox(x, y);
         if(tile->is_slope ()) { // slope tile
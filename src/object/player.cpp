@@ -1466,7 +1466,7 @@ Player::kill(bool completely)
   lightsprite->set_angle(0.0f);
 
   if(!completely && is_big()) {
-    SoundManager::current()->play("sounds/hurt.wav");
+    SoundManager::current()->play("sounds/hurt.wav", Vector(-1, -1), SOUND_PRIORITY_HIGH);
 
     if(player_status->bonus == FIRE_BONUS
       || player_status->bonus == ICE_BONUS
@@ -1481,7 +1481,7 @@ Player::kill(bool completely)
       set_bonus(NO_BONUS, true);
     }
   } else {
-    SoundManager::current()->play("sounds/kill.wav");
+    SoundManager::current()->play("sounds/kill.wav", Vector(-1, -1), SOUND_PRIORITY_HIGH);
 
     // do not die when in edit mode
     if (edit_mode) {
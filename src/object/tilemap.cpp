@@ -21,15 +21,18 @@
 #include "editor/editor.hpp"
 #include "object/tilemap.hpp"
 #include "scripting/squirrel_util.hpp"
+#include "supertux/gameconfig.hpp"
 #include "supertux/globals.hpp"
 #include "supertux/level.hpp"
 #include "supertux/object_factory.hpp"
 #include "supertux/sector.hpp"
+#include "supertux/tile.hpp"
 #include "supertux/tile_manager.hpp"
 #include "supertux/tile_set.hpp"
 #include "util/reader.hpp"
 #include "util/reader_document.hpp"
 #include "util/reader_mapping.hpp"
+#include "util/run_length.hpp"
 
 TileMap::TileMap(const TileSet *new_tileset) :
   ExposedObject<TileMap, scripting::TileMap>(this),
@@ -57,7 +60,9 @@ TileMap::TileMap(const TileSet *new_tileset) :
   draw_target(DrawingContext::NORMAL),
   new_size_x(0),
   new_size_y(0),
-  add_path(false)
+  add_path(false),
+  surface_rows(),
+  surface_dirty()
 {
 }
 
@@ -87,7 +92,9 @@ TileMap::TileMap(const TileSet *tileset_, const ReaderMapping& reader) :
   draw_target(DrawingContext::NORMAL),
   new_size_x(0),
   new_size_y(0),
-  add_path(false)
+  add_path(false),
+  surface_rows(),
+  surface_dirty()
 {
   assert(tileset);
 
@@ -143,8 +150,13 @@ TileMap::TileMap(const TileSet *tileset_, const ReaderMapping& reader) :
     resize(Sector::current()->get_width()/32, Sector::current()->get_height()/32);
     editor_active = false;
   } else {
-    if(!reader.get("tiles", tiles))
+    std::vector<unsigned int> runs;
+    if(reader.get("tiles-rle", runs)) {
+      if(!RunLength::decode(runs, size_t(width) * size_t(height), tiles))
+        throw std::runtime_error("Malformed tiles-rle in tilemap.");
+    } else if(!reader.take("tiles", tiles)) {
       throw std::runtime_error("No tiles in tilemap.");
+    }
 
     if(int(tiles.size()) != width*height) {
       throw std::runtime_error("wrong number of tiles in tilemap.");
@@ -153,6 +165,8 @@ TileMap::TileMap(const TileSet *tileset_, const ReaderMapping& reader) :
 
   bool empty = true;
 
+  tileset->prefetch(tiles);
+
   // make sure all tiles used on the tilemap are loaded and tilemap isn't empty
   for(const auto& tile : tiles) {
     if(tile != 0) {
@@ -202,7 +216,11 @@ TileMap::save(Writer& writer) {
   if(path) {
     path->save(writer);
   }
-  writer.write("tiles", tiles);
+  if(g_config->editor_rle_tiles) {
+    writer.write("tiles-rle", RunLength::encode(tiles));
+  } else {
+    writer.write("tiles", tiles);
+  }
 }
 
 ObjectSettings
@@ -455,6 +473,7 @@ TileMap::set(int newwidth, int newheight, const std::vector<unsigned int>&newt,
     z_pos  = new_z_pos;
   real_solid  = newsolid;
   update_effective_solid ();
+  invalidate_surfaces();
 
   // make sure all tiles are loaded
   for(const auto& tile : tiles)
@@ -491,6 +510,7 @@ TileMap::resize(int new_width, int new_height, int fill_id)
 
   height = new_height;
   width = new_width;
+  invalidate_surfaces();
 }
 
 void TileMap::resize(Size newsize) {
@@ -554,6 +574,7 @@ TileMap::change(int x, int y, uint32_t newtile)
 {
   assert(x >= 0 && x < width && y >= 0 && y < height);
   tiles[y*width + x] = newtile;
+  invalidate_surface(x);
 }
 
 void
@@ -623,6 +644,54 @@ void
 TileMap::set_tileset(const TileSet* new_tileset)
 {
   tileset = new_tileset;
+  invalidate_surfaces();
+}
+
+int
+TileMap::get_next_solid_row(int x, int y) const
+{
+  if(x < 0 || x >= width || y >= height)
+    return height;
+  if(y < 0)
+    y = 0;
+
+  if(surface_rows.size() != tiles.size()) {
+    surface_rows.assign(tiles.size(), height);
+    surface_dirty.assign(width, true);
+  }
+  if(surface_dirty[x])
+    update_surface_column(x);
+
+  return surface_rows[y*width + x];
+}
+
+void
+TileMap::invalidate_surface(int x)
+{
+  if(x >= 0 && x < int(surface_dirty.size()))
+    surface_dirty[x] = true;
+}
+
+void
+TileMap::invalidate_surfaces()
+{
+  // forces a full rebuild on the next lookup
+  surface_rows.clear();
+  surface_dirty.clear();
+}
+
+void
+TileMap::update_surface_column(int x) const
+{
+  // walk the column bottom-up, remembering the last solid row seen
+  int next_solid = height;
+  for(int y = height - 1; y >= 0; --y) {
+    const Tile* tile = tileset->get(tiles[y*width + x]);
+    if(tile && (tile->getAttributes() & (Tile::WATER | Tile::SOLID)))
+      next_solid = y;
+    surface_rows[y*width + x] = next_solid;
+  }
+  surface_dirty[x] = false;
 }
 
 /* EOF */
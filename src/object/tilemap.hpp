@@ -142,6 +142,14 @@ public:
   /// changes all tiles with the given ID
   void change_all(uint32_t oldtile, uint32_t newtile);
 
+  /**
+   * Returns the row of the first tile in column @c x, at or below row @c y,
+   * that is solid or water, or the height of the tilemap if there is none.
+   * The lookup is served from a per-column surface map that is rebuilt
+   * lazily for columns whose tiles changed.
+   */
+  int get_next_solid_row(int x, int y) const;
+
   void set_drawing_effect(DrawingEffect effect)
   {
     drawing_effect = effect;
@@ -221,6 +229,11 @@ private:
 
   void float_channel(float target, float &current, float remaining_time, float elapsed_time);
 
+  /** Marks the surface map of column @c x (or all columns) as outdated */
+  void invalidate_surface(int x);
+  void invalidate_surfaces();
+  void update_surface_column(int x) const;
+
   /**
    * Is the tilemap currently moving (following the path)
    */
@@ -232,6 +245,11 @@ private:
   int new_size_y;
   bool add_path;
 
+  /** For every tile, the row of the next solid or water tile at or below it
+      in the same column, see get_next_solid_row() */
+  mutable std::vector<int> surface_rows;
+  mutable std::vector<bool> surface_dirty;
+
 private:
   TileMap(const TileMap&);
   TileMap& operator=(const TileMap&);
@@ -16,59 +16,45 @@
 
 #include "physfs/ifile_streambuf.hpp"
 
-#include <stdexcept>
-#include <sstream>
-
 #include <assert.h>
 
+#include "physfs/physfs_file_data.hpp"
+
 IFileStreambuf::IFileStreambuf(const std::string& filename) :
-  file(),
-  buf()
+  m_data(new PhysFSFileData(filename, true))
 {
-  // check this as PHYSFS seems to be buggy and still returns a
-  // valid pointer in this case
-  if(filename.empty()) {
-    throw std::runtime_error("Couldn't open file: empty filename");
-  }
-  file = PHYSFS_openRead(filename.c_str());
-  if(file == 0) {
-    std::stringstream msg;
-    msg << "Couldn't open file '" << filename << "': "
-        << PHYSFS_getLastErrorCode();
-    throw std::runtime_error(msg.str());
-  }
+  // the get area points straight at the file data, std::streambuf
+  // wants it writable, so a mapped file is mapped copy-on-write
+  char* begin = m_data->get_writable_data();
+  setg(begin, begin, begin + m_data->get_size());
 }
 
 IFileStreambuf::~IFileStreambuf()
 {
-  PHYSFS_close(file);
 }
 
 int
 IFileStreambuf::underflow()
 {
-  if(PHYSFS_eof(file)) {
-    return traits_type::eof();
-  }
-
-  PHYSFS_sint64 bytesread = PHYSFS_readBytes(file, buf, sizeof(buf));
-  if(bytesread <= 0) {
-    return traits_type::eof();
-  }
-  setg(buf, buf, buf + bytesread);
+  return traits_type::eof();
+}
 
-  return buf[0];
+std::streamsize
+IFileStreambuf::showmanyc()
+{
+  std::streamsize avail = egptr() - gptr();
+  return avail > 0 ? avail : -1;
 }
 
 IFileStreambuf::pos_type
 IFileStreambuf::seekpos(pos_type pos, std::ios_base::openmode)
 {
-  if(PHYSFS_seek(file, static_cast<PHYSFS_uint64> (pos)) == 0) {
+  off_type off = static_cast<off_type>(pos);
+  if(off < 0 || off > egptr() - eback()) {
     return pos_type(off_type(-1));
   }
 
-  // the seek invalidated the buffer
-  setg(buf, buf, buf);
+  setg(eback(), eback() + off, egptr());
   return pos;
 }
 
@@ -77,18 +63,15 @@ IFileStreambuf::seekoff(off_type off, std::ios_base::seekdir dir,
                         std::ios_base::openmode mode)
 {
   off_type pos = off;
-  PHYSFS_sint64 ptell = PHYSFS_tell(file);
 
   switch(dir) {
     case std::ios_base::beg:
       break;
     case std::ios_base::cur:
-      if(off == 0)
-        return static_cast<pos_type> (ptell) - static_cast<pos_type> (egptr() - gptr());
-      pos += static_cast<off_type> (ptell) - static_cast<off_type> (egptr() - gptr());
+      pos += gptr() - eback();
       break;
     case std::ios_base::end:
-      pos += static_cast<off_type> (PHYSFS_fileLength(file));
+      pos += egptr() - eback();
       break;
     default:
       assert(false);
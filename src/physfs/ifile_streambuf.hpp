@@ -17,11 +17,17 @@
 #ifndef HEADER_SUPERTUX_PHYSFS_IFILE_STREAMBUF_HPP
 #define HEADER_SUPERTUX_PHYSFS_IFILE_STREAMBUF_HPP
 
-#include <streambuf>
+#include <memory>
 #include <physfs.h>
+#include <streambuf>
+#include <string>
+
+class PhysFSFileData;
 
 /** This class implements a C++ streambuf object for physfs files.
- * So that you can use normal istream operations on them
+ * So that you can use normal istream operations on them. The whole
+ * file is loaded (or memory-mapped) up front, so reads and seeks
+ * never go back to PhysFS.
  */
 class IFileStreambuf : public std::streambuf
 {
@@ -31,13 +37,13 @@ public:
 
 protected:
   virtual int underflow();
+  virtual std::streamsize showmanyc();
   virtual pos_type seekoff(off_type pos, std::ios_base::seekdir,
                            std::ios_base::openmode);
   virtual pos_type seekpos(pos_type pos, std::ios_base::openmode);
 
 private:
-  PHYSFS_file* file;
-  char buf[1024];
+  std::unique_ptr<PhysFSFileData> m_data;
 
 private:
   IFileStreambuf(const IFileStreambuf&);
@@ -19,6 +19,8 @@
 #include <sstream>
 #include <stdexcept>
 
+#include "physfs/physfs_directory_index.hpp"
+
 OFileStreambuf::OFileStreambuf(const std::string& filename) :
   file()
 {
@@ -37,6 +39,9 @@ OFileStreambuf::~OFileStreambuf()
 {
   sync();
   PHYSFS_close(file);
+
+  // the file is new or changed its size, so cached listings are stale
+  PhysFSDirectoryIndex::invalidate();
 }
 
 int
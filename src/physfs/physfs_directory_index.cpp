@@ -0,0 +1,114 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "physfs/physfs_directory_index.hpp"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+struct StatEntry
+{
+  bool exists;
+  PHYSFS_Stat stat;
+};
+
+std::mutex g_mutex;
+std::unordered_map<std::string, std::vector<std::string> > g_listings;
+std::unordered_map<std::string, StatEntry> g_stats;
+
+/** "levels/world1/" and "/levels/world1" name the same directory */
+std::string normalize(const std::string& filename)
+{
+  size_t begin = filename.find_first_not_of('/');
+  if (begin == std::string::npos)
+    return std::string();
+  size_t end = filename.find_last_not_of('/');
+  return filename.substr(begin, end - begin + 1);
+}
+
+} // namespace
+
+std::vector<std::string>
+PhysFSDirectoryIndex::enumerate(const std::string& dirname)
+{
+  std::string key = normalize(dirname);
+
+  std::lock_guard<std::mutex> lock(g_mutex);
+  auto it = g_listings.find(key);
+  if (it == g_listings.end())
+  {
+    std::vector<std::string> files;
+    char** directory = PHYSFS_enumerateFiles(key.empty() ? "/" : key.c_str());
+    if (directory)
+    {
+      for(char** i = directory; *i != 0; ++i)
+      {
+        files.push_back(*i);
+      }
+      PHYSFS_freeList(directory);
+    }
+    it = g_listings.insert(std::make_pair(key, std::move(files))).first;
+  }
+  return it->second;
+}
+
+bool
+PhysFSDirectoryIndex::stat(const std::string& filename, PHYSFS_Stat& statbuf)
+{
+  std::string key = normalize(filename);
+
+  std::lock_guard<std::mutex> lock(g_mutex);
+  auto it = g_stats.find(key);
+  if (it == g_stats.end())
+  {
+    StatEntry entry;
+    entry.exists = PHYSFS_stat(key.empty() ? "/" : key.c_str(), &entry.stat) != 0;
+    it = g_stats.insert(std::make_pair(key, entry)).first;
+  }
+
+  if (!it->second.exists)
+    return false;
+
+  statbuf = it->second.stat;
+  return true;
+}
+
+bool
+PhysFSDirectoryIndex::exists(const std::string& filename)
+{
+  PHYSFS_Stat statbuf;
+  return stat(filename, statbuf);
+}
+
+bool
+PhysFSDirectoryIndex::is_directory(const std::string& filename)
+{
+  PHYSFS_Stat statbuf;
+  return stat(filename, statbuf) && statbuf.filetype == PHYSFS_FILETYPE_DIRECTORY;
+}
+
+void
+PhysFSDirectoryIndex::invalidate()
+{
+  std::lock_guard<std::mutex> lock(g_mutex);
+  g_listings.clear();
+  g_stats.clear();
+}
+
+/* EOF */
@@ -0,0 +1,56 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HEADER_SUPERTUX_PHYSFS_PHYSFS_DIRECTORY_INDEX_HPP
+#define HEADER_SUPERTUX_PHYSFS_PHYSFS_DIRECTORY_INDEX_HPP
+
+#include <physfs.h>
+#include <string>
+#include <vector>
+
+/** In-memory cache of the directory tree visible through the PhysFS
+    search path. Directory listings and stat() results are fetched
+    from PhysFS on first use and then served from memory until
+    invalidate() is called, which PhysFSFileSystem does whenever the
+    search path changes or something is written through PhysFS. */
+class PhysFSDirectoryIndex final
+{
+public:
+  /** Same as PHYSFS_enumerateFiles(), an unknown directory gives an
+      empty list */
+  static std::vector<std::string> enumerate(const std::string& dirname);
+
+  /** Same as PHYSFS_stat(), returns false if the file doesn't exist.
+      The result is cached, so the modification time and size don't
+      reflect changes made outside of PhysFS; freshness checks have to
+      call PHYSFS_stat() themselves. */
+  static bool stat(const std::string& filename, PHYSFS_Stat& statbuf);
+
+  static bool exists(const std::string& filename);
+  static bool is_directory(const std::string& filename);
+
+  /** Forgets everything, must be called after the search path or the
+      files in it changed */
+  static void invalidate();
+
+private:
+  PhysFSDirectoryIndex() = delete;
+};
+
+#endif
+
+/* EOF */
@@ -0,0 +1,119 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "physfs/physfs_file_data.hpp"
+
+#include <physfs.h>
+#include <sstream>
+#include <stdexcept>
+
+#include "util/file_system.hpp"
+
+namespace {
+
+/** Returns the path of @c filename in the native file system, or an
+    empty string if it doesn't live in a plain directory */
+std::string get_native_path(const std::string& filename)
+{
+  const char* realdir = PHYSFS_getRealDir(filename.c_str());
+  if(!realdir || !FileSystem::is_directory(realdir))
+    return std::string();
+
+  // directories mounted below a mount point (add-ons under
+  // custom/<id>/) don't contain the mount point itself
+  std::string path = filename;
+  while(!path.empty() && path[0] == '/')
+    path.erase(0, 1);
+
+  const char* mountpoint = PHYSFS_getMountPoint(realdir);
+  if(mountpoint)
+  {
+    std::string prefix = mountpoint;
+    while(!prefix.empty() && prefix[0] == '/')
+      prefix.erase(0, 1);
+    if(path.compare(0, prefix.size(), prefix) != 0)
+      return std::string();
+    path.erase(0, prefix.size());
+  }
+
+  return FileSystem::join(realdir, path);
+}
+
+} // namespace
+
+PhysFSFileData::PhysFSFileData(const std::string& filename, bool writable) :
+  m_mapped(),
+  m_buffer(),
+  m_data(nullptr),
+  m_size(0)
+{
+  // check this as PHYSFS seems to be buggy and still returns a
+  // valid pointer in this case
+  if(filename.empty()) {
+    throw std::runtime_error("Couldn't open file: empty filename");
+  }
+
+  std::string native_path = get_native_path(filename);
+  if(!native_path.empty() && m_mapped.open(native_path, writable))
+  {
+    m_data = m_mapped.get_writable_data();
+    m_size = m_mapped.get_size();
+    return;
+  }
+
+  PHYSFS_File* file = PHYSFS_openRead(filename.c_str());
+  if(!file) {
+    std::stringstream msg;
+    msg << "Couldn't open file '" << filename << "': "
+        << PHYSFS_getLastErrorCode();
+    throw std::runtime_error(msg.str());
+  }
+
+  PHYSFS_sint64 length = PHYSFS_fileLength(file);
+  if(length > 0)
+  {
+    m_buffer.resize(static_cast<size_t>(length));
+    PHYSFS_sint64 bytes_read = PHYSFS_readBytes(file, m_buffer.data(), m_buffer.size());
+    if(bytes_read != length)
+    {
+      PHYSFS_close(file);
+      std::stringstream msg;
+      msg << "Couldn't read file '" << filename << "': "
+          << PHYSFS_getLastErrorCode();
+      throw std::runtime_error(msg.str());
+    }
+  }
+  else
+  {
+    // length unknown, read in large blocks until EOF
+    char block[64 * 1024];
+    PHYSFS_sint64 bytes_read;
+    while((bytes_read = PHYSFS_readBytes(file, block, sizeof(block))) > 0)
+    {
+      m_buffer.insert(m_buffer.end(), block, block + bytes_read);
+    }
+  }
+  PHYSFS_close(file);
+
+  if(!m_buffer.empty())
+  {
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+  }
+}
+
+/* EOF */
@@ -0,0 +1,56 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HEADER_SUPERTUX_PHYSFS_PHYSFS_FILE_DATA_HPP
+#define HEADER_SUPERTUX_PHYSFS_PHYSFS_FILE_DATA_HPP
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#include "util/mapped_file.hpp"
+
+/** The complete contents of a PhysFS file as one contiguous buffer.
+    Files that live in a native directory are memory-mapped, files
+    inside archives are read with a single PHYSFS_readBytes() call. */
+class PhysFSFileData
+{
+public:
+  /** Throws std::runtime_error when the file can't be read. With
+      @c writable, get_writable_data() may be used, mapped files are
+      then mapped copy-on-write. */
+  PhysFSFileData(const std::string& filename, bool writable = false);
+
+  const char* get_data() const { return m_data ? m_data : ""; }
+  /** Writes stay in memory, only valid if constructed as writable */
+  char* get_writable_data() { return m_data; }
+  size_t get_size() const { return m_size; }
+
+private:
+  MappedFile m_mapped;
+  std::vector<char> m_buffer;
+  char* m_data;
+  size_t m_size;
+
+private:
+  PhysFSFileData(const PhysFSFileData&) = delete;
+  PhysFSFileData& operator=(const PhysFSFileData&) = delete;
+};
+
+#endif
+
+/* EOF */
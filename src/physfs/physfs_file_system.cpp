@@ -17,6 +17,7 @@
 #include "physfs/physfs_file_system.hpp"
 
 #include "physfs/ifile_stream.hpp"
+#include "physfs/physfs_directory_index.hpp"
 
 PhysFSFileSystem::PhysFSFileSystem()
 {
@@ -25,16 +26,7 @@ PhysFSFileSystem::PhysFSFileSystem()
 std::vector<std::string>
 PhysFSFileSystem::open_directory(const std::string& pathname)
 {
-  std::vector<std::string> files;
-
-  char** directory = PHYSFS_enumerateFiles(pathname.c_str());
-  for(char** i = directory; *i != 0; ++i)
-  {
-    files.push_back(*i);
-  }
-  PHYSFS_freeList(directory);
-
-  return files;
+  return PhysFSDirectoryIndex::enumerate(pathname);
 }
 
 std::unique_ptr<std::istream>
@@ -46,15 +38,45 @@ PhysFSFileSystem::open_file(const std::string& filename)
 bool
 PhysFSFileSystem::is_directory(const std::string& filename)
 {
-  PHYSFS_Stat statbuf;
-  PHYSFS_stat(filename.c_str(), &statbuf);
-  return statbuf.filetype == PHYSFS_FILETYPE_DIRECTORY;
+  return PhysFSDirectoryIndex::is_directory(filename);
+}
+
+bool
+PhysFSFileSystem::exists(const std::string& filename)
+{
+  return PhysFSDirectoryIndex::exists(filename);
 }
 
 bool
 PhysFSFileSystem::remove(const std::string& filename)
 {
-  return PHYSFS_delete(filename.c_str()) == 0;
+  bool result = PHYSFS_delete(filename.c_str()) == 0;
+  PhysFSDirectoryIndex::invalidate();
+  return result;
+}
+
+bool
+PhysFSFileSystem::mkdir(const std::string& dirname)
+{
+  bool result = PHYSFS_mkdir(dirname.c_str()) != 0;
+  PhysFSDirectoryIndex::invalidate();
+  return result;
+}
+
+int
+PhysFSFileSystem::mount(const std::string& path, const std::string& mountpoint, bool append)
+{
+  int result = PHYSFS_mount(path.c_str(), mountpoint.empty() ? NULL : mountpoint.c_str(), append ? 1 : 0);
+  PhysFSDirectoryIndex::invalidate();
+  return result;
+}
+
+int
+PhysFSFileSystem::unmount(const std::string& path)
+{
+  int result = PHYSFS_unmount(path.c_str());
+  PhysFSDirectoryIndex::invalidate();
+  return result;
 }
 
 /* EOF */
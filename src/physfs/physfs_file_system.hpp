@@ -27,7 +27,14 @@ public:
   std::vector<std::string>    open_directory(const std::string& pathname);
   std::unique_ptr<std::istream> open_file(const std::string& filename);
   static bool is_directory(const std::string& filename);
+  static bool exists(const std::string& filename);
   static bool remove(const std::string& filenam);
+  static bool mkdir(const std::string& dirname);
+
+  /** Wrappers around PHYSFS_mount()/PHYSFS_unmount() that keep the
+      PhysFSDirectoryIndex up to date, return 0 on error like PhysFS */
+  static int mount(const std::string& path, const std::string& mountpoint, bool append);
+  static int unmount(const std::string& path);
 };
 
 #endif
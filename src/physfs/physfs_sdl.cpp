@@ -16,54 +16,85 @@
 
 #include "physfs/physfs_sdl.hpp"
 
-#include <physfs.h>
-#include <sstream>
+#include <algorithm>
+#include <string.h>
 #include <stdexcept>
 #include <assert.h>
 #include <stdio.h>
 
-#include "util/log.hpp"
+#include "physfs/physfs_file_data.hpp"
+
+namespace {
+
+/** The whole file is loaded (or mapped) when the RWops is created, so
+    the image and font loaders read from memory instead of issuing
+    small PhysFS reads */
+struct RWopsFile
+{
+  RWopsFile(const std::string& filename) :
+    data(filename),
+    pos(0)
+  {}
+
+  PhysFSFileData data;
+  Sint64 pos;
+};
+
+} // namespace
+
+static Sint64 funcSize(struct SDL_RWops* context)
+{
+  RWopsFile* file = static_cast<RWopsFile*>(context->hidden.unknown.data1);
+  return static_cast<Sint64>(file->data.get_size());
+}
 
 static Sint64 funcSeek(struct SDL_RWops* context, Sint64 offset, int whence)
 {
-  PHYSFS_file* file = (PHYSFS_file*) context->hidden.unknown.data1;
-  int res;
+  RWopsFile* file = static_cast<RWopsFile*>(context->hidden.unknown.data1);
+  Sint64 size = static_cast<Sint64>(file->data.get_size());
+  Sint64 pos;
   switch(whence) {
     case SEEK_SET:
-      res = PHYSFS_seek(file, offset);
+      pos = offset;
       break;
     case SEEK_CUR:
-      res = PHYSFS_seek(file, PHYSFS_tell(file) + offset);
+      pos = file->pos + offset;
       break;
     case SEEK_END:
-      res = PHYSFS_seek(file, PHYSFS_fileLength(file) + offset);
+      pos = size + offset;
       break;
     default:
-      res = 0;
+      pos = -1;
       assert(false);
       break;
   }
-  if(res == 0) {
-    log_warning << "Error seeking in file: " << PHYSFS_getLastErrorCode() << std::endl;
+  if(pos < 0 || pos > size) {
     return -1;
   }
 
-  return (int) PHYSFS_tell(file);
+  file->pos = pos;
+  return pos;
 }
 
 static size_t  funcRead(struct SDL_RWops* context, void* ptr, size_t  size, size_t  maxnum)
 {
-  PHYSFS_file* file = (PHYSFS_file*) context->hidden.unknown.data1;
+  RWopsFile* file = static_cast<RWopsFile*>(context->hidden.unknown.data1);
+  if(size == 0) {
+    return 0;
+  }
 
-  int res = PHYSFS_readBytes(file, ptr, size * maxnum);
-  return res / size;
+  size_t avail = file->data.get_size() - static_cast<size_t>(file->pos);
+  size_t num = std::min(maxnum, avail / size);
+  memcpy(ptr, file->data.get_data() + file->pos, num * size);
+  file->pos += static_cast<Sint64>(num * size);
+  return num;
 }
 
 static int funcClose(struct SDL_RWops* context)
 {
-  PHYSFS_file* file = (PHYSFS_file*) context->hidden.unknown.data1;
+  RWopsFile* file = static_cast<RWopsFile*>(context->hidden.unknown.data1);
 
-  PHYSFS_close(file);
+  delete file;
   delete context;
 
   return 0;
@@ -71,23 +102,12 @@ static int funcClose(struct SDL_RWops* context)
 
 SDL_RWops* get_physfs_SDLRWops(const std::string& filename)
 {
-  // check this as PHYSFS seems to be buggy and still returns a
-  // valid pointer in this case
-  if(filename.empty()) {
-    throw std::runtime_error("Couldn't open file: empty filename");
-  }
-
-  PHYSFS_file* file = (PHYSFS_file*) PHYSFS_openRead(filename.c_str());
-  if(!file) {
-    std::stringstream msg;
-    msg << "Couldn't open '" << filename << "': "
-        << PHYSFS_getLastErrorCode();
-    throw std::runtime_error(msg.str());
-  }
+  RWopsFile* file = new RWopsFile(filename);
 
   SDL_RWops* ops = new SDL_RWops();
   ops->type = 0;
   ops->hidden.unknown.data1 = file;
+  ops->size = funcSize;
   ops->seek = funcSeek;
   ops->read = funcRead;
   ops->write = 0;
@@ -0,0 +1,85 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "scripting/closure_cache.hpp"
+
+#include "scripting/squirrel_error.hpp"
+#include "scripting/squirrel_util.hpp"
+
+namespace scripting {
+
+int ClosureCache::s_hits = 0;
+int ClosureCache::s_misses = 0;
+
+ClosureCache::ClosureCache() :
+  m_closures()
+{
+}
+
+ClosureCache::~ClosureCache()
+{
+  // the closures must have been released with release(), there is no
+  // VM to release them with anymore
+}
+
+void
+ClosureCache::push(HSQUIRRELVM vm, const std::string& source, const std::string& sourcename)
+{
+  Key key(sourcename, source);
+  auto it = m_closures.find(key);
+  if(it != m_closures.end()) {
+    s_hits += 1;
+    sq_pushobject(vm, it->second);
+    return;
+  }
+
+  s_misses += 1;
+  compile_script(vm, source.data(), source.size(), sourcename);
+  if(m_closures.size() >= MAX_ENTRIES)
+    return;
+
+  HSQOBJECT closure;
+  sq_resetobject(&closure);
+  if(SQ_FAILED(sq_getstackobj(vm, -1, &closure)))
+    throw SquirrelError(vm, "Couldn't get compiled script from stack");
+  sq_addref(vm, &closure);
+  m_closures[key] = closure;
+}
+
+void
+ClosureCache::release(HSQUIRRELVM vm)
+{
+  for(auto& closure : m_closures) {
+    sq_release(vm, &closure.second);
+  }
+  m_closures.clear();
+}
+
+void
+ClosureCache::print_stats(std::ostream& out)
+{
+  int total = s_hits + s_misses;
+  out << "Compiled scripts: " << s_hits << " hits, " << s_misses << " misses";
+  if(total > 0) {
+    out << " (" << (100 * s_hits / total) << "% hit rate)";
+  }
+  out << std::endl;
+}
+
+} // namespace scripting
+
+/* EOF */
@@ -0,0 +1,71 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HEADER_SUPERTUX_SCRIPTING_CLOSURE_CACHE_HPP
+#define HEADER_SUPERTUX_SCRIPTING_CLOSURE_CACHE_HPP
+
+#include <map>
+#include <ostream>
+#include <squirrel.h>
+#include <string>
+
+namespace scripting {
+
+/** The compiled closures of the scripts run with one root table (a
+    sector or worldmap), so that triggers that fire again and again
+    don't compile their script each time */
+class ClosureCache
+{
+public:
+  /** scripts beyond this many are compiled on every run */
+  static const size_t MAX_ENTRIES = 256;
+
+public:
+  ClosureCache();
+  ~ClosureCache();
+
+  /** Pushes the closure compiled from @c source onto the stack of
+      @c vm. Closures are bound to the root table of the VM they were
+      compiled on, so all VMs passed in must share one root table.
+      Throws if the script can't be compiled. */
+  void push(HSQUIRRELVM vm, const std::string& source, const std::string& sourcename);
+
+  /** Releases all closures, call before the root table is released */
+  void release(HSQUIRRELVM vm);
+
+  /** print hits and misses of all caches */
+  static void print_stats(std::ostream& out);
+
+private:
+  /** sourcename and source */
+  typedef std::pair<std::string, std::string> Key;
+
+  std::map<Key, HSQOBJECT> m_closures;
+
+  static int s_hits;
+  static int s_misses;
+
+private:
+  ClosureCache(const ClosureCache&) = delete;
+  ClosureCache& operator=(const ClosureCache&) = delete;
+};
+
+} // namespace scripting
+
+#endif
+
+/* EOF */
@@ -26,6 +26,7 @@
 #include "supertux/gameconfig.hpp"
 #include "supertux/game_manager.hpp"
 #include "supertux/globals.hpp"
+#include "supertux/savegame.hpp"
 #include "supertux/screen_manager.hpp"
 #include "supertux/sector.hpp"
 #include "supertux/shrinkfade.hpp"
@@ -34,10 +35,13 @@
 #include "supertux/world.hpp"
 #include "util/gettext.hpp"
 #include "video/renderer.hpp"
+#include "video/texture_manager.hpp"
 #include "video/video_system.hpp"
 #include "worldmap/tux.hpp"
 #include "worldmap/worldmap.hpp"
 
+#include "scripting/closure_cache.hpp"
+#include "scripting/script_profiler.hpp"
 #include "scripting/squirrel_util.hpp"
 #include "scripting/time_scheduler.hpp"
 
@@ -97,7 +101,7 @@ void abort_screenfade()
 
 std::string translate(const std::string& text)
 {
-  return g_dictionary_manager->get_dictionary().translate(text);
+  return ::_(text);
 }
 
 std::string _(const std::string& text)
@@ -187,6 +191,31 @@ void debug_worldmap_ghost(bool enable)
   worldmap->get_tux()->set_ghost_mode(enable);
 }
 
+void debug_texture_stats()
+{
+  TextureManager::current()->print_stats(ConsoleBuffer::output);
+}
+
+void debug_sound_stats()
+{
+  SoundManager::current()->print_stats(ConsoleBuffer::output);
+}
+
+void debug_script_stats()
+{
+  ClosureCache::print_stats(ConsoleBuffer::output);
+}
+
+void debug_script_profile()
+{
+  if(!ScriptProfiler::current())
+    throw std::runtime_error("Script profiling is off, start with --profile-scripts");
+
+  ScriptProfiler::current()->print_stats(ConsoleBuffer::output);
+  ConsoleBuffer::output << "Deferred wakeups: "
+                        << TimeScheduler::instance->get_deferred_count() << std::endl;
+}
+
 void save_state()
 {
   auto worldmap = worldmap::WorldMap::current();
@@ -215,6 +244,22 @@ void load_state()
   }
 }
 
+void export_savegame(const std::string& filename)
+{
+  if (GameSession::current())
+  {
+    GameSession::current()->get_savegame().export_text(filename);
+  }
+  else if (worldmap::WorldMap::current())
+  {
+    worldmap::WorldMap::current()->get_savegame().export_text(filename);
+  }
+  else
+  {
+    throw std::runtime_error("Can't export savegame without active level or Worldmap");
+  }
+}
+
 // not added to header, function to only be used by others
 // in this file
 bool validate_sector_player()
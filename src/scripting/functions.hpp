@@ -127,6 +127,11 @@ void save_state();
  */
 void load_state();
 
+/**
+ * Write the savegame in use as readable text to filename in the user directory
+ */
+void export_savegame(const std::string& filename);
+
 /**
  * enable/disable drawing of collision rectangles
  */
@@ -152,6 +157,26 @@ void debug_draw_editor_images(bool enable);
  */
 void debug_worldmap_ghost(bool enable);
 
+/**
+ * print texture cache statistics (resident bytes, hits, misses, evictions)
+ */
+void debug_texture_stats();
+
+/**
+ * print sound buffer cache statistics (resident bytes, hits, misses, late plays)
+ */
+void debug_sound_stats();
+
+/**
+ * print compiled script cache statistics (hits, misses)
+ */
+void debug_script_stats();
+
+/**
+ * print calls and time per script and function, needs --profile-scripts
+ */
+void debug_script_profile();
+
 /**
  * Changes music to musicfile
  */
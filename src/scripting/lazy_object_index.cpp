@@ -0,0 +1,275 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "scripting/lazy_object_index.hpp"
+
+#include "scripting/scripting.hpp"
+#include "scripting/squirrel_error.hpp"
+#include "scripting/squirrel_util.hpp"
+#include "supertux/game_object.hpp"
+#include "supertux/script_interface.hpp"
+#include "util/log.hpp"
+
+namespace scripting {
+
+LazyObjectIndex::LazyObjectIndex(const HSQOBJECT& table) :
+  m_table(table),
+  m_delegate(),
+  m_fallback(),
+  m_entries(),
+  m_exposed(0),
+  m_enabled(false)
+{
+  HSQUIRRELVM vm = global_vm;
+  SQInteger oldtop = sq_gettop(vm);
+
+  // keep the old delegate (usually the root table) behind the new one
+  sq_pushobject(vm, m_table);
+  if(SQ_FAILED(sq_getdelegate(vm, -1))) {
+    sq_settop(vm, oldtop);
+    throw SquirrelError(vm, "Couldn't get table delegate");
+  }
+  sq_resetobject(&m_fallback);
+  sq_getstackobj(vm, -1, &m_fallback);
+  sq_addref(vm, &m_fallback);
+  sq_pop(vm, 1);
+
+  sq_pushobject(vm, m_table);
+  sq_newtable(vm);
+  if(m_fallback._type == OT_TABLE) {
+    sq_pushobject(vm, m_fallback);
+    if(SQ_FAILED(sq_setdelegate(vm, -2))) {
+      sq_settop(vm, oldtop);
+      throw SquirrelError(vm, "Couldn't set delegate of object index");
+    }
+  }
+
+  sq_pushstring(vm, "_get", -1);
+  sq_pushuserpointer(vm, this);
+  sq_newclosure(vm, &LazyObjectIndex::get_metamethod, 1);
+  if(SQ_FAILED(sq_createslot(vm, -3))) {
+    sq_settop(vm, oldtop);
+    throw SquirrelError(vm, "Couldn't register _get metamethod");
+  }
+
+  sq_resetobject(&m_delegate);
+  if(SQ_FAILED(sq_getstackobj(vm, -1, &m_delegate))) {
+    sq_settop(vm, oldtop);
+    throw SquirrelError(vm, "Couldn't get object index table");
+  }
+  sq_addref(vm, &m_delegate);
+
+  if(SQ_FAILED(sq_setdelegate(vm, -2))) {
+    sq_settop(vm, oldtop);
+    throw SquirrelError(vm, "Couldn't set object index as delegate");
+  }
+  sq_settop(vm, oldtop);
+}
+
+LazyObjectIndex::~LazyObjectIndex()
+{
+}
+
+void
+LazyObjectIndex::add(const GameObjectPtr& object)
+{
+  const std::string& name = object->get_name();
+  if(name.empty())
+    return;
+
+  auto script_object = dynamic_cast<ScriptInterface*>(object.get());
+  if(!script_object)
+    return;
+
+  // a later object with the same name replaces the earlier one
+  auto it = m_entries.find(name);
+  if(it != m_entries.end()) {
+    unexpose(it->second);
+  }
+
+  Entry& entry = m_entries[name];
+  entry.object = object.get();
+  entry.script_object = script_object;
+  entry.exposed = false;
+
+  if(m_enabled && shadowed(name)) {
+    expose(entry);
+  }
+}
+
+void
+LazyObjectIndex::remove(const GameObjectPtr& object)
+{
+  const std::string& name = object->get_name();
+  if(name.empty())
+    return;
+
+  auto it = m_entries.find(name);
+  if(it == m_entries.end() || it->second.object != object.get())
+    return;
+
+  unexpose(it->second);
+  m_entries.erase(it);
+}
+
+void
+LazyObjectIndex::enable()
+{
+  m_enabled = true;
+
+  for(auto& entry : m_entries) {
+    if(shadowed(entry.first)) {
+      expose(entry.second);
+    }
+  }
+}
+
+void
+LazyObjectIndex::disable()
+{
+  m_enabled = false;
+  if(m_exposed == 0)
+    return;
+
+  for(auto& entry : m_entries) {
+    unexpose(entry.second);
+  }
+}
+
+void
+LazyObjectIndex::release()
+{
+  disable();
+  m_entries.clear();
+
+  HSQUIRRELVM vm = global_vm;
+  sq_pushobject(vm, m_delegate);
+  delete_table_entry(vm, "_get");
+  sq_pop(vm, 1);
+  sq_release(vm, &m_delegate);
+  sq_resetobject(&m_delegate);
+
+  // give the table its old delegate back
+  sq_pushobject(vm, m_table);
+  sq_pushobject(vm, m_fallback);
+  if(SQ_FAILED(sq_setdelegate(vm, -2))) {
+    sq_pop(vm, 1);
+  }
+  sq_pop(vm, 1);
+  sq_release(vm, &m_fallback);
+  sq_resetobject(&m_fallback);
+}
+
+SQInteger
+LazyObjectIndex::get_metamethod(HSQUIRRELVM vm)
+{
+  // parameters are the table and the key, followed by the free variable
+  SQUserPointer data;
+  if(SQ_SUCCEEDED(sq_getuserpointer(vm, 3, &data))) {
+    auto index = static_cast<LazyObjectIndex*>(data);
+    const SQChar* name;
+    if(sq_gettype(vm, 2) == OT_STRING &&
+       SQ_SUCCEEDED(sq_getstring(vm, 2, &name))) {
+      try {
+        if(index->push(vm, name))
+          return 1;
+      } catch(std::exception& e) {
+        return sq_throwerror(vm, e.what());
+      }
+    }
+  }
+
+  // throwing null tells squirrel that the slot doesn't exist
+  sq_pushnull(vm);
+  return sq_throwobject(vm);
+}
+
+bool
+LazyObjectIndex::push(HSQUIRRELVM vm, const std::string& name)
+{
+  if(!m_enabled)
+    return false;
+
+  auto it = m_entries.find(name);
+  if(it == m_entries.end())
+    return false;
+
+  expose(it->second);
+
+  sq_pushobject(vm, m_table);
+  sq_pushstring(vm, name.c_str(), -1);
+  if(SQ_FAILED(sq_rawget(vm, -2))) {
+    sq_pop(vm, 1);
+    return false;
+  }
+  sq_remove(vm, -2);
+  return true;
+}
+
+bool
+LazyObjectIndex::shadowed(const std::string& name) const
+{
+  if(m_fallback._type != OT_TABLE)
+    return false;
+
+  HSQUIRRELVM vm = global_vm;
+  SQInteger oldtop = sq_gettop(vm);
+  sq_pushobject(vm, m_fallback);
+  sq_pushstring(vm, name.c_str(), -1);
+  bool result = SQ_SUCCEEDED(sq_get(vm, -2));
+  sq_settop(vm, oldtop);
+  return result;
+}
+
+void
+LazyObjectIndex::expose(Entry& entry)
+{
+  if(entry.exposed)
+    return;
+
+  // expose on the global VM like try_expose(), the calling thread has
+  // the table itself as root table
+  sq_pushobject(global_vm, m_table);
+  entry.script_object->expose(global_vm, -1);
+  sq_pop(global_vm, 1);
+  entry.exposed = true;
+  m_exposed += 1;
+}
+
+void
+LazyObjectIndex::unexpose(Entry& entry)
+{
+  if(!entry.exposed)
+    return;
+
+  HSQUIRRELVM vm = global_vm;
+  SQInteger oldtop = sq_gettop(vm);
+  sq_pushobject(vm, m_table);
+  try {
+    entry.script_object->unexpose(vm, -1);
+  } catch(std::exception& e) {
+    log_warning << "Couldn't unregister object: " << e.what() << std::endl;
+  }
+  sq_settop(vm, oldtop);
+
+  entry.exposed = false;
+  m_exposed -= 1;
+}
+
+} // namespace scripting
+
+/* EOF */
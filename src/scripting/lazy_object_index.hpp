@@ -0,0 +1,101 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HEADER_SUPERTUX_SCRIPTING_LAZY_OBJECT_INDEX_HPP
+#define HEADER_SUPERTUX_SCRIPTING_LAZY_OBJECT_INDEX_HPP
+
+#include <squirrel.h>
+#include <string>
+#include <unordered_map>
+
+#include "supertux/game_object_ptr.hpp"
+
+class GameObject;
+class ScriptInterface;
+
+namespace scripting {
+
+/**
+ * Named objects that are exposed to a squirrel table the first time a
+ * script looks them up, instead of all at once when the table becomes
+ * visible to scripts. The table gets a delegate whose _get metamethod
+ * resolves names through the index. The table's previous delegate
+ * (usually the root table) is chained behind the new one, so globals
+ * are found and assigned without a metamethod call. Squirrel searches
+ * that chain before calling _get, so objects named like a global, e.g.
+ * the Camera and Text classes, are exposed right away instead.
+ */
+class LazyObjectIndex
+{
+public:
+  LazyObjectIndex(const HSQOBJECT& table);
+  ~LazyObjectIndex();
+
+  void add(const GameObjectPtr& object);
+  void remove(const GameObjectPtr& object);
+
+  /** resolve names from now on */
+  void enable();
+
+  /** unexpose all objects that were looked up and stop resolving */
+  void disable();
+
+  /** Detach from the table, call before the table is released */
+  void release();
+
+  int get_object_count() const { return static_cast<int>(m_entries.size()); }
+  int get_exposed_count() const { return m_exposed; }
+
+private:
+  struct Entry
+  {
+    GameObject* object;
+    ScriptInterface* script_object;
+    bool exposed;
+  };
+
+private:
+  static SQInteger get_metamethod(HSQUIRRELVM vm);
+
+  /** pushes the object named @c name, exposing it if needed */
+  bool push(HSQUIRRELVM vm, const std::string& name);
+
+  /** true if the previous delegate has a slot @c name, which would
+      hide the object of that name from _get */
+  bool shadowed(const std::string& name) const;
+
+  void expose(Entry& entry);
+  void unexpose(Entry& entry);
+
+private:
+  HSQOBJECT m_table;
+  HSQOBJECT m_delegate;
+  HSQOBJECT m_fallback;
+  std::unordered_map<std::string, Entry> m_entries;
+  int m_exposed;
+  bool m_enabled;
+
+private:
+  LazyObjectIndex(const LazyObjectIndex&) = delete;
+  LazyObjectIndex& operator=(const LazyObjectIndex&) = delete;
+};
+
+} // namespace scripting
+
+#endif
+
+/* EOF */
@@ -0,0 +1,202 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "scripting/script_profiler.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+#include "util/log.hpp"
+
+namespace scripting {
+
+namespace {
+
+/** entries shown per table by print_stats */
+const size_t MAX_PRINTED = 15;
+
+double seconds(std::chrono::steady_clock::duration d)
+{
+  return std::chrono::duration<double>(d).count();
+}
+
+} // namespace
+
+ScriptProfiler::ScriptProfiler(HSQUIRRELVM vm) :
+  m_vm(vm),
+  m_budget(0),
+  m_scripts(),
+  m_functions(),
+  m_threads()
+{
+  // line events are only generated for scripts compiled with debug info
+  sq_enabledebuginfo(m_vm, SQTrue);
+  sq_setnativedebughook(m_vm, &ScriptProfiler::debug_hook);
+}
+
+ScriptProfiler::~ScriptProfiler()
+{
+  sq_setnativedebughook(m_vm, NULL);
+}
+
+void
+ScriptProfiler::set_budget(float seconds_)
+{
+  m_budget = seconds_;
+}
+
+void
+ScriptProfiler::suspend(HSQUIRRELVM vm)
+{
+  auto it = m_threads.find(vm);
+  if(it == m_threads.end())
+    return;
+
+  it->second.suspended = true;
+  it->second.run_start = Clock::now();
+}
+
+void
+ScriptProfiler::reset()
+{
+  m_scripts.clear();
+  m_functions.clear();
+}
+
+void
+ScriptProfiler::debug_hook(HSQUIRRELVM vm, SQInteger type, const SQChar* sourcename,
+                           SQInteger, const SQChar* funcname)
+{
+  ScriptProfiler* profiler = ScriptProfiler::current();
+  if(profiler)
+    profiler->on_event(vm, type, sourcename, funcname);
+}
+
+void
+ScriptProfiler::on_event(HSQUIRRELVM vm, SQInteger type, const SQChar* sourcename,
+                         const SQChar* funcname)
+{
+  Clock::time_point now = Clock::now();
+  Thread& thread = m_threads[vm];
+
+  if(thread.suspended) {
+    // don't count the time spent waiting towards the open calls
+    Clock::duration waited = now - thread.run_start;
+    for(auto& frame : thread.stack)
+      frame.start += waited;
+    thread.suspended = false;
+    thread.warned = false;
+    thread.run_start = now;
+  }
+
+  switch(type)
+  {
+    case 'c':
+    {
+      if(thread.stack.empty()) {
+        thread.run_start = now;
+        thread.warned = false;
+      }
+      Frame frame;
+      frame.script = sourcename ? sourcename : "(native)";
+      frame.function = frame.script + ":" + (funcname ? funcname : "(anonymous)");
+      frame.start = now;
+      thread.stack.push_back(frame);
+      m_functions[frame.function].calls += 1;
+      if(thread.stack.size() == 1)
+        m_scripts[frame.script].calls += 1;
+      break;
+    }
+
+    case 'r':
+    {
+      if(thread.stack.empty())
+        break;
+      const Frame& frame = thread.stack.back();
+      double time = seconds(now - frame.start);
+      Stats& stats = m_functions[frame.function];
+      stats.time += time;
+      stats.max_time = std::max(stats.max_time, time);
+      if(thread.stack.size() == 1) {
+        Stats& script = m_scripts[frame.script];
+        script.time += time;
+        script.max_time = std::max(script.max_time, time);
+      }
+      thread.stack.pop_back();
+      break;
+    }
+
+    case 'l':
+      if(!thread.stack.empty()) {
+        m_functions[thread.stack.back().function].lines += 1;
+        m_scripts[thread.stack.front().script].lines += 1;
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  if(thread.stack.empty()) {
+    m_threads.erase(vm);
+    return;
+  }
+
+  if(m_budget > 0 && !thread.warned && seconds(now - thread.run_start) > m_budget) {
+    thread.warned = true;
+    log_warning << "Script '" << thread.stack.front().script << "' has been running for "
+                << static_cast<int>(seconds(now - thread.run_start) * 1000) << " ms in "
+                << thread.stack.back().function << std::endl;
+  }
+}
+
+void
+ScriptProfiler::print_table(std::ostream& out, const std::map<std::string, Stats>& table) const
+{
+  std::vector<std::pair<std::string, Stats> > entries(table.begin(), table.end());
+  std::sort(entries.begin(), entries.end(),
+            [](const std::pair<std::string, Stats>& lhs, const std::pair<std::string, Stats>& rhs)
+            {
+              return lhs.second.time > rhs.second.time;
+            });
+  if(entries.size() > MAX_PRINTED)
+    entries.resize(MAX_PRINTED);
+
+  for(const auto& entry : entries) {
+    out << "  " << std::fixed << std::setprecision(2)
+        << std::setw(9) << entry.second.time * 1000 << " ms "
+        << std::setw(7) << entry.second.max_time * 1000 << " max "
+        << std::setw(6) << entry.second.calls << " calls "
+        << std::setw(8) << entry.second.lines << " lines  "
+        << entry.first << std::endl;
+  }
+}
+
+void
+ScriptProfiler::print_stats(std::ostream& out) const
+{
+  std::ios::fmtflags flags = out.flags();
+  out << "Scripts by time:" << std::endl;
+  print_table(out, m_scripts);
+  out << "Functions by time:" << std::endl;
+  print_table(out, m_functions);
+  out.flags(flags);
+}
+
+} // namespace scripting
+
+/* EOF */
@@ -0,0 +1,109 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HEADER_SUPERTUX_SCRIPTING_SCRIPT_PROFILER_HPP
+#define HEADER_SUPERTUX_SCRIPTING_SCRIPT_PROFILER_HPP
+
+#include <chrono>
+#include <map>
+#include <ostream>
+#include <squirrel.h>
+#include <string>
+#include <vector>
+
+#include "util/currenton.hpp"
+
+namespace scripting {
+
+/**
+ * Collects call counts and times of squirrel scripts and functions
+ * through the native debug hook. Threads created from the VM after the
+ * profiler inherit the hook.
+ */
+class ScriptProfiler : public Currenton<ScriptProfiler>
+{
+public:
+  ScriptProfiler(HSQUIRRELVM vm);
+  ~ScriptProfiler();
+
+  /** warn about threads that run longer than @c seconds without
+      waiting, 0 disables the warning */
+  void set_budget(float seconds);
+
+  /** @c vm waits, the time until it runs again isn't counted */
+  void suspend(HSQUIRRELVM vm);
+
+  void print_stats(std::ostream& out) const;
+  void reset();
+
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  struct Stats
+  {
+    Stats() : calls(0), lines(0), time(0), max_time(0) {}
+
+    int calls;
+    /** lines executed, only counted with debug info */
+    int lines;
+    double time;
+    double max_time;
+  };
+
+  struct Frame
+  {
+    std::string script;
+    std::string function;
+    Clock::time_point start;
+  };
+
+  struct Thread
+  {
+    Thread() : stack(), run_start(), suspended(false), warned(false) {}
+
+    std::vector<Frame> stack;
+    /** when the thread was started, resumed or suspended */
+    Clock::time_point run_start;
+    bool suspended;
+    bool warned;
+  };
+
+private:
+  static void debug_hook(HSQUIRRELVM vm, SQInteger type, const SQChar* sourcename,
+                         SQInteger line, const SQChar* funcname);
+
+  void on_event(HSQUIRRELVM vm, SQInteger type, const SQChar* sourcename,
+                const SQChar* funcname);
+  void print_table(std::ostream& out, const std::map<std::string, Stats>& table) const;
+
+private:
+  HSQUIRRELVM m_vm;
+  float m_budget;
+  std::map<std::string, Stats> m_scripts;
+  std::map<std::string, Stats> m_functions;
+  std::map<HSQUIRRELVM, Thread> m_threads;
+
+private:
+  ScriptProfiler(const ScriptProfiler&) = delete;
+  ScriptProfiler& operator=(const ScriptProfiler&) = delete;
+};
+
+} // namespace scripting
+
+#endif
+
+/* EOF */
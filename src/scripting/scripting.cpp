@@ -25,6 +25,7 @@
 #include <stdio.h>
 
 #include "physfs/ifile_stream.hpp"
+#include "scripting/script_profiler.hpp"
 #include "scripting/squirrel_error.hpp"
 #include "scripting/wrapper.hpp"
 #include "squirrel_util.hpp"
@@ -65,12 +66,17 @@ namespace scripting {
 
 HSQUIRRELVM global_vm = NULL;
 
-Scripting::Scripting(bool enable_debugger)
+Scripting::Scripting(bool enable_debugger, bool enable_profiler) :
+  m_profiler()
 {
   global_vm = sq_open(64);
   if(global_vm == NULL)
     throw std::runtime_error("Couldn't initialize squirrel vm");
 
+  if(enable_profiler) {
+    m_profiler.reset(new ScriptProfiler(global_vm));
+  }
+
   if(enable_debugger) {
 #ifdef ENABLE_SQDBG
     sq_enabledebuginfo(global_vm, SQTrue);
@@ -127,6 +133,8 @@ Scripting::~Scripting()
   }
 #endif
 
+  m_profiler.reset();
+
   if (global_vm)
     sq_close(global_vm);
 
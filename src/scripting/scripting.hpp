@@ -17,6 +17,7 @@
 #ifndef HEADER_SUPERTUX_SCRIPTING_SCRIPTING_HPP
 #define HEADER_SUPERTUX_SCRIPTING_SCRIPTING_HPP
 
+#include <memory>
 #include <squirrel.h>
 
 #include "util/currenton.hpp"
@@ -25,14 +26,19 @@ namespace scripting {
 
 extern HSQUIRRELVM global_vm;
 
+class ScriptProfiler;
+
 class Scripting : public Currenton<Scripting>
 {
 public:
-  Scripting(bool enable_debugger);
+  Scripting(bool enable_debugger, bool enable_profiler = false);
   ~Scripting();
 
   void update_debugger();
 
+private:
+  std::unique_ptr<ScriptProfiler> m_profiler;
+
 private:
   Scripting(const Scripting&) = delete;
   Scripting& operator=(const Scripting&) = delete;
@@ -16,9 +16,12 @@
 
 #include "scripting/serialize.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <sexp/value.hpp>
 #include <sexp/util.hpp>
+#include <stdint.h>
+#include <string.h>
 
 #include "util/log.hpp"
 #include "util/writer.hpp"
@@ -27,6 +30,209 @@
 
 namespace scripting {
 
+namespace {
+
+enum Tag
+{
+  TAG_END,
+  TAG_FALSE,
+  TAG_TRUE,
+  TAG_INTEGER,
+  TAG_FLOAT,
+  TAG_STRING,
+  TAG_TABLE
+};
+
+/** deeper tables are treated as corrupt data */
+const int max_depth = 64;
+
+void append_u32(std::string& out, uint32_t value)
+{
+  char bytes[4] = {
+    static_cast<char>(value & 0xff),
+    static_cast<char>((value >> 8) & 0xff),
+    static_cast<char>((value >> 16) & 0xff),
+    static_cast<char>((value >> 24) & 0xff)
+  };
+  out.append(bytes, sizeof(bytes));
+}
+
+void append_string(std::string& out, const char* text)
+{
+  size_t size = strlen(text);
+  append_u32(out, static_cast<uint32_t>(size));
+  out.append(text, size);
+}
+
+bool is_encodable(SQObjectType type)
+{
+  switch(type) {
+    case OT_INTEGER:
+    case OT_FLOAT:
+    case OT_BOOL:
+    case OT_STRING:
+    case OT_TABLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/** writes the tag, then @c key if given, then the value */
+void encode_value(HSQUIRRELVM vm, SQInteger idx, std::string& out, const char* key,
+                  const std::vector<std::string>& skip_keys)
+{
+  switch(sq_gettype(vm, idx)) {
+    case OT_INTEGER: {
+      SQInteger val;
+      sq_getinteger(vm, idx, &val);
+      out += static_cast<char>(TAG_INTEGER);
+      if(key) append_string(out, key);
+      append_u32(out, static_cast<uint32_t>(static_cast<int>(val)));
+      break;
+    }
+    case OT_FLOAT: {
+      SQFloat val;
+      sq_getfloat(vm, idx, &val);
+      float value = static_cast<float>(val);
+      uint32_t bits;
+      memcpy(&bits, &value, sizeof(bits));
+      out += static_cast<char>(TAG_FLOAT);
+      if(key) append_string(out, key);
+      append_u32(out, bits);
+      break;
+    }
+    case OT_BOOL: {
+      SQBool val = SQFalse;
+      sq_getbool(vm, idx, &val);
+      out += static_cast<char>(val == SQTrue ? TAG_TRUE : TAG_FALSE);
+      if(key) append_string(out, key);
+      break;
+    }
+    case OT_STRING: {
+      const SQChar* str;
+      sq_getstring(vm, idx, &str);
+      out += static_cast<char>(TAG_STRING);
+      if(key) append_string(out, key);
+      append_string(out, reinterpret_cast<const char*>(str));
+      break;
+    }
+    case OT_TABLE: {
+      out += static_cast<char>(TAG_TABLE);
+      if(key) append_string(out, key);
+
+      // offset because of sq_pushnull
+      SQInteger table_idx = idx < 0 ? idx - 1 : idx;
+      sq_pushnull(vm);
+      while(SQ_SUCCEEDED(sq_next(vm, table_idx))) {
+        if(sq_gettype(vm, -2) == OT_STRING && is_encodable(sq_gettype(vm, -1))) {
+          const SQChar* entry_key;
+          sq_getstring(vm, -2, &entry_key);
+          if(std::find(skip_keys.begin(), skip_keys.end(), entry_key) == skip_keys.end()) {
+            encode_value(vm, -1, out, entry_key, std::vector<std::string>());
+          }
+        }
+        sq_pop(vm, 2);
+      }
+      sq_pop(vm, 1);
+      out += static_cast<char>(TAG_END);
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+class Decoder
+{
+public:
+  Decoder(const char* data, size_t size, size_t& pos) :
+    m_data(data),
+    m_size(size),
+    m_pos(pos)
+  {}
+
+  uint8_t read_u8()
+  {
+    need(1);
+    return static_cast<uint8_t>(m_data[m_pos++]);
+  }
+
+  uint32_t read_u32()
+  {
+    need(4);
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(m_data + m_pos);
+    m_pos += 4;
+    return static_cast<uint32_t>(p[0]) |
+      (static_cast<uint32_t>(p[1]) << 8) |
+      (static_cast<uint32_t>(p[2]) << 16) |
+      (static_cast<uint32_t>(p[3]) << 24);
+  }
+
+  void push_string(HSQUIRRELVM vm)
+  {
+    uint32_t size = read_u32();
+    need(size);
+    sq_pushstring(vm, m_data + m_pos, size);
+    m_pos += size;
+  }
+
+  void push_value(HSQUIRRELVM vm, uint8_t tag, int depth)
+  {
+    switch(tag) {
+      case TAG_FALSE:
+      case TAG_TRUE:
+        sq_pushbool(vm, tag == TAG_TRUE ? SQTrue : SQFalse);
+        break;
+      case TAG_INTEGER:
+        sq_pushinteger(vm, static_cast<int32_t>(read_u32()));
+        break;
+      case TAG_FLOAT: {
+        uint32_t bits = read_u32();
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        sq_pushfloat(vm, value);
+        break;
+      }
+      case TAG_STRING:
+        push_string(vm);
+        break;
+      case TAG_TABLE: {
+        if(depth >= max_depth)
+          throw std::runtime_error("Encoded squirrel table is nested too deep");
+        sq_newtable(vm);
+        for(uint8_t entry_tag = read_u8(); entry_tag != TAG_END; entry_tag = read_u8()) {
+          push_string(vm);
+          push_value(vm, entry_tag, depth + 1);
+          if(SQ_FAILED(sq_createslot(vm, -3)))
+            throw scripting::SquirrelError(vm, "Couldn't create new index");
+        }
+        break;
+      }
+      default:
+        throw std::runtime_error("Unknown tag in encoded squirrel value");
+    }
+  }
+
+private:
+  void need(size_t count) const
+  {
+    if(m_size - m_pos < count)
+      throw std::runtime_error("Encoded squirrel value is truncated");
+  }
+
+private:
+  const char* m_data;
+  size_t m_size;
+  size_t& m_pos;
+
+private:
+  Decoder(const Decoder&) = delete;
+  Decoder& operator=(const Decoder&) = delete;
+};
+
+} // namespace
+
 void load_squirrel_table(HSQUIRRELVM vm, SQInteger table_idx, const ReaderMapping& lisp)
 {
   if(table_idx < 0)
@@ -148,6 +354,25 @@ void save_squirrel_table(HSQUIRRELVM vm, SQInteger table_idx, Writer& writer)
   sq_pop(vm, 1);
 }
 
+bool encode_squirrel_value(HSQUIRRELVM vm, SQInteger idx, std::string& out,
+                           const std::vector<std::string>& skip_keys)
+{
+  if(!is_encodable(sq_gettype(vm, idx)))
+    return false;
+
+  encode_value(vm, idx, out, NULL, skip_keys);
+  return true;
+}
+
+void decode_squirrel_value(HSQUIRRELVM vm, const char* data, size_t size, size_t& pos)
+{
+  if(pos > size)
+    throw std::runtime_error("Encoded squirrel value is truncated");
+
+  Decoder decoder(data, size, pos);
+  decoder.push_value(vm, decoder.read_u8(), 0);
+}
+
 } // namespace scripting
 
 /* EOF */
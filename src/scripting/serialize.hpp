@@ -18,6 +18,9 @@
 #define HEADER_SUPERTUX_SCRIPTING_SERIALIZE_HPP
 
 #include <squirrel.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
 
 #include "util/reader_fwd.hpp"
 
@@ -28,6 +31,18 @@ namespace scripting {
 void save_squirrel_table(HSQUIRRELVM vm, SQInteger table_idx, Writer& writer);
 void load_squirrel_table(HSQUIRRELVM vm, SQInteger table_idx, const ReaderMapping& lisp);
 
+/** Appends a compact binary encoding of the value at @c idx to @c out.
+    Like save_squirrel_table(), table entries with non-string keys or
+    values that can't be saved (closures, ...) are left out, as are
+    the entries of a top-level table named in @c skip_keys. Returns
+    false and appends nothing if the value itself can't be saved. */
+bool encode_squirrel_value(HSQUIRRELVM vm, SQInteger idx, std::string& out,
+                           const std::vector<std::string>& skip_keys = std::vector<std::string>());
+
+/** Pushes the value encoded at @c pos in @c data and moves @c pos
+    behind it, throws std::runtime_error on truncated or corrupt data */
+void decode_squirrel_value(HSQUIRRELVM vm, const char* data, size_t size, size_t& pos);
+
 } // namespace scripting
 
 #endif
@@ -18,6 +18,7 @@
 
 #include <config.h>
 
+#include <iterator>
 #include <stdio.h>
 #include <sqstdaux.h>
 #include <sqstdblob.h>
@@ -25,6 +26,7 @@
 #include <sqstdstring.h>
 #include <stdarg.h>
 
+#include "scripting/closure_cache.hpp"
 #include "supertux/game_object.hpp"
 #include "supertux/script_interface.hpp"
 #include "util/log.hpp"
@@ -223,6 +225,14 @@ SQInteger squirrel_read_char(SQUserPointer file)
   return c;
 }
 
+SQInteger squirrel_read_buffer_char(SQUserPointer buffer)
+{
+  SquirrelScriptBuffer* script = reinterpret_cast<SquirrelScriptBuffer*> (buffer);
+  if(script->pos == script->end)
+    return 0;
+  return static_cast<unsigned char>(*script->pos++);
+}
+
 void try_expose(const GameObjectPtr& object, const HSQOBJECT& table)
 {
   auto object_ = dynamic_cast<ScriptInterface*>(object.get());
@@ -250,8 +260,9 @@ void try_unexpose(const GameObjectPtr& object, const HSQOBJECT& table)
   }
 }
 
-HSQUIRRELVM run_script(std::istream& in, const std::string& sourcename,
-                       ScriptList& scripts, const HSQOBJECT* root_table)
+namespace {
+
+HSQUIRRELVM create_script_thread(ScriptList& scripts, const HSQOBJECT* root_table)
 {
     // garbage collect thread list
     for(auto i = scripts.begin(); i != scripts.end(); ) {
@@ -279,14 +290,43 @@ HSQUIRRELVM run_script(std::istream& in, const std::string& sourcename,
       sq_setroottable(vm);
     }
 
-    compile_and_run(vm, in, sourcename);
-
     return vm;
 }
 
+} // namespace
+
+HSQUIRRELVM run_script(std::istream& in, const std::string& sourcename,
+                       ScriptList& scripts, const HSQOBJECT* root_table)
+{
+  HSQUIRRELVM vm = create_script_thread(scripts, root_table);
+  compile_and_run(vm, in, sourcename);
+  return vm;
+}
+
+HSQUIRRELVM run_script(const std::string& source, const std::string& sourcename,
+                       ScriptList& scripts, const HSQOBJECT* root_table,
+                       ClosureCache& closures)
+{
+  HSQUIRRELVM vm = create_script_thread(scripts, root_table);
+  closures.push(vm, source, sourcename);
+  run_closure(vm);
+  return vm;
+}
+
 void compile_script(HSQUIRRELVM vm, std::istream& in, const std::string& sourcename)
 {
-  if(SQ_FAILED(sq_compile(vm, squirrel_read_char, &in, sourcename.c_str(), true)))
+  // pull the whole source in one go instead of a virtual get() per
+  // character while the compiler runs
+  std::string source((std::istreambuf_iterator<char>(in)),
+                     std::istreambuf_iterator<char>());
+  compile_script(vm, source.data(), source.size(), sourcename);
+}
+
+void compile_script(HSQUIRRELVM vm, const char* data, size_t size,
+                    const std::string& sourcename)
+{
+  SquirrelScriptBuffer buffer = { data, data + size };
+  if(SQ_FAILED(sq_compile(vm, squirrel_read_buffer_char, &buffer, sourcename.c_str(), true)))
     throw SquirrelError(vm, "Couldn't parse script");
 }
 
@@ -294,7 +334,11 @@ void compile_and_run(HSQUIRRELVM vm, std::istream& in,
                      const std::string& sourcename)
 {
   compile_script(vm, in, sourcename);
+  run_closure(vm);
+}
 
+void run_closure(HSQUIRRELVM vm)
+{
   SQInteger oldtop = sq_gettop(vm);
 
   try {
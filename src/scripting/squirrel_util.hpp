@@ -30,6 +30,8 @@ class GameObject;
 
 namespace scripting {
 
+class ClosureCache;
+
 typedef std::vector<HSQOBJECT> ScriptList;
 
 std::string squirrel2string(HSQUIRRELVM vm, SQInteger i);
@@ -37,6 +39,16 @@ void print_squirrel_stack(HSQUIRRELVM vm);
 
 SQInteger squirrel_read_char(SQUserPointer file);
 
+/** Read position for squirrel_read_buffer_char(), the script source
+    has to stay alive while it is compiled */
+struct SquirrelScriptBuffer
+{
+  const char* pos;
+  const char* end;
+};
+
+SQInteger squirrel_read_buffer_char(SQUserPointer buffer);
+
 HSQOBJECT create_thread(HSQUIRRELVM vm);
 SQObject vm_to_object(HSQUIRRELVM vm);
 HSQUIRRELVM object_to_vm(HSQOBJECT object);
@@ -46,11 +58,20 @@ void try_unexpose(const GameObjectPtr& object, const HSQOBJECT& table);
 
 HSQUIRRELVM run_script(std::istream& in, const std::string& sourcename,
                        ScriptList& scripts, const HSQOBJECT* root_table);
+/** Runs @c source in a new thread, compiled only the first time it is
+    run with @c closures */
+HSQUIRRELVM run_script(const std::string& source, const std::string& sourcename,
+                       ScriptList& scripts, const HSQOBJECT* root_table,
+                       ClosureCache& closures);
 
 void compile_script(HSQUIRRELVM vm, std::istream& in,
                     const std::string& sourcename);
+void compile_script(HSQUIRRELVM vm, const char* data, size_t size,
+                    const std::string& sourcename);
 void compile_and_run(HSQUIRRELVM vm, std::istream& in,
                      const std::string& sourcename);
+/** Calls the closure on top of the stack with the root table as this */
+void run_closure(HSQUIRRELVM vm);
 
 /**
  * Deletes the provided scripts from memory, freeing any resources
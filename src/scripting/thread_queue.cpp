@@ -16,6 +16,7 @@
 
 #include "scripting/thread_queue.hpp"
 
+#include "scripting/script_profiler.hpp"
 #include "scripting/scripting.hpp"
 #include "scripting/squirrel_util.hpp"
 #include "util/log.hpp"
@@ -31,6 +32,9 @@ ThreadQueue::ThreadQueue() :
 void
 ThreadQueue::add(HSQUIRRELVM vm)
 {
+  if(ScriptProfiler::current())
+    ScriptProfiler::current()->suspend(vm);
+
   // create a weakref to the VM
   HSQOBJECT vm_obj = vm_to_object(vm);
   sq_pushobject(global_vm, vm_obj);
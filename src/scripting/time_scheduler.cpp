@@ -15,7 +15,9 @@
 //  along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <algorithm>
+#include <chrono>
 
+#include "scripting/script_profiler.hpp"
 #include "scripting/scripting.hpp"
 #include "scripting/squirrel_util.hpp"
 #include "scripting/time_scheduler.hpp"
@@ -26,14 +28,30 @@ namespace scripting {
 TimeScheduler* TimeScheduler::instance = NULL;
 
 TimeScheduler::TimeScheduler() :
-  schedule()
+  schedule(),
+  m_budget(0),
+  m_deferred(0)
 {
 }
 
+void
+TimeScheduler::set_budget(float seconds)
+{
+  m_budget = seconds;
+}
+
 void
 TimeScheduler::update(float time)
 {
+  auto start = std::chrono::steady_clock::now();
   while(!schedule.empty() && schedule.front().wakeup_time < time) {
+    if(m_budget > 0 &&
+       std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count() > m_budget) {
+      // the entries stay due and come first next frame
+      m_deferred += 1;
+      break;
+    }
+
     HSQOBJECT thread_ref = schedule.front().thread_ref;
 
     sq_pushobject(global_vm, thread_ref);
@@ -69,6 +87,9 @@ TimeScheduler::update(float time)
 void
 TimeScheduler::schedule_thread(HSQUIRRELVM scheduled_vm, float time)
 {
+  if(ScriptProfiler::current())
+    ScriptProfiler::current()->suspend(scheduled_vm);
+
   // create a weakref to the VM
   SQObject vm_obj = vm_to_object(scheduled_vm);
   sq_pushobject(global_vm, vm_obj);
@@ -33,6 +33,14 @@ public:
   void update(float time);
   void schedule_thread(HSQUIRRELVM vm, float time);
 
+  /** Stop waking threads in an update once they took @c seconds of
+      real time, the rest are woken first in the next update. 0 wakes
+      all due threads. */
+  void set_budget(float seconds);
+
+  /** number of wakeups that were moved to a later update */
+  int get_deferred_count() const { return m_deferred; }
+
   static TimeScheduler* instance;
 
 private:
@@ -51,6 +59,9 @@ private:
 
   typedef std::vector<ScheduleEntry> ScheduleHeap;
   ScheduleHeap schedule;
+
+  float m_budget;
+  int m_deferred;
 };
 
 }
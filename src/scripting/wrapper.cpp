@@ -5023,6 +5023,29 @@ static SQInteger load_state_wrapper(HSQUIRRELVM vm)
 
 }
 
+static SQInteger export_savegame_wrapper(HSQUIRRELVM vm)
+{
+  const SQChar* arg0;
+  if(SQ_FAILED(sq_getstring(vm, 2, &arg0))) {
+    sq_throwerror(vm, _SC("Argument 1 not a string"));
+    return SQ_ERROR;
+  }
+
+  try {
+    scripting::export_savegame(arg0);
+
+    return 0;
+
+  } catch(std::exception& e) {
+    sq_throwerror(vm, e.what());
+    return SQ_ERROR;
+  } catch(...) {
+    sq_throwerror(vm, _SC("Unexpected exception while executing function 'export_savegame'"));
+    return SQ_ERROR;
+  }
+
+}
+
 static SQInteger debug_collrects_wrapper(HSQUIRRELVM vm)
 {
   SQBool arg0;
@@ -5138,6 +5161,82 @@ static SQInteger debug_worldmap_ghost_wrapper(HSQUIRRELVM vm)
 
 }
 
+static SQInteger debug_texture_stats_wrapper(HSQUIRRELVM vm)
+{
+  (void) vm;
+
+  try {
+    scripting::debug_texture_stats();
+
+    return 0;
+
+  } catch(std::exception& e) {
+    sq_throwerror(vm, e.what());
+    return SQ_ERROR;
+  } catch(...) {
+    sq_throwerror(vm, _SC("Unexpected exception while executing function 'debug_texture_stats'"));
+    return SQ_ERROR;
+  }
+
+}
+
+static SQInteger debug_sound_stats_wrapper(HSQUIRRELVM vm)
+{
+  (void) vm;
+
+  try {
+    scripting::debug_sound_stats();
+
+    return 0;
+
+  } catch(std::exception& e) {
+    sq_throwerror(vm, e.what());
+    return SQ_ERROR;
+  } catch(...) {
+    sq_throwerror(vm, _SC("Unexpected exception while executing function 'debug_sound_stats'"));
+    return SQ_ERROR;
+  }
+
+}
+
+static SQInteger debug_script_stats_wrapper(HSQUIRRELVM vm)
+{
+  (void) vm;
+
+  try {
+    scripting::debug_script_stats();
+
+    return 0;
+
+  } catch(std::exception& e) {
+    sq_throwerror(vm, e.what());
+    return SQ_ERROR;
+  } catch(...) {
+    sq_throwerror(vm, _SC("Unexpected exception while executing function 'debug_script_stats'"));
+    return SQ_ERROR;
+  }
+
+}
+
+static SQInteger debug_script_profile_wrapper(HSQUIRRELVM vm)
+{
+  (void) vm;
+
+  try {
+    scripting::debug_script_profile();
+
+    return 0;
+
+  } catch(std::exception& e) {
+    sq_throwerror(vm, e.what());
+    return SQ_ERROR;
+  } catch(...) {
+    sq_throwerror(vm, _SC("Unexpected exception while executing function 'debug_script_profile'"));
+    return SQ_ERROR;
+  }
+
+}
+
 static SQInteger play_music_wrapper(HSQUIRRELVM vm)
 {
   const SQChar* arg0;
@@ -6332,6 +6431,13 @@ void register_supertux_wrapper(HSQUIRRELVM v)
     throw SquirrelError(v, "Couldn't register function 'load_state'");
   }
 
+  sq_pushstring(v, "export_savegame", -1);
+  sq_newclosure(v, &export_savegame_wrapper, 0);
+  sq_setparamscheck(v, SQ_MATCHTYPEMASKSTRING, "x|ts");
+  if(SQ_FAILED(sq_createslot(v, -3))) {
+    throw SquirrelError(v, "Couldn't register function 'export_savegame'");
+  }
+
   sq_pushstring(v, "debug_collrects", -1);
   sq_newclosure(v, &debug_collrects_wrapper, 0);
   sq_setparamscheck(v, SQ_MATCHTYPEMASKSTRING, "x|tb");
@@ -6367,6 +6473,34 @@ void register_supertux_wrapper(HSQUIRRELVM v)
     throw SquirrelError(v, "Couldn't register function 'debug_worldmap_ghost'");
   }
 
+  sq_pushstring(v, "debug_texture_stats", -1);
+  sq_newclosure(v, &debug_texture_stats_wrapper, 0);
+  sq_setparamscheck(v, SQ_MATCHTYPEMASKSTRING, "x|t");
+  if(SQ_FAILED(sq_createslot(v, -3))) {
+    throw SquirrelError(v, "Couldn't register function 'debug_texture_stats'");
+  }
+
+  sq_pushstring(v, "debug_sound_stats", -1);
+  sq_newclosure(v, &debug_sound_stats_wrapper, 0);
+  sq_setparamscheck(v, SQ_MATCHTYPEMASKSTRING, "x|t");
+  if(SQ_FAILED(sq_createslot(v, -3))) {
+    throw SquirrelError(v, "Couldn't register function 'debug_sound_stats'");
+  }
+
+  sq_pushstring(v, "debug_script_stats", -1);
+  sq_newclosure(v, &debug_script_stats_wrapper, 0);
+  sq_setparamscheck(v, SQ_MATCHTYPEMASKSTRING, "x|t");
+  if(SQ_FAILED(sq_createslot(v, -3))) {
+    throw SquirrelError(v, "Couldn't register function 'debug_script_stats'");
+  }
+
+  sq_pushstring(v, "debug_script_profile", -1);
+  sq_newclosure(v, &debug_script_profile_wrapper, 0);
+  sq_setparamscheck(v, SQ_MATCHTYPEMASKSTRING, "x|t");
+  if(SQ_FAILED(sq_createslot(v, -3))) {
+    throw SquirrelError(v, "Couldn't register function 'debug_script_profile'");
+  }
+
   sq_pushstring(v, "play_music", -1);
   sq_newclosure(v, &play_music_wrapper, 0);
   sq_setparamscheck(v, SQ_MATCHTYPEMASKSTRING, "x|ts");
@@ -17,10 +17,12 @@
 #include "sprite/sprite_data.hpp"
 
 #include <algorithm>
+#include <set>
 #include <stdexcept>
 #include <sstream>
 
 #include "util/log.hpp"
+#include "video/texture_manager.hpp"
 #include "util/reader_mapping.hpp"
 
 SpriteData::Action::Action() :
@@ -41,12 +43,37 @@ SpriteData::SpriteData(const ReaderMapping& lisp, const std::string& basedir) :
   actions(),
   name()
 {
+  // collect the frames of all actions first, they are decoded on the
+  // worker threads and packed into shared atlas pages
+  std::vector<std::string> files;
+  std::set<std::string> seen;
+  auto prescan = lisp.get_iter();
+  while(prescan.next()) {
+    if(prescan.get_key() == "action") {
+      std::vector<std::string> images;
+      if(prescan.as_mapping().get("images", images)) {
+        for(const auto& image : images) {
+          if(seen.insert(basedir + image).second) {
+            files.push_back(basedir + image);
+          }
+        }
+      }
+    }
+  }
+  TextureManager::current()->prefetch(files);
+
+  Frames frames;
+  auto surfaces = TextureManager::current()->create_atlas(files);
+  for(size_t i = 0; i < files.size(); ++i) {
+    frames[files[i]] = surfaces[i];
+  }
+
   auto iter = lisp.get_iter();
   while(iter.next()) {
     if(iter.get_key() == "name") {
       iter.get(name);
     } else if(iter.get_key() == "action") {
-      parse_action(iter.as_mapping(), basedir);
+      parse_action(iter.as_mapping(), basedir, frames);
     } else {
       log_warning << "Unknown sprite field: " << iter.get_key() << std::endl;
     }
@@ -56,7 +83,8 @@ SpriteData::SpriteData(const ReaderMapping& lisp, const std::string& basedir) :
 }
 
 void
-SpriteData::parse_action(const ReaderMapping& lisp, const std::string& basedir)
+SpriteData::parse_action(const ReaderMapping& lisp, const std::string& basedir,
+                         const Frames& frames)
 {
   auto action = std::unique_ptr<Action>(new Action);
 
@@ -122,7 +150,8 @@ SpriteData::parse_action(const ReaderMapping& lisp, const std::string& basedir)
       float max_w = 0;
       float max_h = 0;
       for(const auto& image : images) {
-        auto surface = Surface::create(basedir + image);
+        auto frame = frames.find(basedir + image);
+        auto surface = frame != frames.end() ? frame->second : Surface::create(basedir + image);
         max_w = std::max(max_w, (float) surface->get_width());
         max_h = std::max(max_h, (float) surface->get_height());
         action->surfaces.push_back(surface);
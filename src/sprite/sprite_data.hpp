@@ -72,7 +72,11 @@ private:
 
   typedef std::map <std::string, std::unique_ptr<Action> > Actions;
 
-  void parse_action(const ReaderMapping& lispreader, const std::string& basedir);
+  /** frame surfaces on the atlas pages of this sprite, by filename */
+  typedef std::map<std::string, SurfacePtr> Frames;
+
+  void parse_action(const ReaderMapping& lispreader, const std::string& basedir,
+                    const Frames& frames);
   /** Get an action */
   const Action* get_action(const std::string& act) const;
 
@@ -0,0 +1,64 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sexp/parser.hpp>
+#include <stdexcept>
+#include <string>
+
+#include "util/binary_sexp.hpp"
+
+/** Compiles a .stl level into the binary .stlb format that
+    LevelParser prefers over the .stl it was compiled from */
+int main(int argc, char** argv)
+{
+  if (argc != 3)
+  {
+    std::cerr << "Usage: " << argv[0] << " INPUT.stl OUTPUT.stlb" << std::endl;
+    return 1;
+  }
+
+  try
+  {
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in)
+    {
+      throw std::runtime_error("couldn't open input file");
+    }
+    std::string text((std::istreambuf_iterator<char>(in)),
+                     std::istreambuf_iterator<char>());
+    sexp::Value sx = sexp::Parser::from_string(text, sexp::Parser::USE_ARRAYS);
+
+    std::ofstream out(argv[2], std::ios::binary);
+    BinarySexp::write(out, sx, BinarySexp::source_stamp(text.data(), text.size()));
+    out.close();
+    if (!out)
+    {
+      throw std::runtime_error("couldn't write output file");
+    }
+  }
+  catch(const std::exception& err)
+  {
+    std::cerr << argv[1] << ": " << err.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+/* EOF */
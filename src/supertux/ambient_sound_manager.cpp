@@ -0,0 +1,63 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "supertux/ambient_sound_manager.hpp"
+
+#include <algorithm>
+
+#include "math/vector.hpp"
+#include "object/ambient_sound.hpp"
+
+const float AmbientSoundManager::UPDATE_INTERVAL = 0.05f;
+
+AmbientSoundManager::AmbientSoundManager() :
+  m_sounds(),
+  m_time(0)
+{
+}
+
+void
+AmbientSoundManager::add(AmbientSound* sound)
+{
+  m_sounds.push_back(sound);
+}
+
+void
+AmbientSoundManager::remove(AmbientSound* sound)
+{
+  m_sounds.erase(std::remove(m_sounds.begin(), m_sounds.end(), sound), m_sounds.end());
+}
+
+void
+AmbientSoundManager::update(float elapsed_time, const Vector& listener)
+{
+  m_time += elapsed_time;
+  if(m_time < UPDATE_INTERVAL)
+    return;
+  // don't try to catch up after a hiccup
+  m_time = std::min(m_time - UPDATE_INTERVAL, UPDATE_INTERVAL);
+
+  for(const auto& sound : m_sounds) {
+    float sqrdistance = sound->get_square_distance(listener);
+    if(!sound->is_playing() && sqrdistance >= sound->get_silence_distance())
+      continue;
+
+    sound->update_volume(sqrdistance);
+  }
+}
+
+/* EOF */
@@ -0,0 +1,56 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HEADER_SUPERTUX_SUPERTUX_AMBIENT_SOUND_MANAGER_HPP
+#define HEADER_SUPERTUX_SUPERTUX_AMBIENT_SOUND_MANAGER_HPP
+
+#include <vector>
+
+class AmbientSound;
+class Vector;
+
+/** Updates the volume of all AmbientSounds of a sector in one pass at
+    a fixed rate, instead of every object on its own every frame.
+    Sounds that are silent at the listener's position are skipped
+    without touching OpenAL. */
+class AmbientSoundManager
+{
+public:
+  /** seconds between two volume updates */
+  static const float UPDATE_INTERVAL;
+
+public:
+  AmbientSoundManager();
+
+  void add(AmbientSound* sound);
+  void remove(AmbientSound* sound);
+
+  /** @param listener  the camera center */
+  void update(float elapsed_time, const Vector& listener);
+
+private:
+  std::vector<AmbientSound*> m_sounds;
+  float m_time;
+
+private:
+  AmbientSoundManager(const AmbientSoundManager&) = delete;
+  AmbientSoundManager& operator=(const AmbientSoundManager&) = delete;
+};
+
+#endif
+
+/* EOF */
@@ -45,8 +45,11 @@ CommandLineArguments::CommandLineArguments() :
   music_enabled(),
   start_level(),
   enable_script_debugger(),
+  enable_script_profiler(),
+  script_budget(),
   start_demo(),
   record_demo(),
+  audio_sink(),
   tux_spawn_pos(),
   developer_mode(),
   christmas_mode(),
@@ -97,10 +100,13 @@ CommandLineArguments::print_help(const char* arg0) const
             << _(     "  --no-show-pos                Do not display player's position") << "\n"
             << _(     "  --developer                  Switch on developer feature") << "\n"
             << _(     "  -s, --debug-scripts          Enable script debugger.") << "\n"
+            << _(     "  --profile-scripts            Count calls and time of script functions") << "\n"
+            << _(     "  --script-budget MS           Spend at most MS milliseconds per frame waking scripts") << "\n"
             << _(     "  --spawn-pos X,Y              Where in the level to spawn Tux. Only used if level is specified.") << "\n" << "\n"
             << _(     "Demo Recording Options:") << "\n"
             << _(     "  --record-demo FILE LEVEL     Record a demo to FILE") << "\n"
-            << _(     "  --play-demo FILE LEVEL       Play a recorded demo") << "\n" << "\n"
+            << _(     "  --play-demo FILE LEVEL       Play a recorded demo") << "\n"
+            << _(     "  --audio-sink FILE            Mix audio in software into the WAV file FILE") << "\n" << "\n"
             << _(     "Directory Options:") << "\n"
             << _(     "  --datadir DIR                Set the directory for the games datafiles") << "\n"
             << _(     "  --userdir DIR                Set the directory for user data (savegames, etc.)") << "\n" << "\n"
@@ -318,6 +324,17 @@ CommandLineArguments::parse_args(int argc, char** argv)
         record_demo = argv[++i];
       }
     }
+    else if (arg == "--audio-sink")
+    {
+      if (i + 1 >= argc)
+      {
+        throw std::runtime_error("Need to specify a WAV filename");
+      }
+      else
+      {
+        audio_sink = argv[++i];
+      }
+    }
     else if (arg == "--spawn-pos") 
     {
       Vector spawn_pos;
@@ -342,6 +359,19 @@ CommandLineArguments::parse_args(int argc, char** argv)
     {
       enable_script_debugger = true;
     }
+    else if (arg == "--profile-scripts")
+    {
+      enable_script_profiler = true;
+    }
+    else if (arg == "--script-budget")
+    {
+      int budget;
+      if (i + 1 >= argc)
+        throw std::runtime_error("Need to specify a budget in milliseconds");
+      else if (sscanf(argv[++i], "%9d", &budget) != 1 || budget < 0)
+        throw std::runtime_error("Invalid script budget, should be milliseconds");
+      script_budget = budget;
+    }
     else if (arg == "--repository-url")
     {
       if (i + 1 >= argc)
@@ -392,8 +422,11 @@ CommandLineArguments::merge_into(Config& config)
   merge_option(music_enabled);
   merge_option(start_level);
   merge_option(enable_script_debugger);
+  merge_option(enable_script_profiler);
+  merge_option(script_budget);
   merge_option(start_demo);
   merge_option(record_demo);
+  merge_option(audio_sink);
   merge_option(tux_spawn_pos);
   merge_option(developer_mode);
   merge_option(christmas_mode);
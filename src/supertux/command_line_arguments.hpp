@@ -66,8 +66,11 @@ public:
 
   boost::optional<std::string> start_level;
   boost::optional<bool> enable_script_debugger;
+  boost::optional<bool> enable_script_profiler;
+  boost::optional<int> script_budget;
   boost::optional<std::string> start_demo;
   boost::optional<std::string> record_demo;
+  boost::optional<std::string> audio_sink;
   boost::optional<Vector> tux_spawn_pos;
 
   boost::optional<bool> developer_mode;
@@ -31,7 +31,10 @@ static const float FADE_SPEED = 1;
 
 ConsoleBuffer::ConsoleBuffer() :
   m_lines(),
-  m_console(nullptr)
+  m_console(nullptr),
+  m_main_thread(std::this_thread::get_id()),
+  m_pending_mutex(),
+  m_pending()
 {
 }
 
@@ -87,6 +90,24 @@ ConsoleBuffer::addLine(const std::string& s_)
 void
 ConsoleBuffer::flush(ConsoleStreamBuffer& buffer)
 {
+  if (!is_main_thread())
+  {
+    // a buffer of another thread, leave the lines to flush_pending()
+    std::string s = buffer.str();
+    if ((s.length() > 0) && ((s[s.length()-1] == '\n') || (s[s.length()-1] == '\r')))
+    {
+      while ((s.length() > 0) && ((s[s.length()-1] == '\n') || (s[s.length()-1] == '\r')))
+      {
+        s.erase(s.length()-1);
+      }
+      std::lock_guard<std::mutex> lock(m_pending_mutex);
+      m_pending.push_back(s);
+      buffer.str(std::string());
+    }
+    return;
+  }
+
+  flush_pending();
   if (&buffer == &s_outputBuffer)
   {
     std::string s = s_outputBuffer.str();
@@ -102,6 +123,21 @@ ConsoleBuffer::flush(ConsoleStreamBuffer& buffer)
   }
 }
 
+void
+ConsoleBuffer::flush_pending()
+{
+  std::vector<std::string> pending;
+  {
+    std::lock_guard<std::mutex> lock(m_pending_mutex);
+    pending.swap(m_pending);
+  }
+
+  for (const auto& lines : pending)
+  {
+    addLines(lines);
+  }
+}
+
 Console::Console(ConsoleBuffer& buffer) :
   m_buffer(buffer),
   m_inputBuffer(),
@@ -502,6 +538,8 @@ Console::toggle()
 void
 Console::update(float elapsed_time)
 {
+  m_buffer.flush_pending();
+
   if(m_stayOpen > 0) {
     m_stayOpen -= elapsed_time;
     if(m_stayOpen < 0)
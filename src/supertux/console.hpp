@@ -19,8 +19,10 @@
 
 #include <list>
 #include <memory>
+#include <mutex>
 #include <squirrel.h>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 #include "util/currenton.hpp"
@@ -48,9 +50,19 @@ public:
   void addLine(const std::string& s); /**< display a line in the console */
 
   void flush(ConsoleStreamBuffer& buffer); /**< act upon changes in a ConsoleStreamBuffer */
+  void flush_pending(); /**< add the lines other threads logged since the last call, main thread only */
+
+  /** true on the thread that created the ConsoleBuffer, other threads
+      must not touch the console and log into their own buffer */
+  bool is_main_thread() const { return std::this_thread::get_id() == m_main_thread; }
 
   void set_console(Console* console);
 
+private:
+  std::thread::id m_main_thread;
+  std::mutex m_pending_mutex;
+  std::vector<std::string> m_pending; /**< lines logged by other threads */
+
 private:
   ConsoleBuffer(const ConsoleBuffer&) = delete;
   ConsoleBuffer& operator=(const ConsoleBuffer&) = delete;
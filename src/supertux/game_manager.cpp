@@ -120,7 +120,7 @@ GameManager::get_level_name(const std::string& filename) const
   try
   {
     register_translation_directory(filename);
-    auto doc = ReaderDocument::parse(filename);
+    auto doc = ReaderDocument::parse_header(filename, "sector");
     auto root = doc.get_root();
 
     if(root.get_name() != "supertux-level") {
@@ -46,6 +46,7 @@
 #include "supertux/sector.hpp"
 #include "util/file_system.hpp"
 #include "util/gettext.hpp"
+#include "video/texture_manager.hpp"
 #include "worldmap/worldmap.hpp"
 
 #ifdef WIN32
@@ -84,6 +85,13 @@ GameSession::GameSession(const std::string& levelfile_, Savegame& savegame, Stat
     throw std::runtime_error ("Initializing the level failed.");
 }
 
+GameSession::~GameSession()
+{
+  // images prefetched for this level that were never used
+  TextureManager::current()->release_surfaces();
+  SoundManager::current()->end_preload_manifest();
+}
+
 void
 GameSession::reset_level()
 {
@@ -124,12 +132,19 @@ GameSession::restart_level(bool after_death)
 
   try {
     old_level = std::move(level);
+    SoundManager::current()->begin_preload_manifest(levelfile);
+    // herring music is switched on and off a lot, keep it decoded
+    SoundManager::current()->preload_music(HERRING_MUSIC_FILE);
     level = LevelParser::from_file(levelfile);
     level->stats.total_coins = level->get_total_coins();
     level->stats.total_badguys = level->get_total_badguys();
     level->stats.total_secrets = level->get_total_secrets();
     level->stats.reset();
 
+    // all tiles of the level have been loaded, their source images are
+    // not needed anymore
+    TextureManager::current()->release_surfaces();
+
     if(!reset_sector.empty()) {
       currentsector = level->get_sector(reset_sector);
       if(!currentsector) {
@@ -34,6 +34,9 @@ Config::Config() :
   window_size(1280, 800),
   aspect_size(0, 0), // auto detect
   magnification(0.0f),
+  texture_cache_size(64),
+  surface_cache_size(32),
+  image_cache(true),
   use_fullscreen(false),
   video(VideoSystem::AUTO_VIDEO),
   try_vsync(true),
@@ -44,8 +47,11 @@ Config::Config() :
   random_seed(0), // set by time(), by default (unless in config)
   start_level(),
   enable_script_debugger(false),
+  enable_script_profiler(false),
+  script_budget(0),
   start_demo(),
   record_demo(),
+  audio_sink(),
   tux_spawn_pos(),
   edit_level(),
   locale(),
@@ -53,6 +59,7 @@ Config::Config() :
   joystick_config(),
   addons(),
   developer_mode(false),
+  editor_rle_tiles(false),
   christmas_mode(false),
   transitions_enabled(true),
   repository_url()
@@ -82,6 +89,7 @@ Config::load()
     }
   }
   config_lisp.get("transitions_enabled", transitions_enabled);
+  config_lisp.get("editor_rle_tiles", editor_rle_tiles);
   config_lisp.get("locale", locale);
   config_lisp.get("random_seed", random_seed);
   config_lisp.get("repository_url", repository_url);
@@ -112,6 +120,10 @@ Config::load()
     config_video_lisp.get("aspect_height", aspect_size.height);
 
     config_video_lisp.get("magnification", magnification);
+
+    config_video_lisp.get("texture_cache_size", texture_cache_size);
+    config_video_lisp.get("surface_cache_size", surface_cache_size);
+    config_video_lisp.get("image_cache", image_cache);
   }
 
   ReaderMapping config_audio_lisp;
@@ -176,6 +188,7 @@ Config::save()
     writer.write("christmas", christmas_mode);
   }
   writer.write("transitions_enabled", transitions_enabled);
+  writer.write("editor_rle_tiles", editor_rle_tiles);
   writer.write("locale", locale);
   writer.write("repository_url", repository_url);
 
@@ -196,6 +209,10 @@ Config::save()
 
   writer.write("magnification", magnification);
 
+  writer.write("texture_cache_size", texture_cache_size);
+  writer.write("surface_cache_size", surface_cache_size);
+  writer.write("image_cache", image_cache);
+
   writer.end_list("video");
 
   writer.start_list("audio");
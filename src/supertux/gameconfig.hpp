@@ -51,6 +51,14 @@ public:
 
   float magnification;
 
+  /** memory in MiB that cached textures and decoded images may use
+      before the least recently used ones get evicted */
+  int texture_cache_size;
+  int surface_cache_size;
+
+  /** keep decoded images in the user dir to speed up the next start */
+  bool image_cache;
+
   bool use_fullscreen;
   VideoSystem::Enum video;
   bool try_vsync;
@@ -65,8 +73,13 @@ public:
   /** this variable is set if supertux should start in a specific level */
   std::string start_level;
   bool enable_script_debugger;
+  bool enable_script_profiler;
+  /** milliseconds per frame for waking waiting scripts, 0 for no limit */
+  int script_budget;
   std::string start_demo;
   std::string record_demo;
+  /** native path of a WAV file to mix all audio into instead of playing it */
+  std::string audio_sink;
 
   /** this variable is set if tux should spawn somewhere which isn't the "main" spawn point*/
   boost::optional<Vector> tux_spawn_pos;
@@ -90,6 +103,9 @@ public:
   std::vector<Addon> addons;
 
   bool developer_mode;
+
+  /** save tilemaps as (tiles-rle ...), which older versions can't read */
+  bool editor_rle_tiles;
   bool christmas_mode;
   bool transitions_enabled;
 
@@ -16,17 +16,15 @@
 
 #include "supertux/level.hpp"
 
-#include "badguy/goldbomb.hpp"
-#include "object/bonus_block.hpp"
-#include "object/coin.hpp"
 #include "physfs/ifile_streambuf.hpp"
 #include "physfs/physfs_file_system.hpp"
 #include "supertux/sector.hpp"
+#include "supertux/sector_parser.hpp"
 #include "supertux/tile_manager.hpp"
 #include "supertux/tile_set.hpp"
-#include "trigger/secretarea_trigger.hpp"
 #include "util/file_system.hpp"
 #include "util/log.hpp"
+#include "util/reader_document.hpp"
 #include "util/writer.hpp"
 
 #include <sstream>
@@ -43,7 +41,9 @@ Level::Level() :
   sectors(),
   stats(),
   target_time(),
-  tileset("images/tiles.strf")
+  tileset("images/tiles.strf"),
+  m_doc(),
+  m_pending_sectors()
 {
   _current = this;
 }
@@ -51,6 +51,7 @@ Level::Level() :
 Level::~Level()
 {
   sectors.clear();
+  m_pending_sectors.clear();
 }
 
 void
@@ -58,13 +59,15 @@ Level::save(const std::string& filepath, bool retry)
 {
   //FIXME: It tests for directory in supertux/data, but saves into .supertux2.
 
+  load_all_sectors();
+
   try {
 
     { // make sure the level directory exists
       std::string dirname = FileSystem::dirname(filepath);
       if(!PHYSFS_exists(dirname.c_str()))
       {
-        if(!PHYSFS_mkdir(dirname.c_str()))
+        if(!PhysFSFileSystem::mkdir(dirname))
         {
           std::ostringstream msg;
           msg << "Couldn't create directory for level '"
@@ -115,7 +118,7 @@ Level::save(const std::string& filepath, bool retry)
       log_warning << "Failed to save the level, retrying..." << std::endl;
       { // create the level directory again
         std::string dirname = FileSystem::dirname(filepath);
-        if(!PHYSFS_mkdir(dirname.c_str()))
+        if(!PhysFSFileSystem::mkdir(dirname))
         {
           std::ostringstream msg;
           msg << "Couldn't create directory for level '"
@@ -139,26 +142,73 @@ Level::add_sector(std::unique_ptr<Sector> sector)
   }
 }
 
+void
+Level::add_pending_sector(const std::string& name_, const ReaderMapping& reader)
+{
+  for(auto const& pending : m_pending_sectors) {
+    if(pending.name == name_) {
+      throw std::runtime_error("Trying to add 2 sectors with same name");
+    }
+  }
+
+  PendingSector pending;
+  pending.name = name_;
+  pending.reader = reader;
+  pending.totals = SectorParser::prescan(tileset, reader);
+  m_pending_sectors.push_back(pending);
+}
+
+Sector*
+Level::load_pending_sector(size_t index)
+{
+  PendingSector pending = m_pending_sectors[index];
+  m_pending_sectors.erase(m_pending_sectors.begin() + index);
+
+  log_debug << "Creating sector '" << pending.name << "' of " << filename << std::endl;
+  sectors.push_back(SectorParser::from_reader(*this, pending.reader));
+  Sector* sector = sectors.back().get();
+
+  if (m_pending_sectors.empty()) {
+    m_doc.reset();
+  }
+  return sector;
+}
+
+void
+Level::load_all_sectors()
+{
+  while(!m_pending_sectors.empty()) {
+    load_pending_sector(0);
+  }
+}
+
 Sector*
-Level::get_sector(const std::string& name_) const
+Level::get_sector(const std::string& name_)
 {
   for(auto const& sector : sectors) {
     if(sector->get_name() == name_) {
       return sector.get();
     }
   }
+
+  for(size_t i = 0; i < m_pending_sectors.size(); ++i) {
+    if(m_pending_sectors[i].name == name_) {
+      return load_pending_sector(i);
+    }
+  }
   return nullptr;
 }
 
 size_t
 Level::get_sector_count() const
 {
-  return sectors.size();
+  return sectors.size() + m_pending_sectors.size();
 }
 
 Sector*
-Level::get_sector(size_t num) const
+Level::get_sector(size_t num)
 {
+  load_all_sectors();
   return sectors.at(num).get();
 }
 
@@ -167,31 +217,10 @@ Level::get_total_coins() const
 {
   int total_coins = 0;
   for(auto const& sector : sectors) {
-    for(const auto& o: sector->gameobjects) {
-      auto coin = dynamic_cast<Coin*>(o.get());
-      if(coin)
-      {
-        total_coins++;
-        continue;
-      }
-      auto block = dynamic_cast<BonusBlock*>(o.get());
-      if(block)
-      {
-        if (block->contents == BonusBlock::CONTENT_COIN)
-        {
-          total_coins += block->hit_counter;
-          continue;
-        } else if (block->contents == BonusBlock::CONTENT_RAIN ||
-                   block->contents == BonusBlock::CONTENT_EXPLODE)
-        {
-          total_coins += 10;
-          continue;
-        }
-      }
-      auto goldbomb = dynamic_cast<GoldBomb*>(o.get());
-      if(goldbomb)
-        total_coins += 10;
-    }
+    total_coins += sector->get_totals().coins;
+  }
+  for(auto const& pending : m_pending_sectors) {
+    total_coins += pending.totals.coins;
   }
   return total_coins;
 }
@@ -201,7 +230,10 @@ Level::get_total_badguys() const
 {
   int total_badguys = 0;
   for(auto const& sector : sectors) {
-    total_badguys += sector->get_total_badguys();
+    total_badguys += sector->get_totals().badguys;
+  }
+  for(auto const& pending : m_pending_sectors) {
+    total_badguys += pending.totals.badguys;
   }
   return total_badguys;
 }
@@ -211,7 +243,10 @@ Level::get_total_secrets() const
 {
   int total_secrets = 0;
   for(auto const& sector : sectors) {
-    total_secrets += sector->get_total_count<SecretAreaTrigger>();
+    total_secrets += sector->get_totals().secrets;
+  }
+  for(auto const& pending : m_pending_sectors) {
+    total_secrets += pending.totals.secrets;
   }
   return total_secrets;
 }
@@ -17,10 +17,12 @@
 #ifndef HEADER_SUPERTUX_SUPERTUX_LEVEL_HPP
 #define HEADER_SUPERTUX_SUPERTUX_LEVEL_HPP
 
+#include "supertux/sector_parser.hpp"
 #include "supertux/statistics.hpp"
 #include "util/currenton.hpp"
+#include "util/reader_mapping.hpp"
 
-class ReaderMapping;
+class ReaderDocument;
 class Sector;
 
 /**
@@ -57,10 +59,14 @@ public:
   const std::string& get_name() const { return name; }
   const std::string& get_author() const { return author; }
 
-  Sector* get_sector(const std::string& name) const;
+  /** Sectors are created from the level file on first access */
+  Sector* get_sector(const std::string& name);
 
   size_t get_sector_count() const;
-  Sector* get_sector(size_t num) const;
+  Sector* get_sector(size_t num);
+
+  /** Creates all sectors that are still waiting in the level file */
+  void load_all_sectors();
 
   std::string get_tileset() const { return tileset; }
 
@@ -79,6 +85,22 @@ private:
 
   void load_old_format(const ReaderMapping& reader);
 
+  void add_pending_sector(const std::string& name, const ReaderMapping& reader);
+  Sector* load_pending_sector(size_t index);
+
+private:
+  /** A sector that was pre-scanned, but not created yet */
+  struct PendingSector
+  {
+    std::string name;
+    ReaderMapping reader;
+    SectorParser::Totals totals;
+  };
+
+  /** the parsed level file, kept while sectors are pending */
+  std::unique_ptr<ReaderDocument> m_doc;
+  std::vector<PendingSector> m_pending_sectors;
+
 private:
   Level(const Level&);
   Level& operator=(const Level&);
@@ -0,0 +1,302 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "supertux/level_metadata_index.hpp"
+
+#include <ctype.h>
+#include <physfs.h>
+#include <sstream>
+
+#include "physfs/physfs_file_system.hpp"
+#include "util/file_system.hpp"
+#include "util/gettext.hpp"
+#include "util/log.hpp"
+#include "util/reader.hpp"
+#include "util/reader_collection.hpp"
+#include "util/reader_document.hpp"
+#include "util/reader_mapping.hpp"
+#include "util/writer.hpp"
+
+namespace {
+
+const int INDEX_VERSION = 2;
+const char* const INDEX_DIRECTORY = "cache/levelinfo";
+
+/** Returns true if the level's (name ...) is wrapped in (_ ...) */
+bool is_translatable_name(const ReaderMapping& mapping)
+{
+  const sexp::Value& sx = mapping.get_sexp();
+  if (!sx.is_array())
+    return false;
+
+  for (const auto& item : sx.as_array())
+  {
+    if (item.is_array() && item.as_array().size() == 2 &&
+        item.as_array()[0].is_symbol() &&
+        item.as_array()[0].as_string() == "name")
+    {
+      const sexp::Value& value = item.as_array()[1];
+      return value.is_array() && !value.as_array().empty() &&
+        value.as_array()[0].is_symbol() && value.as_array()[0].as_string() == "_";
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+LevelMetadataIndex::Entry::Entry() :
+  title(),
+  translatable(false),
+  target_time(0.0f),
+  has_totals(false),
+  total_coins(0),
+  total_badguys(0),
+  total_secrets(0),
+  mtime(0),
+  size(0)
+{
+}
+
+LevelMetadataIndex::LevelMetadataIndex(const std::string& basedir) :
+  m_basedir(basedir),
+  m_entries(),
+  m_changed(false)
+{
+  load();
+}
+
+std::string
+LevelMetadataIndex::get_index_filename() const
+{
+  std::string name = m_basedir;
+  for (auto& c : name)
+  {
+    if (!isalnum(static_cast<unsigned char>(c)) && c != '-')
+      c = '_';
+  }
+  return FileSystem::join(INDEX_DIRECTORY, name + ".stli");
+}
+
+void
+LevelMetadataIndex::load()
+{
+  std::string filename = get_index_filename();
+  if (!PhysFSFileSystem::exists(filename))
+    return;
+
+  try
+  {
+    auto doc = ReaderDocument::parse(filename);
+    auto root = doc.get_root();
+    if (root.get_name() != "supertux-level-index")
+      return;
+
+    auto mapping = root.get_mapping();
+    int version = 0;
+    mapping.get("version", version);
+    if (version != INDEX_VERSION)
+      return;
+
+    ReaderCollection levels;
+    if (!mapping.get("levels", levels))
+      return;
+
+    for (const auto& level : levels.get_objects())
+    {
+      if (level.get_name() != "level")
+        continue;
+
+      auto level_mapping = level.get_mapping();
+      std::string file;
+      std::string mtime;
+      std::string size;
+      Entry entry;
+      if (!level_mapping.get("file", file) ||
+          !level_mapping.get("mtime", mtime) ||
+          !level_mapping.get("size", size))
+        continue;
+
+      level_mapping.get("title", entry.title);
+      level_mapping.get("translatable", entry.translatable);
+      level_mapping.get("target-time", entry.target_time);
+      entry.has_totals = level_mapping.get("total-coins", entry.total_coins) &&
+                         level_mapping.get("total-badguys", entry.total_badguys) &&
+                         level_mapping.get("total-secrets", entry.total_secrets);
+      entry.mtime = std::stoll(mtime);
+      entry.size = std::stoll(size);
+      m_entries[file] = entry;
+    }
+  }
+  catch(const std::exception& err)
+  {
+    log_warning << "Ignoring level index '" << filename << "': " << err.what() << std::endl;
+    m_entries.clear();
+  }
+}
+
+bool
+LevelMetadataIndex::read_level(const std::string& filename, Entry& entry) const
+{
+  std::string path = (m_basedir == "./") ? filename : FileSystem::join(m_basedir, filename);
+
+  register_translation_directory(path);
+  // the stats totals are left to set_totals(), counting them would
+  // need the sectors and the tileset
+  auto doc = ReaderDocument::parse_header(path, "sector");
+  doc.set_translate(false);
+  auto root = doc.get_root();
+  if (root.get_name() != "supertux-level")
+    return false;
+
+  auto mapping = root.get_mapping();
+  mapping.get("name", entry.title);
+  entry.translatable = is_translatable_name(mapping);
+  mapping.get("target-time", entry.target_time);
+  return true;
+}
+
+const LevelMetadataIndex::Entry*
+LevelMetadataIndex::get(const std::string& filename)
+{
+  std::string path = (m_basedir == "./") ? filename : FileSystem::join(m_basedir, filename);
+
+  // not PhysFSDirectoryIndex::stat(), levels edited outside of the
+  // game have to be picked up
+  PHYSFS_Stat stat;
+  if (!PHYSFS_stat(path.c_str(), &stat) || stat.filetype != PHYSFS_FILETYPE_REGULAR)
+  {
+    if (m_entries.erase(filename))
+      m_changed = true;
+    return nullptr;
+  }
+
+  auto it = m_entries.find(filename);
+  if (it != m_entries.end() &&
+      it->second.mtime == stat.modtime &&
+      it->second.size == stat.filesize)
+  {
+    return &it->second;
+  }
+
+  Entry entry;
+  try
+  {
+    if (!read_level(filename, entry))
+      return nullptr;
+  }
+  catch(const std::exception& err)
+  {
+    log_warning << "Problem when reading level information of '" << path << "': "
+                << err.what() << std::endl;
+    return nullptr;
+  }
+
+  entry.mtime = stat.modtime;
+  entry.size = stat.filesize;
+  m_changed = true;
+
+  Entry& result = m_entries[filename];
+  result = entry;
+  return &result;
+}
+
+void
+LevelMetadataIndex::set_totals(const std::string& filename, int coins, int badguys, int secrets)
+{
+  // makes sure the entry belongs to the current version of the file
+  if (!get(filename))
+    return;
+
+  Entry& entry = m_entries[filename];
+  if (entry.has_totals &&
+      entry.total_coins == coins &&
+      entry.total_badguys == badguys &&
+      entry.total_secrets == secrets)
+    return;
+
+  entry.has_totals = true;
+  entry.total_coins = coins;
+  entry.total_badguys = badguys;
+  entry.total_secrets = secrets;
+  m_changed = true;
+}
+
+std::string
+LevelMetadataIndex::get_title(const std::string& filename)
+{
+  const Entry* entry = get(filename);
+  return entry ? get_title(*entry) : std::string();
+}
+
+std::string
+LevelMetadataIndex::get_title(const Entry& entry)
+{
+  if (entry.translatable)
+    return _(entry.title);
+  else
+    return entry.title;
+}
+
+void
+LevelMetadataIndex::save()
+{
+  if (!m_changed)
+    return;
+
+  try
+  {
+    if (!PhysFSFileSystem::exists(INDEX_DIRECTORY) && !PhysFSFileSystem::mkdir(INDEX_DIRECTORY))
+    {
+      std::ostringstream msg;
+      msg << "Couldn't create directory '" << INDEX_DIRECTORY << "': "
+          << PHYSFS_getLastErrorCode();
+      throw std::runtime_error(msg.str());
+    }
+
+    Writer writer(get_index_filename());
+    writer.start_list("supertux-level-index");
+    writer.write("version", INDEX_VERSION);
+    writer.start_list("levels");
+    for (const auto& it : m_entries)
+    {
+      writer.start_list("level");
+      writer.write("file", it.first);
+      writer.write("mtime", std::to_string(it.second.mtime));
+      writer.write("size", std::to_string(it.second.size));
+      writer.write("title", it.second.title);
+      writer.write("translatable", it.second.translatable);
+      writer.write("target-time", it.second.target_time);
+      if (it.second.has_totals)
+      {
+        writer.write("total-coins", it.second.total_coins);
+        writer.write("total-badguys", it.second.total_badguys);
+        writer.write("total-secrets", it.second.total_secrets);
+      }
+      writer.end_list("level");
+    }
+    writer.end_list("levels");
+    writer.end_list("supertux-level-index");
+    m_changed = false;
+  }
+  catch(const std::exception& err)
+  {
+    log_warning << "Couldn't write level index for '" << m_basedir << "': " << err.what() << std::endl;
+  }
+}
+
+/* EOF */
@@ -0,0 +1,89 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HEADER_SUPERTUX_SUPERTUX_LEVEL_METADATA_INDEX_HPP
+#define HEADER_SUPERTUX_SUPERTUX_LEVEL_METADATA_INDEX_HPP
+
+#include <map>
+#include <stdint.h>
+#include <string>
+
+/** Persistent cache of the information the worldmap and levelset
+    menus show about the levels of one world, so they don't have to
+    parse every level file each time they are opened. Entries are
+    keyed by the level filename relative to the world directory and
+    are refreshed when the file's size or modification time changes. */
+class LevelMetadataIndex final
+{
+public:
+  struct Entry
+  {
+    Entry();
+
+    /** untranslated level name */
+    std::string title;
+    bool translatable;
+    float target_time;
+
+    /** coins, badguys and secret areas of all sectors, only known
+        once the level was entered, see set_totals() */
+    bool has_totals;
+    int total_coins;
+    int total_badguys;
+    int total_secrets;
+
+    int64_t mtime;
+    int64_t size;
+  };
+
+public:
+  LevelMetadataIndex(const std::string& basedir);
+
+  /** Returns the entry for @c filename, reading the level header if
+      the file changed since it was indexed, or nullptr if the file
+      isn't a readable level */
+  const Entry* get(const std::string& filename);
+
+  /** Stores the stats totals of @c filename as counted by the Level
+      once it was played, reading them needs the tileset */
+  void set_totals(const std::string& filename, int coins, int badguys, int secrets);
+
+  /** Returns the translated title of @c filename, or an empty string */
+  std::string get_title(const std::string& filename);
+  static std::string get_title(const Entry& entry);
+
+  /** Writes the index back to the user directory if anything changed */
+  void save();
+
+private:
+  std::string get_index_filename() const;
+  void load();
+  bool read_level(const std::string& filename, Entry& entry) const;
+
+private:
+  std::string m_basedir;
+  std::map<std::string, Entry> m_entries;
+  bool m_changed;
+
+private:
+  LevelMetadataIndex(const LevelMetadataIndex&) = delete;
+  LevelMetadataIndex& operator=(const LevelMetadataIndex&) = delete;
+};
+
+#endif
+
+/* EOF */
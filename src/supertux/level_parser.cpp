@@ -16,22 +16,126 @@
 
 #include "supertux/level_parser.hpp"
 
+#include <map>
 #include <sstream>
 
+#include "editor/editor.hpp"
 #include "physfs/ifile_streambuf.hpp"
+#include "physfs/physfs_file_data.hpp"
 #include "supertux/level.hpp"
 #include "supertux/sector.hpp"
 #include "supertux/sector_parser.hpp"
+#include "util/binary_sexp.hpp"
 #include "util/reader.hpp"
 #include "util/reader_collection.hpp"
 #include "util/reader_document.hpp"
 #include "util/reader_mapping.hpp"
+#include "util/string_util.hpp"
+
+namespace {
+
+/** Result of comparing a .stlb against its .stl, remembered along
+    with the modification times and sizes of both files */
+struct CompiledLevelCheck
+{
+  PHYSFS_sint64 text_mtime;
+  PHYSFS_sint64 text_size;
+  PHYSFS_sint64 bin_mtime;
+  PHYSFS_sint64 bin_size;
+  bool matches;
+};
+
+std::map<std::string, CompiledLevelCheck> compiled_level_checks;
+
+bool compare_source_stamp(const std::string& filepath, const std::string& binpath)
+{
+  char header[BinarySexp::HEADER_SIZE];
+  PHYSFS_File* file = PHYSFS_openRead(binpath.c_str());
+  if(!file)
+    return false;
+  PHYSFS_sint64 len = PHYSFS_readBytes(file, header, sizeof(header));
+  PHYSFS_close(file);
+
+  uint64_t stamp;
+  if(len != static_cast<PHYSFS_sint64>(sizeof(header)) ||
+     !BinarySexp::read_source_stamp(header, sizeof(header), stamp))
+  {
+    return false;
+  }
+
+  try
+  {
+    PhysFSFileData text(filepath);
+    return BinarySexp::source_stamp(text.get_data(), text.get_size()) == stamp;
+  }
+  catch(const std::exception&)
+  {
+    return false;
+  }
+}
+
+/** Returns true if the compiled .stlb next to a .stl exists and was
+    compiled from the current contents of the .stl. The .stl is only
+    read and hashed again when the modification time or size of either
+    file changed since the last check. */
+bool has_compiled_level(const std::string& filepath, const std::string& binpath)
+{
+  PHYSFS_Stat text_stat;
+  PHYSFS_Stat bin_stat;
+  if(!PHYSFS_stat(binpath.c_str(), &bin_stat) ||
+     !PHYSFS_stat(filepath.c_str(), &text_stat))
+  {
+    return false;
+  }
+
+  auto it = compiled_level_checks.find(filepath);
+  if(it != compiled_level_checks.end() &&
+     it->second.text_mtime == text_stat.modtime &&
+     it->second.text_size == text_stat.filesize &&
+     it->second.bin_mtime == bin_stat.modtime &&
+     it->second.bin_size == bin_stat.filesize)
+  {
+    return it->second.matches;
+  }
+
+  CompiledLevelCheck check;
+  check.text_mtime = text_stat.modtime;
+  check.text_size = text_stat.filesize;
+  check.bin_mtime = bin_stat.modtime;
+  check.bin_size = bin_stat.filesize;
+  check.matches = compare_source_stamp(filepath, binpath);
+  compiled_level_checks[filepath] = check;
+  return check.matches;
+}
+
+ReaderDocument load_level_document(const std::string& filepath)
+{
+  if(StringUtil::has_suffix(filepath, ".stlb"))
+    return ReaderDocument::parse_binary(filepath);
+
+  std::string binpath = filepath + "b";
+  if(StringUtil::has_suffix(filepath, ".stl") && has_compiled_level(filepath, binpath))
+  {
+    try
+    {
+      return ReaderDocument::parse_binary(binpath);
+    }
+    catch(const std::exception& err)
+    {
+      log_warning << "[" << binpath << "] ignoring compiled level: " << err.what() << std::endl;
+    }
+  }
+
+  return ReaderDocument::parse(filepath);
+}
+
+} // namespace
 
 std::unique_ptr<Level>
-LevelParser::from_file(const std::string& filename)
+LevelParser::from_file(const std::string& filename, bool translate)
 {
   std::unique_ptr<Level> level(new Level);
-  LevelParser parser(*level);
+  LevelParser parser(*level, translate);
   parser.load(filename);
   return level;
 }
@@ -79,8 +183,9 @@ LevelParser::from_nothing_worldmap(const std::string& basedir, const std::string
   return level;
 }
 
-LevelParser::LevelParser(Level& level) :
-  m_level(level)
+LevelParser::LevelParser(Level& level, bool translate) :
+  m_level(level),
+  m_translate(translate)
 {
 }
 
@@ -90,8 +195,10 @@ LevelParser::load(const std::string& filepath)
   try {
     m_level.filename = filepath;
     register_translation_directory(filepath);
-    auto doc = ReaderDocument::parse(filepath);
-    auto root = doc.get_root();
+    // the document has to outlive the sectors that are created lazily
+    m_level.m_doc.reset(new ReaderDocument(load_level_document(filepath)));
+    m_level.m_doc->set_translate(m_translate);
+    auto root = m_level.m_doc->get_root();
 
     if(root.get_name() != "supertux-level")
       throw std::runtime_error("file is not a supertux-level file.");
@@ -112,11 +219,21 @@ LevelParser::load(const std::string& filepath)
       level.get("license", m_level.license);
       level.get("target-time", m_level.target_time);
 
+      // outside the editor, sectors are only created once the game
+      // enters them
+      bool lazy = !Editor::is_active();
       auto iter = level.get_iter();
       while(iter.next()) {
         if (iter.get_key() == "sector") {
-          auto sector = SectorParser::from_reader(m_level, iter.as_mapping());
-          m_level.add_sector(std::move(sector));
+          auto mapping = iter.as_mapping();
+          if (lazy) {
+            std::string sector_name;
+            mapping.get("name", sector_name);
+            m_level.add_pending_sector(sector_name, mapping);
+          } else {
+            auto sector = SectorParser::from_reader(m_level, mapping);
+            m_level.add_sector(std::move(sector));
+          }
         }
       }
 
@@ -129,6 +246,10 @@ LevelParser::load(const std::string& filepath)
     } else {
       log_warning << "[" <<  filepath << "] level format version " << version << " is not supported" << std::endl;
     }
+
+    if (m_level.m_pending_sectors.empty()) {
+      m_level.m_doc.reset();
+    }
   } catch(std::exception& e) {
     std::stringstream msg;
     msg << "Problem when reading level '" << filepath << "': " << e.what();
@@ -26,12 +26,15 @@ class ReaderMapping;
 class LevelParser
 {
 public:
-  static std::unique_ptr<Level> from_file(const std::string& filename);
+  /** Loads the level, with @c translate false the level name and
+      other (_ "...") strings are kept untranslated, as the editor needs
+      them */
+  static std::unique_ptr<Level> from_file(const std::string& filename, bool translate = true);
   static std::unique_ptr<Level> from_nothing(const std::string& basedir);
   static std::unique_ptr<Level> from_nothing_worldmap(const std::string& basedir, const std::string& name);
 
 private:
-  LevelParser(Level& level);
+  LevelParser(Level& level, bool translate = true);
 
   void load(const std::string& filepath);
   void load_old_format(const ReaderMapping& reader);
@@ -39,6 +42,7 @@ private:
 
 private:
   Level& m_level;
+  bool m_translate;
 
 private:
   LevelParser(const LevelParser&) = delete;
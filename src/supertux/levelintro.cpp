@@ -26,6 +26,7 @@
 #include "supertux/sector.hpp"
 #include "supertux/resources.hpp"
 #include "supertux/player_status.hpp"
+#include "util/cached_translation.hpp"
 #include "util/gettext.hpp"
 
 #include <sstream>
@@ -149,21 +150,28 @@ LevelIntro::draw(DrawingContext& context)
 
   py += 32;
 
+  static CachedTranslation header_text("Best Level Statistics");
+  static CachedTranslation coins_text("Coins");
+  static CachedTranslation badguys_text("Badguys killed");
+  static CachedTranslation secrets_text("Secrets");
+  static CachedTranslation best_time_text("Best time");
+  static CachedTranslation target_time_text("Level target time");
+
   {
-    context.draw_center_text(Resources::normal_font, std::string("- ") + _("Best Level Statistics") + std::string(" -"), Vector(0, py), LAYER_FOREGROUND1, LevelIntro::stat_hdr_color);
+    context.draw_center_text(Resources::normal_font, "- " + header_text.get() + " -", Vector(0, py), LAYER_FOREGROUND1, LevelIntro::stat_hdr_color);
     py += static_cast<int>(Resources::normal_font->get_height());
   }
 
-  draw_stats_line(context, py, _("Coins"),
+  draw_stats_line(context, py, coins_text.get(),
                   Statistics::coins_to_string((best_level_statistics && (best_level_statistics->coins >= 0)) ? best_level_statistics->coins : 0, stats.total_coins));
-  draw_stats_line(context, py, _("Badguys killed"),
+  draw_stats_line(context, py, badguys_text.get(),
                   Statistics::frags_to_string((best_level_statistics && (best_level_statistics->coins >= 0)) ? best_level_statistics->badguys : 0, stats.total_badguys));
-  draw_stats_line(context, py, _("Secrets"),
+  draw_stats_line(context, py, secrets_text.get(),
                   Statistics::secrets_to_string((best_level_statistics && (best_level_statistics->coins >= 0)) ? best_level_statistics->secrets : 0, stats.total_secrets));
-  draw_stats_line(context, py, _("Best time"),
+  draw_stats_line(context, py, best_time_text.get(),
                   Statistics::time_to_string((best_level_statistics && (best_level_statistics->coins >= 0)) ? best_level_statistics->time : 0));
   if(level->target_time) {
-    draw_stats_line(context, py, _("Level target time"),
+    draw_stats_line(context, py, target_time_text.get(),
                   Statistics::time_to_string(level->target_time));
   }
 }
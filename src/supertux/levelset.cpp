@@ -16,10 +16,9 @@
 
 #include "supertux/levelset.hpp"
 
-#include <physfs.h>
 #include <algorithm>
 
-#include "physfs/physfs_file_system.hpp"
+#include "physfs/physfs_directory_index.hpp"
 #include "util/file_system.hpp"
 #include "util/log.hpp"
 #include "util/string_util.hpp"
@@ -48,25 +47,24 @@ void
 Levelset::walk_directory(const std::string& directory, bool recursively)
 {
   bool is_basedir = (directory == m_basedir);
-  char** files = PHYSFS_enumerateFiles(directory.c_str());
-  if (!files)
+  if (!PhysFSDirectoryIndex::is_directory(directory))
   {
     log_warning << "Couldn't read subset dir '" << directory << "'" << std::endl;
     return;
   }
 
-  for(const char* const* filename = files; *filename != 0; ++filename)
+  for(const auto& filename : PhysFSDirectoryIndex::enumerate(directory))
   {
-    auto filepath = FileSystem::join(directory.c_str(), *filename);
-    if(PhysFSFileSystem::is_directory(filepath) && recursively)
+    auto filepath = FileSystem::join(directory, filename);
+    if(recursively && PhysFSDirectoryIndex::is_directory(filepath))
     {
       walk_directory(filepath, true);
     }
-    if(StringUtil::has_suffix(*filename, ".stl"))
+    if(StringUtil::has_suffix(filename, ".stl"))
     {
       if(is_basedir)
       {
-        m_levels.push_back(*filename);
+        m_levels.push_back(filename);
       }
       else
       {
@@ -76,7 +74,6 @@ Levelset::walk_directory(const std::string& directory, bool recursively)
       }
     }
   }
-  PHYSFS_freeList(files);
 }
 
 /* EOF */
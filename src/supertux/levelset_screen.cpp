@@ -69,7 +69,14 @@ LevelsetScreen::setup()
     log_info << "Saving Levelset state" << std::endl;
     // this gets called when the GameSession is done and we return back to the
     m_savegame.set_levelset_state(m_basedir, m_level_filename, m_solved);
-    m_savegame.save();
+    try
+    {
+      m_savegame.save();
+    }
+    catch(const std::exception& err)
+    {
+      log_warning << "Couldn't save levelset state: " << err.what() << std::endl;
+    }
     ScreenManager::current()->pop_screen();
   }
   else
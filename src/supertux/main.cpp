@@ -24,8 +24,10 @@
 #include <boost/format.hpp>
 #include <boost/optional.hpp>
 #include <boost/locale.hpp>
+#include <algorithm>
 #include <array>
 #include <iostream>
+#include <sstream>
 #include <physfs.h>
 #include <stdio.h>
 #include <tinygettext/log.hpp>
@@ -39,6 +41,7 @@ extern "C" {
 
 #include "addon/addon_manager.hpp"
 #include "audio/sound_manager.hpp"
+#include "audio/wav_sound_sink.hpp"
 #include "control/input_manager.hpp"
 #include "editor/editor.hpp"
 #include "editor/layer_icon.hpp"
@@ -50,10 +53,13 @@ extern "C" {
 #include "math/random_generator.hpp"
 #include "object/player.hpp"
 #include "physfs/ifile_stream.hpp"
+#include "physfs/physfs_directory_index.hpp"
 #include "physfs/physfs_file_system.hpp"
 #include "physfs/physfs_sdl.hpp"
 #include "scripting/squirrel_util.hpp"
 #include "scripting/scripting.hpp"
+#include "scripting/script_profiler.hpp"
+#include "scripting/time_scheduler.hpp"
 #include "sprite/sprite_data.hpp"
 #include "sprite/sprite_manager.hpp"
 #include "supertux/command_line_arguments.hpp"
@@ -74,6 +80,7 @@ extern "C" {
 #include "video/drawing_context.hpp"
 #include "video/lightmap.hpp"
 #include "video/renderer.hpp"
+#include "video/texture_manager.hpp"
 #include "worldmap/worldmap.hpp"
 
 class ConfigSubsystem
@@ -123,12 +130,13 @@ Main::init_tinygettext()
   tinygettext::Log::set_log_warning_callback(log_warning_callback);
   tinygettext::Log::set_log_error_callback(log_error_callback);
 
-  g_dictionary_manager->add_directory("locale");
+  g_compiled_dictionary.reset(new CompiledDictionary(*g_dictionary_manager, "cache/locale"));
+  g_compiled_dictionary->add_directory("locale");
 
   // Config setting "locale" overrides language detection
   if (!g_config->locale.empty())
   {
-    g_dictionary_manager->set_language(tinygettext::Language::from_name(g_config->locale));
+    g_compiled_dictionary->set_language(tinygettext::Language::from_name(g_config->locale));
   }
   else
   {
@@ -136,7 +144,7 @@ Main::init_tinygettext()
     FL_FindLocale(&locale);
     tinygettext::Language language = tinygettext::Language::from_spec( locale->lang?locale->lang:"", locale->country?locale->country:"", locale->variant?locale->variant:"");
     FL_FreeLocale(&locale);
-    g_dictionary_manager->set_language(language);
+    g_compiled_dictionary->set_language(language);
   }
 }
 
@@ -191,7 +199,7 @@ public:
       {
         datadir = BUILD_DATA_DIR;
         // Add config dir for supplemental files
-        PHYSFS_mount(boost::filesystem::canonical(BUILD_CONFIG_DATA_DIR).string().c_str(), NULL, 1);
+        PhysFSFileSystem::mount(boost::filesystem::canonical(BUILD_CONFIG_DATA_DIR).string(), "", true);
       }
       else
       {
@@ -202,7 +210,7 @@ public:
       }
     }
 
-    if (!PHYSFS_mount(boost::filesystem::canonical(datadir).string().c_str(), NULL, 1))
+    if (!PhysFSFileSystem::mount(boost::filesystem::canonical(datadir).string(), "", true))
     {
       log_warning << "Couldn't add '" << datadir << "' to physfs searchpath: " << PHYSFS_getLastErrorCode() << std::endl;
     }
@@ -283,8 +291,9 @@ public:
           <<  userdir << "': " << PHYSFS_getLastErrorCode();
       throw std::runtime_error(msg.str());
     }
+    PhysFSDirectoryIndex::invalidate();
 
-    PHYSFS_mount(userdir.c_str(), NULL, 0);
+    PhysFSFileSystem::mount(userdir, "", false);
   }
 
   static void print_search_path()
@@ -345,6 +354,13 @@ Main::init_video()
   }
   SDL_ShowCursor(0);
 
+  TextureManager::current()->set_budget(size_t(std::max(0, g_config->texture_cache_size)) * 1024 * 1024,
+                                        size_t(std::max(0, g_config->surface_cache_size)) * 1024 * 1024);
+  if (g_config->image_cache)
+  {
+    TextureManager::current()->enable_image_cache("cache/images");
+  }
+
   log_info << (g_config->use_fullscreen?"fullscreen ":"window ")
            << " Window: "     << g_config->window_size
            << " Fullscreen: " << g_config->fullscreen_size << "@" << g_config->fullscreen_refresh_rate
@@ -384,14 +400,19 @@ Main::launch_game()
   init_video();
 
   timelog("audio");
-  SoundManager sound_manager;
+  std::unique_ptr<SoundSink> audio_sink;
+  if(!g_config->audio_sink.empty()) {
+    audio_sink.reset(new WavSoundSink(g_config->audio_sink, SoundManager::SOFTWARE_MIXER_RATE));
+  }
+  SoundManager sound_manager(std::move(audio_sink));
   sound_manager.enable_sound(g_config->sound_enabled);
   sound_manager.enable_music(g_config->music_enabled);
 
   Console console(console_buffer);
 
   timelog("scripting");
-  scripting::Scripting scripting(g_config->enable_script_debugger);
+  scripting::Scripting scripting(g_config->enable_script_debugger,
+                                 g_config->enable_script_profiler);
 
   timelog("resources");
   TileManager tile_manager;
@@ -401,13 +422,20 @@ Main::launch_game()
   timelog("addons");
   AddonManager addon_manager("addons", g_config->addons);
 
-  timelog(0);
+  timelog("screens");
 
   const std::unique_ptr<Savegame> default_savegame(new Savegame(std::string()));
 
   GameManager game_manager;
   ScreenManager screen_manager;
 
+  if(g_config->script_budget > 0) {
+    float budget = static_cast<float>(g_config->script_budget) / 1000.0f;
+    scripting::TimeScheduler::instance->set_budget(budget);
+    if(scripting::ScriptProfiler::current())
+      scripting::ScriptProfiler::current()->set_budget(budget);
+  }
+
   if(!g_config->start_level.empty()) {
     // we have a normal path specified at commandline, not a physfs path.
     // So we simply mount that path here...
@@ -419,7 +447,7 @@ Main::launch_game()
       dir = dir.replace(position, fileProtocol.length(), "");
     }
     log_debug << "Adding dir: " << dir << std::endl;
-    PHYSFS_mount(dir.c_str(), NULL, true);
+    PhysFSFileSystem::mount(dir, "", true);
 
     if(g_config->start_level.size() > 4 &&
        g_config->start_level.compare(g_config->start_level.size() - 5, 5, ".stwm") == 0)
@@ -464,6 +492,11 @@ Main::launch_game()
     }
   }
 
+  timelog(0);
+  std::ostringstream image_stats;
+  TextureManager::current()->print_image_stats(image_stats);
+  log_info << image_stats.str();
+
   screen_manager.run(context);
 }
 
@@ -549,6 +582,7 @@ Main::run(int argc, char** argv)
     result = 1;
   }
 
+  g_compiled_dictionary.reset();
   g_dictionary_manager.reset();
 
   return result;
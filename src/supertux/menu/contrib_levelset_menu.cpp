@@ -23,12 +23,12 @@
 #include "gui/item_action.hpp"
 #include "supertux/game_manager.hpp"
 #include "supertux/globals.hpp"
+#include "supertux/level_metadata_index.hpp"
 #include "supertux/levelset.hpp"
 #include "supertux/screen_fade.hpp"
 #include "supertux/screen_manager.hpp"
 #include "supertux/title_screen.hpp"
 #include "supertux/world.hpp"
-#include "util/file_system.hpp"
 #include "util/gettext.hpp"
 
 ContribLevelsetMenu::ContribLevelsetMenu(std::unique_ptr<World> world) :
@@ -43,14 +43,15 @@ ContribLevelsetMenu::ContribLevelsetMenu(std::unique_ptr<World> world) :
   savegame.load();
   LevelsetState state = savegame.get_levelset_state(m_world->get_basedir());
 
+  LevelMetadataIndex level_index(m_world->get_basedir());
+
   add_label(m_world->get_title());
   add_hl();
 
   for (int i = 0; i < m_levelset->get_num_levels(); ++i)
   {
     std::string filename = m_levelset->get_level_filename(i);
-    std::string full_filename = FileSystem::join(m_world->get_basedir(), filename);
-    std::string title = GameManager::current()->get_level_name(full_filename);
+    std::string title = level_index.get_title(filename);
     LevelState level_state = state.get_level_state(filename);
 
     std::ostringstream out;
@@ -65,6 +66,8 @@ ContribLevelsetMenu::ContribLevelsetMenu(std::unique_ptr<World> world) :
     add_entry(i, out.str());
   }
 
+  level_index.save();
+
   add_hl();
   add_back(_("Back"));
 }
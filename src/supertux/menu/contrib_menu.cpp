@@ -16,12 +16,11 @@
 
 #include "supertux/menu/contrib_menu.hpp"
 
-#include <physfs.h>
 #include <sstream>
 
 #include "gui/menu_item.hpp"
 #include "gui/menu_manager.hpp"
-#include "physfs/physfs_file_system.hpp"
+#include "physfs/physfs_directory_index.hpp"
 #include "supertux/game_manager.hpp"
 #include "supertux/gameconfig.hpp"
 #include "supertux/levelset.hpp"
@@ -38,36 +37,27 @@ ContribMenu::ContribMenu() :
   // Generating contrib levels list by making use of Level Subset
   std::vector<std::string> level_worlds;
 
-  std::unique_ptr<char*, decltype(&PHYSFS_freeList)>
-    files(PHYSFS_enumerateFiles("levels"),
-          PHYSFS_freeList);
-  for(const char* const* filename = files.get(); *filename != 0; ++filename)
+  for(const auto& filename : PhysFSDirectoryIndex::enumerate("levels"))
   {
-    std::string filepath = FileSystem::join("levels", *filename);
-    if(PhysFSFileSystem::is_directory(filepath))
+    std::string filepath = FileSystem::join("levels", filename);
+    if(PhysFSDirectoryIndex::is_directory(filepath))
     {
       level_worlds.push_back(filepath);
     }
   }
 
-  std::unique_ptr<char*, decltype(&PHYSFS_freeList)>
-    addons(PHYSFS_enumerateFiles("custom"),
-          PHYSFS_freeList);
-  for(const char* const* addondir = addons.get(); *addondir != 0; ++addondir)
+  for(const auto& addondir : PhysFSDirectoryIndex::enumerate("custom"))
   {
-    std::string addonpath = FileSystem::join("custom", *addondir);
-    if(PhysFSFileSystem::is_directory(addonpath))
+    std::string addonpath = FileSystem::join("custom", addondir);
+    if(PhysFSDirectoryIndex::is_directory(addonpath))
     {
-      std::string addonlevelpath = FileSystem::join(addonpath.c_str(), "levels");
-      if(PhysFSFileSystem::is_directory(addonlevelpath))
+      std::string addonlevelpath = FileSystem::join(addonpath, "levels");
+      if(PhysFSDirectoryIndex::is_directory(addonlevelpath))
       {
-        std::unique_ptr<char*, decltype(&PHYSFS_freeList)>
-          addonfiles(PHYSFS_enumerateFiles(addonlevelpath.c_str()),
-                PHYSFS_freeList);
-        for(const char* const* filename = addonfiles.get(); *filename != 0; ++filename)
+        for(const auto& filename : PhysFSDirectoryIndex::enumerate(addonlevelpath))
         {
-          std::string filepath = FileSystem::join(addonlevelpath.c_str(), *filename);
-          if(PhysFSFileSystem::is_directory(filepath))
+          std::string filepath = FileSystem::join(addonlevelpath, filename);
+          if(PhysFSDirectoryIndex::is_directory(filepath))
           {
             level_worlds.push_back(filepath);
           }
@@ -23,6 +23,7 @@
 #include "supertux/menu/editor_levelset_menu.hpp"
 #include "supertux/game_manager.hpp"
 #include "supertux/level.hpp"
+#include "supertux/level_metadata_index.hpp"
 #include "supertux/level_parser.hpp"
 #include "supertux/levelset.hpp"
 #include "supertux/world.hpp"
@@ -50,6 +51,8 @@ void EditorLevelSelectMenu::initialize() {
   m_levelset = std::unique_ptr<Levelset>(new Levelset(basedir, /* recursively = */ true));
   auto num_levels = m_levelset->get_num_levels();
 
+  LevelMetadataIndex level_index(basedir);
+
   add_label(world->get_title());
   add_hl();
 
@@ -62,10 +65,10 @@ void EditorLevelSelectMenu::initialize() {
     for (int i = 0; i < num_levels; ++i)
     {
       std::string filename = m_levelset->get_level_filename(i);
-      std::string full_filename = FileSystem::join(basedir, filename);
-      std::string title = GameManager::current()->get_level_name(full_filename);
+      std::string title = level_index.get_title(filename);
       add_entry(i, title);
     }
+    level_index.save();
   }
 
   add_hl();
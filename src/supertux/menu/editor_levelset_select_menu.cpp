@@ -16,13 +16,13 @@
 
 #include "supertux/menu/editor_level_select_menu.hpp"
 
-#include <physfs.h>
 #include <sstream>
 #include <boost/format.hpp>
 
 #include "editor/editor.hpp"
 #include "gui/menu_item.hpp"
 #include "gui/menu_manager.hpp"
+#include "physfs/physfs_directory_index.hpp"
 #include "physfs/physfs_file_system.hpp"
 #include "supertux/levelset.hpp"
 #include "supertux/menu/editor_levelset_select_menu.hpp"
@@ -38,12 +38,9 @@ EditorLevelsetSelectMenu::EditorLevelsetSelectMenu() :
   // Generating contrib levels list by making use of Level Subset
   std::vector<std::string> level_worlds;
 
-  std::unique_ptr<char*, decltype(&PHYSFS_freeList)>
-    files(PHYSFS_enumerateFiles("levels"),
-          PHYSFS_freeList);
-  for(const char* const* filename = files.get(); *filename != 0; ++filename)
+  for(const auto& filename : PhysFSDirectoryIndex::enumerate("levels"))
   {
-    std::string filepath = FileSystem::join("levels", *filename);
+    std::string filepath = FileSystem::join("levels", filename);
     if(PhysFSFileSystem::is_directory(filepath))
     {
       level_worlds.push_back(filepath);
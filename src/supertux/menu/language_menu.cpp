@@ -65,7 +65,7 @@ LanguageMenu::menu_action(MenuItem* item)
     tinygettext::Language language = tinygettext::Language::from_spec( locale->lang?locale->lang:"", locale->country?locale->country:"", locale->variant?locale->variant:"");
     FL_FreeLocale(&locale);
 
-    g_dictionary_manager->set_language(language); // set currently detected language
+    g_compiled_dictionary->set_language(language); // set currently detected language
     g_config->locale = ""; // do auto detect every time on startup
     g_config->save();
     MenuManager::instance().clear_menu_stack();
@@ -73,7 +73,7 @@ LanguageMenu::menu_action(MenuItem* item)
   else if (item->id == MNID_LANGUAGE_ENGLISH) // english
   {
     g_config->locale = "en";
-    g_dictionary_manager->set_language(tinygettext::Language::from_name(g_config->locale));
+    g_compiled_dictionary->set_language(tinygettext::Language::from_name(g_config->locale));
     g_config->save();
     MenuManager::instance().clear_menu_stack();
   }
@@ -87,7 +87,7 @@ LanguageMenu::menu_action(MenuItem* item)
       if (item->id == mnid++)
       {
         g_config->locale = lang.str();
-        g_dictionary_manager->set_language(lang);
+        g_compiled_dictionary->set_language(lang);
         g_config->save();
         break;
       }
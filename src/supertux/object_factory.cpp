@@ -176,7 +176,8 @@ ObjectFactory::instance()
 }
 
 ObjectFactory::ObjectFactory() :
-  factories()
+  factories(),
+  m_counted_badguys()
 {
   init_factories();
 }
@@ -321,6 +322,12 @@ ObjectFactory::create(const std::string& name, const ReaderMapping& reader) cons
   }
 }
 
+bool
+ObjectFactory::is_counted_badguy(const std::string& name) const
+{
+  return m_counted_badguys.find(name) != m_counted_badguys.end();
+}
+
 GameObjectPtr
 ObjectFactory::create(const std::string& name, const Vector& pos, const Direction& dir, const std::string& data) const
 {
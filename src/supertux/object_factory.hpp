@@ -22,10 +22,13 @@
 #include <map>
 #include <memory>
 #include <functional>
+#include <set>
+#include <type_traits>
 
 #include "supertux/direction.hpp"
 #include "supertux/game_object_ptr.hpp"
 
+class BadGuy;
 class ReaderMapping;
 class Vector;
 class GameObject;
@@ -39,12 +42,20 @@ private:
   typedef std::map<std::string, std::function<GameObjectPtr (const ReaderMapping&)> > Factories;
   Factories factories;
 
+  /** names of the BadGuys that count towards the level's total */
+  std::set<std::string> m_counted_badguys;
+
 public:
   ObjectFactory();
 
   GameObjectPtr create(const std::string& name, const ReaderMapping& reader) const;
   GameObjectPtr create(const std::string& name, const Vector& pos, const Direction& dir = AUTO, const std::string& data = {}) const;
 
+  /** Returns true if @c name creates a BadGuy that counts towards
+      Level::get_total_badguys(), lets levels be pre-scanned without
+      creating their objects */
+  bool is_counted_badguy(const std::string& name) const;
+
 private:
   void add_factory(const char* name,
                    std::function<GameObjectPtr (const ReaderMapping&)> func)
@@ -59,7 +70,15 @@ private:
     add_factory(name, [](const ReaderMapping& reader) {
         return std::make_shared<C>(reader);
       });
+    if (is_counted<C>(std::is_base_of<BadGuy, C>()))
+      m_counted_badguys.insert(name);
   }
+
+  template<class C>
+  static bool is_counted(std::true_type) { return C::counted_by_default(); }
+  template<class C>
+  static bool is_counted(std::false_type) { return false; }
+
   void init_factories();
 };
 
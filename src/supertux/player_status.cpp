@@ -72,9 +72,9 @@ PlayerStatus::add_coins(int count, bool play_sound)
 
   static float sound_played_time = 0;
   if(count >= 100)
-    SoundManager::current()->play("sounds/lifeup.wav");
+    SoundManager::current()->play("sounds/lifeup.wav", Vector(-1, -1), SOUND_PRIORITY_HIGH);
   else if (real_time > sound_played_time + 0.010) {
-    SoundManager::current()->play("sounds/coin.wav");
+    SoundManager::current()->play("sounds/coin.wav", Vector(-1, -1), SOUND_PRIORITY_LOW);
     sound_played_time = real_time;
   }
 }
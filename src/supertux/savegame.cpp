@@ -18,8 +18,14 @@
 #include "supertux/savegame.hpp"
 
 #include <algorithm>
-
-#include "physfs/ifile_streambuf.hpp"
+#include <iterator>
+#include <sstream>
+#include <stdint.h>
+#include <string.h>
+#include <utility>
+
+#include "physfs/ofile_stream.hpp"
+#include "physfs/physfs_file_data.hpp"
 #include "physfs/physfs_file_system.hpp"
 #include "scripting/scripting.hpp"
 #include "scripting/serialize.hpp"
@@ -37,6 +43,69 @@ using scripting::get_table_entry;
 using scripting::get_or_create_table_entry;
 using scripting::get_table_keys;
 
+/** Binary savegames start with the magic and a version, followed by
+    the title, the (tux ...) section as text, the state table without
+    its worlds and levelsets entries, and then for both of these tables
+    a count and the name and encoding of each entry. Integers are 32
+    bit little endian, strings are prefixed with their size. */
+const char savegame_magic[4] = { 'S', 'T', 'S', 'G' };
+const uint32_t savegame_version = 2;
+
+/** state subtables whose entries are encoded separately */
+const char* const encoded_tables[] = { "worlds", "levelsets" };
+
+void append_u32(std::string& out, uint32_t value)
+{
+  char bytes[4] = {
+    static_cast<char>(value & 0xff),
+    static_cast<char>((value >> 8) & 0xff),
+    static_cast<char>((value >> 16) & 0xff),
+    static_cast<char>((value >> 24) & 0xff)
+  };
+  out.append(bytes, sizeof(bytes));
+}
+
+void append_string(std::string& out, const std::string& text)
+{
+  append_u32(out, static_cast<uint32_t>(text.size()));
+  out += text;
+}
+
+uint32_t read_u32(const char* data, size_t size, size_t& pos)
+{
+  if(size - pos < 4)
+    throw std::runtime_error("savegame is truncated");
+  const unsigned char* p = reinterpret_cast<const unsigned char*>(data + pos);
+  pos += 4;
+  return static_cast<uint32_t>(p[0]) |
+    (static_cast<uint32_t>(p[1]) << 8) |
+    (static_cast<uint32_t>(p[2]) << 16) |
+    (static_cast<uint32_t>(p[3]) << 24);
+}
+
+std::string read_string(const char* data, size_t size, size_t& pos)
+{
+  uint32_t length = read_u32(data, size, pos);
+  if(size - pos < length)
+    throw std::runtime_error("savegame is truncated");
+  std::string result(data + pos, length);
+  pos += length;
+  return result;
+}
+
+std::string get_worldmap_title()
+{
+  using worldmap::WorldMap;
+  if(WorldMap::current() == NULL)
+    return std::string();
+
+  std::ostringstream title;
+  title << WorldMap::current()->get_title();
+  title << " (" << WorldMap::current()->solved_level_count()
+        << "/" << WorldMap::current()->level_count() << ")";
+  return title.str();
+}
+
 std::vector<LevelState> get_level_states(HSQUIRRELVM vm)
 {
   std::vector<LevelState> results;
@@ -142,56 +211,145 @@ Savegame::load()
 
     try
     {
-      HSQUIRRELVM vm = scripting::global_vm;
+      PhysFSFileData file(m_filename);
+      if(file.get_size() >= sizeof(savegame_magic) &&
+         memcmp(file.get_data(), savegame_magic, sizeof(savegame_magic)) == 0)
+      {
+        load_binary(file.get_data(), file.get_size());
+      }
+      else
+      {
+        load_text(file.get_data(), file.get_size());
+      }
+    }
+    catch(const std::exception& e)
+    {
+      log_fatal << "Couldn't load savegame: " << e.what() << std::endl;
+    }
+  }
+}
+
+void
+Savegame::load_text(const char* data, size_t size)
+{
+  HSQUIRRELVM vm = scripting::global_vm;
 
-      auto doc = ReaderDocument::parse(m_filename);
-      auto root = doc.get_root();
+  auto doc = ReaderDocument::parse(data, size, m_filename);
+  auto root = doc.get_root();
 
-      if(root.get_name() != "supertux-savegame")
+  if(root.get_name() != "supertux-savegame")
+  {
+    throw std::runtime_error("file is not a supertux-savegame file");
+  }
+  else
+  {
+    auto mapping = root.get_mapping();
+
+    int version = 1;
+    mapping.get("version", version);
+    if(version != 1)
+    {
+      throw std::runtime_error("incompatible savegame version");
+    }
+    else
+    {
+      ReaderMapping tux;
+      if(!mapping.get("tux", tux))
       {
-        throw std::runtime_error("file is not a supertux-savegame file");
+        throw std::runtime_error("No tux section in savegame");
+      }
+      {
+        m_player_status->read(tux);
+      }
+
+      ReaderMapping state;
+      if(!mapping.get("state", state))
+      {
+        throw std::runtime_error("No state section in savegame");
       }
       else
       {
-        auto mapping = root.get_mapping();
+        sq_pushroottable(vm);
+        get_table_entry(vm, "state");
+        scripting::load_squirrel_table(vm, -1, state);
+        sq_pop(vm, 2);
+      }
+    }
+  }
+}
 
-        int version = 1;
-        mapping.get("version", version);
-        if(version != 1)
-        {
-          throw std::runtime_error("incompatible savegame version");
-        }
-        else
+void
+Savegame::load_binary(const char* data, size_t size)
+{
+  size_t pos = sizeof(savegame_magic);
+  if(read_u32(data, size, pos) != savegame_version)
+  {
+    throw std::runtime_error("incompatible savegame version");
+  }
+
+  read_string(data, size, pos); // title, only for tools looking at the file
+
+  {
+    std::string tux = read_string(data, size, pos);
+    auto doc = ReaderDocument::parse(tux.data(), tux.size(), m_filename);
+    auto root = doc.get_root();
+    if(root.get_name() != "tux")
+    {
+      throw std::runtime_error("No tux section in savegame");
+    }
+    m_player_status->read(root.get_mapping());
+  }
+
+  HSQUIRRELVM vm = scripting::global_vm;
+  SQInteger oldtop = sq_gettop(vm);
+  try
+  {
+    sq_pushroottable(vm);
+    sq_pushstring(vm, "state", -1);
+    scripting::decode_squirrel_value(vm, data, size, pos);
+    if(sq_gettype(vm, -1) != OT_TABLE)
+    {
+      throw std::runtime_error("No state table in savegame");
+    }
+
+    for(const char* table : encoded_tables)
+    {
+      sq_pushstring(vm, table, -1);
+      sq_newtable(vm);
+
+      uint32_t count = read_u32(data, size, pos);
+      for(uint32_t i = 0; i < count; ++i)
+      {
+        std::string name = read_string(data, size, pos);
+        std::string encoded = read_string(data, size, pos);
+
+        sq_pushstring(vm, name.c_str(), name.size());
+        size_t value_pos = 0;
+        scripting::decode_squirrel_value(vm, encoded.data(), encoded.size(), value_pos);
+        if(SQ_FAILED(sq_createslot(vm, -3)))
         {
-          ReaderMapping tux;
-          if(!mapping.get("tux", tux))
-          {
-            throw std::runtime_error("No tux section in savegame");
-          }
-          {
-            m_player_status->read(tux);
-          }
-
-          ReaderMapping state;
-          if(!mapping.get("state", state))
-          {
-            throw std::runtime_error("No state section in savegame");
-          }
-          else
-          {
-            sq_pushroottable(vm);
-            get_table_entry(vm, "state");
-            scripting::load_squirrel_table(vm, -1, state);
-            sq_pop(vm, 2);
-          }
+          throw scripting::SquirrelError(vm, "Couldn't create state entry");
         }
+
+      }
+
+      if(SQ_FAILED(sq_createslot(vm, -3)))
+      {
+        throw scripting::SquirrelError(vm, "Couldn't create state table");
       }
     }
-    catch(const std::exception& e)
+
+    if(SQ_FAILED(sq_createslot(vm, -3)))
     {
-      log_fatal << "Couldn't load savegame: " << e.what() << std::endl;
+      throw scripting::SquirrelError(vm, "Couldn't create state table");
     }
   }
+  catch(...)
+  {
+    sq_settop(vm, oldtop);
+    throw;
+  }
+  sq_settop(vm, oldtop);
 }
 
 void
@@ -223,7 +381,7 @@ Savegame::save()
     std::string dirname = FileSystem::dirname(m_filename);
     if(!PHYSFS_exists(dirname.c_str()))
     {
-      if(!PHYSFS_mkdir(dirname.c_str()))
+      if(!PhysFSFileSystem::mkdir(dirname))
       {
         std::ostringstream msg;
         msg << "Couldn't create directory for savegames '"
@@ -240,21 +398,111 @@ Savegame::save()
     }
   }
 
+  std::string data(savegame_magic, sizeof(savegame_magic));
+  append_u32(data, savegame_version);
+  append_string(data, get_worldmap_title());
+
+  {
+    std::ostringstream tux;
+    Writer writer(&tux);
+    writer.start_list("tux");
+    m_player_status->write(writer);
+    writer.end_list("tux");
+    append_string(data, tux.str());
+  }
+
   HSQUIRRELVM vm = scripting::global_vm;
+  SQInteger oldtop = sq_gettop(vm);
+  try
+  {
+    sq_pushroottable(vm);
+    get_table_entry(vm, "state");
 
-  Writer writer(m_filename);
+    std::vector<std::string> skip_keys(std::begin(encoded_tables), std::end(encoded_tables));
+    if(!scripting::encode_squirrel_value(vm, -1, data, skip_keys))
+    {
+      throw std::runtime_error("state is not a table");
+    }
+
+    for(const char* table : encoded_tables)
+    {
+      encode_entries(vm, table, data);
+    }
+  }
+  catch(const std::exception& err)
+  {
+    sq_settop(vm, oldtop);
+    throw std::runtime_error("Couldn't save state table: " + std::string(err.what()));
+  }
+  sq_settop(vm, oldtop);
+
+  OFileStream out(m_filename);
+  out.write(data.data(), data.size());
+  if(!out)
+  {
+    throw std::runtime_error("Couldn't write savegame '" + m_filename + "'");
+  }
+}
+
+void
+Savegame::encode_entries(HSQUIRRELVM vm, const char* table, std::string& out)
+{
+  std::vector<std::pair<std::string, std::string> > entries;
+
+  SQInteger oldtop = sq_gettop(vm);
+  sq_pushstring(vm, table, -1);
+  if(SQ_SUCCEEDED(sq_get(vm, -2)) && sq_gettype(vm, -1) == OT_TABLE)
+  {
+    sq_pushnull(vm);
+    while(SQ_SUCCEEDED(sq_next(vm, -2)))
+    {
+      const SQChar* name;
+      if(sq_gettype(vm, -2) == OT_STRING && SQ_SUCCEEDED(sq_getstring(vm, -2, &name)))
+      {
+        std::string value;
+        if(scripting::encode_squirrel_value(vm, -1, value))
+        {
+          entries.push_back(std::make_pair(std::string(name), std::string()));
+          entries.back().second.swap(value);
+        }
+        else
+        {
+          log_warning << "Couldn't save state." << table << "." << name
+                      << ", skipping it" << std::endl;
+        }
+      }
+      sq_pop(vm, 2);
+    }
+  }
+  sq_settop(vm, oldtop);
+
+  append_u32(out, static_cast<uint32_t>(entries.size()));
+  for(const auto& entry : entries)
+  {
+    append_string(out, entry.first);
+    append_string(out, entry.second);
+  }
+}
+
+void
+Savegame::export_text(const std::string& filename)
+{
+  Writer writer(filename);
+  write_text(writer);
+}
+
+void
+Savegame::write_text(Writer& writer)
+{
+  HSQUIRRELVM vm = scripting::global_vm;
 
   writer.start_list("supertux-savegame");
   writer.write("version", 1);
 
-  using namespace worldmap;
-  if(WorldMap::current() != NULL)
+  std::string title = get_worldmap_title();
+  if(!title.empty())
   {
-    std::ostringstream title;
-    title << WorldMap::current()->get_title();
-    title << " (" << WorldMap::current()->solved_level_count()
-          << "/" << WorldMap::current()->level_count() << ")";
-    writer.write("title", title.str());
+    writer.write("title", title);
   }
 
   writer.start_list("tux");
@@ -19,10 +19,12 @@
 #define HEADER_SUPERTUX_SUPERTUX_SAVEGAME_HPP
 
 #include <memory>
+#include <squirrel.h>
 #include <string>
 #include <vector>
 
 class PlayerStatus;
+class Writer;
 
 struct LevelState
 {
@@ -89,8 +91,19 @@ public:
   void save();
   void load();
 
+  /** Writes the savegame as s-expressions to @c filename, for reading
+      and debugging, load() accepts such files as well */
+  void export_text(const std::string& filename);
+
 private:
   void clear_state_table();
+  void load_text(const char* data, size_t size);
+  void load_binary(const char* data, size_t size);
+  void write_text(Writer& writer);
+
+  /** Encodes the entries of the table @c table in the state table on
+      top of the stack, skipping entries that can't be encoded */
+  void encode_entries(HSQUIRRELVM vm, const char* table, std::string& out);
 
 private:
   Savegame(const Savegame&) = delete;
@@ -41,6 +41,7 @@
 #include "supertux/timer.hpp"
 #include "video/drawing_context.hpp"
 #include "video/renderer.hpp"
+#include "video/texture_manager.hpp"
 
 #include <stdio.h>
 
@@ -418,9 +419,12 @@ ScreenManager::run(DrawingContext &context)
 
       process_events();
       update_gamelogic(timestep);
+      SoundManager::current()->mix_frame();
       frames += 1;
     }
 
+    TextureManager::current()->update();
+
     if (!m_screen_stack.empty())
     {
       draw(context);
@@ -20,6 +20,8 @@
 #include <math.h>
 #include <vector>
 
+#include "scripting/closure_cache.hpp"
+#include "scripting/lazy_object_index.hpp"
 #include "scripting/scripting.hpp"
 #include "scripting/squirrel_util.hpp"
 #include "scripting/sector.hpp"
@@ -28,6 +30,7 @@
 #include "badguy/jumpy.hpp"
 #include "editor/editor.hpp"
 #include "math/aatriangle.hpp"
+#include "object/ambient_sound.hpp"
 #include "object/bullet.hpp"
 #include "object/camera.hpp"
 #include "object/display_effect.hpp"
@@ -37,6 +40,7 @@
 #include "object/text_object.hpp"
 #include "object/tilemap.hpp"
 #include "physfs/ifile_streambuf.hpp"
+#include "supertux/ambient_sound_manager.hpp"
 #include "supertux/collision.hpp"
 #include "supertux/constants.hpp"
 #include "supertux/game_session.hpp"
@@ -69,6 +73,9 @@ Sector::Sector(Level* parent) :
   currentmusic(LEVEL_MUSIC),
   sector_table(),
   scripts(),
+  m_closures(new scripting::ClosureCache),
+  m_script_objects(),
+  m_totals(),
   ambient_light( 1.0f, 1.0f, 1.0f, 1.0f ),
   ambient_light_fading(false),
   source_ambient_light(1.0f, 1.0f, 1.0f, 1.0f),
@@ -85,7 +92,8 @@ Sector::Sector(Level* parent) :
   player(0),
   solid_tilemaps(),
   camera(0),
-  effect(0)
+  effect(0),
+  m_ambient_sounds(new AmbientSoundManager)
 {
   PlayerStatus* player_status;
   if (Editor::is_active()) {
@@ -117,6 +125,8 @@ Sector::Sector(Level* parent) :
     throw scripting::SquirrelError(global_vm, "Couldn't get sector table");
   sq_addref(global_vm, &sector_table);
   sq_pop(global_vm, 1);
+
+  m_script_objects.reset(new LazyObjectIndex(sector_table));
 }
 
 Sector::~Sector()
@@ -131,6 +141,8 @@ Sector::~Sector()
     log_warning << err.what() << std::endl;
   }
 
+  m_closures->release(global_vm);
+  m_script_objects->release();
   release_scripts(global_vm, scripts, sector_table);
 
   update_game_objects();
@@ -154,8 +166,16 @@ Sector::run_script(const std::string& script, const std::string& sourcename)
   {
     return NULL;
   }
-  std::istringstream stream(script);
-  return run_script(stream, sourcename);
+
+  try {
+    return scripting::run_script(script, "Sector " + name + " - " + sourcename,
+                                 scripts, &sector_table, *m_closures);
+  }
+  catch(const std::exception& e)
+  {
+    log_warning << "Error running sector script: " << e.what() << std::endl;
+    return NULL;
+  }
 }
 
 HSQUIRRELVM
@@ -224,9 +244,7 @@ Sector::activate(const Vector& player_pos)
     scripting::store_object(vm, "sector", sector_table);
     sq_pop(vm, 1);
 
-    for(auto& object : gameobjects) {
-      try_expose(object);
-    }
+    m_script_objects->enable();
   }
   try_expose_me();
 
@@ -261,6 +279,11 @@ Sector::activate(const Vector& player_pos)
   player->move(player->get_pos()+(Vector(32, 0)));
   camera->update(1);
 
+  // sounds played by the init script or by objects on activation are
+  // culled against the listener, which still is where the previous
+  // sector left it
+  SoundManager::current()->set_listener_position(camera->get_center());
+
   update_game_objects();
 
   //Run default.nut just before init script
@@ -294,9 +317,7 @@ Sector::deactivate()
   scripting::delete_table_entry(vm, "sector");
   sq_pop(vm, 1);
 
-  for(const auto& object: gameobjects) {
-    try_unexpose(object);
-  }
+  m_script_objects->disable();
 
   try_unexpose_me();
   _current = NULL;
@@ -385,6 +406,10 @@ Sector::update(float elapsed_time)
     object->update(elapsed_time);
   }
 
+  if(camera) {
+    m_ambient_sounds->update(elapsed_time, camera->get_center());
+  }
+
   /* Handle all possible collisions. */
   handle_collisions();
   update_game_objects();
@@ -455,6 +480,11 @@ Sector::before_object_add(GameObjectPtr object)
     solid_tilemaps.push_back(tilemap);
   }
 
+  auto ambient_sound = dynamic_cast<AmbientSound*>(object.get());
+  if(ambient_sound) {
+    m_ambient_sounds->add(ambient_sound);
+  }
+
   auto camera_ = dynamic_cast<Camera*>(object.get());
   if(camera_) {
     if(this->camera != 0) {
@@ -482,19 +512,11 @@ Sector::before_object_add(GameObjectPtr object)
     this->effect = effect_;
   }
 
-  if(_current == this) {
-    try_expose(object);
-  }
+  m_script_objects->add(object);
 
   return true;
 }
 
-void
-Sector::try_expose(GameObjectPtr object)
-{
-  scripting::try_expose(object, sector_table);
-}
-
 void
 Sector::try_expose_me()
 {
@@ -516,20 +538,17 @@ Sector::before_object_remove(GameObjectPtr object)
   if (bullet) {
     bullets.erase(std::find(bullets.begin(), bullets.end(), bullet));
   }
+  auto ambient_sound = dynamic_cast<AmbientSound*>(object.get());
+  if (ambient_sound) {
+    m_ambient_sounds->remove(ambient_sound);
+  }
   auto moving_object = dynamic_cast<MovingObject*>(object.get());
   if (moving_object) {
     moving_objects.erase(
       std::find(moving_objects.begin(), moving_objects.end(), moving_object));
   }
 
-  if(_current == this)
-    try_unexpose(object);
-}
-
-void
-Sector::try_unexpose(GameObjectPtr object)
-{
-  scripting::try_unexpose(object, sector_table);
+  m_script_objects->remove(object);
 }
 
 void
@@ -1211,7 +1230,7 @@ Sector::play_music(MusicType type)
       SoundManager::current()->play_music(music);
       break;
     case HERRING_MUSIC:
-      SoundManager::current()->play_music("music/invincible.ogg");
+      SoundManager::current()->play_music(HERRING_MUSIC_FILE);
       break;
     case HERRING_WARNING_MUSIC:
       SoundManager::current()->stop_music(TUX_INVINCIBLE_TIME_WARNING);
@@ -1242,19 +1261,6 @@ Sector::get_music_type() const
   return currentmusic;
 }
 
-int
-Sector::get_total_badguys() const
-{
-  int total_badguys = 0;
-  for(const auto& object : gameobjects) {
-    auto badguy = dynamic_cast<BadGuy*>(object.get());
-    if (badguy && badguy->countMe)
-      total_badguys++;
-  }
-
-  return total_badguys;
-}
-
 bool
 Sector::inside(const Rectf& rect) const
 {
@@ -18,11 +18,13 @@
 #define HEADER_SUPERTUX_SUPERTUX_SECTOR_HPP
 
 #include <list>
+#include <memory>
 #include <squirrel.h>
 #include <stdint.h>
 
 #include "supertux/direction.hpp"
 #include "supertux/game_object_ptr.hpp"
+#include "supertux/sector_parser.hpp"
 #include "util/writer.hpp"
 #include "video/color.hpp"
 #include "object/anchor_point.hpp"
@@ -31,6 +33,12 @@ namespace collision {
 class Constraints;
 }
 
+namespace scripting {
+class ClosureCache;
+class LazyObjectIndex;
+}
+
+class AmbientSoundManager;
 class Size;
 class Vector;
 class Rectf;
@@ -52,6 +60,9 @@ enum MusicType {
   HERRING_WARNING_MUSIC
 };
 
+/** music file played for HERRING_MUSIC */
+static const char* const HERRING_MUSIC_FILE = "music/invincible.ogg";
+
 /**
  * Represents one of (potentially) multiple, separate parts of a Level.
  *
@@ -127,8 +138,9 @@ public:
   static Sector* current()
   { return _current; }
 
-  /** Get total number of badguys */
-  int get_total_badguys() const;
+  /** Coins, badguys and secret areas the sector was created with, as
+      counted by the SectorParser */
+  const SectorParser::Totals& get_totals() const { return m_totals; }
 
   /** Get total number of GameObjects of given type */
   template<class T> int get_total_count() const
@@ -240,8 +252,6 @@ private:
   void before_object_remove(GameObjectPtr object);
   bool before_object_add(GameObjectPtr object);
 
-  void try_expose(GameObjectPtr object);
-  void try_unexpose(GameObjectPtr object);
   void try_expose_me();
   void try_unexpose_me();
 
@@ -296,6 +306,11 @@ private:
   /// sector scripts
   typedef std::vector<HSQOBJECT> ScriptList;
   ScriptList scripts;
+  /// compiled trigger and init scripts, bound to sector_table
+  std::unique_ptr<scripting::ClosureCache> m_closures;
+  /// named objects, exposed to sector_table when a script looks them up
+  std::unique_ptr<scripting::LazyObjectIndex> m_script_objects;
+  SectorParser::Totals m_totals;
 
   Color ambient_light;
 
@@ -346,6 +361,8 @@ public: // TODO make this private again
   Camera* camera;
   DisplayEffect* effect;
 
+  std::unique_ptr<AmbientSoundManager> m_ambient_sounds;
+
 private:
   Sector(const Sector&);
   Sector& operator=(const Sector&);
@@ -16,6 +16,9 @@
 
 #include "supertux/sector_parser.hpp"
 
+#include <map>
+#include <sstream>
+
 #include "supertux/sector.hpp"
 
 #include "audio/sound_manager.hpp"
@@ -63,7 +66,9 @@
 #include "trigger/sequence_trigger.hpp"
 #include "util/file_system.hpp"
 #include "util/reader_collection.hpp"
+#include "util/reader_document.hpp"
 #include "util/reader_mapping.hpp"
+#include "util/run_length.hpp"
 
 static const std::string DEFAULT_BG_TOP    = "images/background/BlueRock_Forest/blue-top.jpg";
 static const std::string DEFAULT_BG_MIDDLE = "images/background/BlueRock_Forest/blue-middle.jpg";
@@ -96,6 +101,100 @@ SectorParser::from_nothing(Level& level)
   return sector;
 }
 
+SectorParser::Totals
+SectorParser::prescan(const std::string& tileset, const ReaderMapping& sector)
+{
+  Totals totals;
+  auto iter = sector.get_iter();
+  while(iter.next()) {
+    const std::string key = iter.get_key();
+    if(key == "tilemap") {
+      auto tilemap = iter.as_mapping();
+      bool solid = false;
+      tilemap.get("solid", solid);
+      if(solid) {
+        // the object tiles are replaced by objects in fix_old_tiles()
+        prescan_tiles(tileset, tilemap, totals);
+      }
+    } else {
+      count_object(key, iter.as_mapping(), totals);
+    }
+  }
+  return totals;
+}
+
+void
+SectorParser::count_object(const std::string& name, const ReaderMapping& reader, Totals& totals)
+{
+  if(name == "coin" || name == "heavycoin") {
+    totals.coins += 1;
+  } else if(name == "bonusblock") {
+    totals.coins += BonusBlock::count_total_coins(reader);
+  } else if(name == "goldbomb") {
+    totals.coins += 10;
+  } else if(name == "secretarea") {
+    totals.secrets += 1;
+  }
+
+  if(name == "money" || ObjectFactory::instance().is_counted_badguy(name)) {
+    totals.badguys += 1;
+  }
+}
+
+void
+SectorParser::count_tile_object(const Tile& tile, Totals& totals)
+{
+  if(tile.get_object_name().empty())
+    return;
+
+  // same text as ObjectFactory::create() builds for the tile
+  std::stringstream lisptext;
+  lisptext << "(" << tile.get_object_name() << "\n"
+           << " (x 0) (y 0)" << tile.get_object_data() << ")";
+  try {
+    auto doc = ReaderDocument::parse(lisptext);
+    count_object(tile.get_object_name(), doc.get_root().get_mapping(), totals);
+  } catch(std::exception& e) {
+    log_warning << e.what() << std::endl;
+  }
+}
+
+void
+SectorParser::prescan_tiles(const std::string& tileset_name, const ReaderMapping& tilemap, Totals& totals)
+{
+  std::vector<uint32_t> tiles;
+  std::vector<unsigned int> runs;
+  if(tilemap.get("tiles-rle", runs)) {
+    int width = 0;
+    int height = 0;
+    if(!tilemap.get("width", width) || !tilemap.get("height", height) ||
+       width < 0 || height < 0 ||
+       !RunLength::decode(runs, size_t(width) * size_t(height), tiles))
+      return;
+  } else if(!tilemap.get("tiles", tiles)) {
+    return;
+  }
+
+  auto tileset = TileManager::current()->get_tileset(tileset_name);
+  std::map<uint32_t, Totals> tile_totals;
+  for(const auto& id : tiles) {
+    if(id == 0)
+      continue;
+
+    auto it = tile_totals.find(id);
+    if(it == tile_totals.end()) {
+      Totals object_totals;
+      const Tile* tile = tileset->get(id);
+      if(tile) {
+        count_tile_object(*tile, object_totals);
+      }
+      it = tile_totals.insert(std::make_pair(id, object_totals)).first;
+    }
+
+    totals += it->second;
+  }
+}
+
 SectorParser::SectorParser(Sector& sector) :
   m_sector(sector)
 {
@@ -104,20 +203,26 @@ SectorParser::SectorParser(Sector& sector) :
 GameObjectPtr
 SectorParser::parse_object(const std::string& name_, const ReaderMapping& reader)
 {
+  GameObjectPtr object;
   if(name_ == "camera") {
     auto camera_ = std::make_shared<Camera>(&m_sector, "Camera");
     camera_->parse(reader);
     return camera_;
   } else if(name_ == "money") { // for compatibility with old maps
-    return std::make_shared<Jumpy>(reader);
+    object = std::make_shared<Jumpy>(reader);
   } else {
     try {
-      return ObjectFactory::instance().create(name_, reader);
+      object = ObjectFactory::instance().create(name_, reader);
     } catch(std::exception& e) {
       log_warning << e.what() << "" << std::endl;
       return {};
     }
   }
+
+  if(object) {
+    count_object(name_, reader, m_sector.m_totals);
+  }
+  return object;
 }
 
 void
@@ -361,6 +466,7 @@ SectorParser::parse_old_format(const ReaderMapping& reader)
 void
 SectorParser::fix_old_tiles()
 {
+  std::map<const Tile*, Totals> tile_totals;
   for(const auto& solids : m_sector.solid_tilemaps) {
     for(size_t x=0; x < solids->get_width(); ++x) {
       for(size_t y=0; y < solids->get_height(); ++y) {
@@ -372,6 +478,14 @@ SectorParser::fix_old_tiles()
             GameObjectPtr object = ObjectFactory::instance().create(tile->get_object_name(), pos, AUTO, tile->get_object_data());
             m_sector.add_object(object);
             solids->change(x, y, 0);
+
+            auto it = tile_totals.find(tile);
+            if(it == tile_totals.end()) {
+              Totals object_totals;
+              count_tile_object(*tile, object_totals);
+              it = tile_totals.insert(std::make_pair(tile, object_totals)).first;
+            }
+            m_sector.m_totals += it->second;
           } catch(std::exception& e) {
             log_warning << e.what() << "" << std::endl;
           }
@@ -25,14 +25,40 @@
 class Level;
 class ReaderMapping;
 class Sector;
+class Tile;
 
 class SectorParser
 {
+public:
+  /** What a sector adds to the level's totals, see Level::get_total_coins().
+      Counted by count_object() for loaded and pre-scanned sectors alike. */
+  struct Totals
+  {
+    Totals() : coins(0), badguys(0), secrets(0) {}
+
+    Totals& operator+=(const Totals& other)
+    {
+      coins += other.coins;
+      badguys += other.badguys;
+      secrets += other.secrets;
+      return *this;
+    }
+
+    int coins;
+    int badguys;
+    int secrets;
+  };
+
 public:
   static std::unique_ptr<Sector> from_reader(Level& level, const ReaderMapping& sector);
   static std::unique_ptr<Sector> from_reader_old_format(Level& level, const ReaderMapping& sector);
   static std::unique_ptr<Sector> from_nothing(Level& level);
 
+  /** Counts the coins, badguys and secret areas the sector would
+      contain without creating any of its objects. @c tileset is the
+      tileset of the level, needed for tiles that turn into objects. */
+  static Totals prescan(const std::string& tileset, const ReaderMapping& sector);
+
 private:
   SectorParser(Sector& sector);
 
@@ -42,6 +68,12 @@ private:
   void create_sector();
   GameObjectPtr parse_object(const std::string& name_, const ReaderMapping& reader);
 
+  /** The counting rules for an object read as @c name from @c reader */
+  static void count_object(const std::string& name, const ReaderMapping& reader, Totals& totals);
+  /** Counts the object that fix_old_tiles() creates for @c tile */
+  static void count_tile_object(const Tile& tile, Totals& totals);
+  static void prescan_tiles(const std::string& tileset, const ReaderMapping& tilemap, Totals& totals);
+
 private:
   Sector& m_sector;
 
@@ -25,6 +25,7 @@
 #include "scripting/squirrel_util.hpp"
 #include "supertux/globals.hpp"
 #include "supertux/resources.hpp"
+#include "util/cached_translation.hpp"
 #include "util/gettext.hpp"
 #include "video/drawing_context.hpp"
 
@@ -139,7 +140,8 @@ Statistics::draw_worldmap_info(DrawingContext& context, float target_time)
     WMAP_INFO_TOP_Y2 = WMAP_INFO_TOP_Y1 + 16;
   }
 
-  context.draw_text(Resources::small_font, std::string("- ") + _("Best Level Statistics") + " -",
+  static CachedTranslation header_text("Best Level Statistics");
+  context.draw_text(Resources::small_font, "- " + header_text.get() + " -",
                     Vector((WMAP_INFO_LEFT_X + WMAP_INFO_RIGHT_X) / 2, WMAP_INFO_TOP_Y1),
                     ALIGN_CENTER, LAYER_HUD,Statistics::header_color);
 
@@ -219,16 +221,23 @@ Statistics::draw_endseq_panel(DrawingContext& context, Statistics* best_stats, S
   int row4_y = row3_y+20;
   int row5_y = row4_y+20;
 
+  static CachedTranslation you_text("You");
+  static CachedTranslation best_text("Best");
+  static CachedTranslation coins_text("Coins");
+  static CachedTranslation badguys_text("Badguys");
+  static CachedTranslation secrets_text("Secrets");
+  static CachedTranslation time_text("Time");
+
   context.push_transform();
   context.set_alpha(0.5);
   context.draw_surface(backdrop, Vector(bd_x, bd_y), LAYER_HUD);
   context.pop_transform();
 
-  context.draw_text(Resources::normal_font, _("You"), Vector(col2_x, row1_y), ALIGN_LEFT, LAYER_HUD, Statistics::header_color);
+  context.draw_text(Resources::normal_font, you_text.get(), Vector(col2_x, row1_y), ALIGN_LEFT, LAYER_HUD, Statistics::header_color);
   if (best_stats)
-    context.draw_text(Resources::normal_font, _("Best"), Vector(col3_x, row1_y), ALIGN_LEFT, LAYER_HUD, Statistics::header_color);
+    context.draw_text(Resources::normal_font, best_text.get(), Vector(col3_x, row1_y), ALIGN_LEFT, LAYER_HUD, Statistics::header_color);
 
-  context.draw_text(Resources::normal_font, _("Coins"), Vector(col2_x-16, row3_y), ALIGN_RIGHT, LAYER_HUD, Statistics::header_color);
+  context.draw_text(Resources::normal_font, coins_text.get(), Vector(col2_x-16, row3_y), ALIGN_RIGHT, LAYER_HUD, Statistics::header_color);
   context.draw_text(Resources::normal_font, coins_to_string(coins, total_coins), Vector(col2_x, row3_y), ALIGN_LEFT, LAYER_HUD, Statistics::text_color);
   if (best_stats) {
     int coins_best = (best_stats->coins > coins) ? best_stats->coins : coins;
@@ -236,7 +245,7 @@ Statistics::draw_endseq_panel(DrawingContext& context, Statistics* best_stats, S
     context.draw_text(Resources::normal_font, coins_to_string(coins_best, total_coins_best), Vector(col3_x, row3_y), ALIGN_LEFT, LAYER_HUD, Statistics::text_color);
   }
 
-  context.draw_text(Resources::normal_font, _("Badguys"), Vector(col2_x-16, row4_y), ALIGN_RIGHT, LAYER_HUD, Statistics::header_color);
+  context.draw_text(Resources::normal_font, badguys_text.get(), Vector(col2_x-16, row4_y), ALIGN_RIGHT, LAYER_HUD, Statistics::header_color);
   context.draw_text(Resources::normal_font, frags_to_string(badguys, total_badguys), Vector(col2_x, row4_y), ALIGN_LEFT, LAYER_HUD, Statistics::text_color);
   if (best_stats) {
 	int badguys_best = (best_stats->badguys > badguys) ? best_stats->badguys : badguys;
@@ -244,7 +253,7 @@ Statistics::draw_endseq_panel(DrawingContext& context, Statistics* best_stats, S
 	context.draw_text(Resources::normal_font, frags_to_string(badguys_best, total_badguys_best), Vector(col3_x, row4_y), ALIGN_LEFT, LAYER_HUD, Statistics::text_color);
   }
 
-  context.draw_text(Resources::normal_font, _("Secrets"), Vector(col2_x-16, row5_y), ALIGN_RIGHT, LAYER_HUD, Statistics::header_color);
+  context.draw_text(Resources::normal_font, secrets_text.get(), Vector(col2_x-16, row5_y), ALIGN_RIGHT, LAYER_HUD, Statistics::header_color);
   context.draw_text(Resources::normal_font, secrets_to_string(secrets, total_secrets), Vector(col2_x, row5_y), ALIGN_LEFT, LAYER_HUD, Statistics::text_color);
   if (best_stats) {
     int secrets_best = (best_stats->secrets > secrets) ? best_stats->secrets : secrets;
@@ -252,7 +261,7 @@ Statistics::draw_endseq_panel(DrawingContext& context, Statistics* best_stats, S
     context.draw_text(Resources::normal_font, secrets_to_string(secrets_best, total_secrets_best), Vector(col3_x, row5_y), ALIGN_LEFT, LAYER_HUD, Statistics::text_color);
   }
 
-  context.draw_text(Resources::normal_font, _("Time"), Vector(col2_x-16, row2_y), ALIGN_RIGHT, LAYER_HUD, Statistics::header_color);
+  context.draw_text(Resources::normal_font, time_text.get(), Vector(col2_x-16, row2_y), ALIGN_RIGHT, LAYER_HUD, Statistics::header_color);
   context.draw_text(Resources::normal_font, time_to_string(time), Vector(col2_x, row2_y), ALIGN_LEFT, LAYER_HUD, Statistics::text_color);
   if (best_stats) {
     float time_best = (best_stats->time < time) ? best_stats->time : time;
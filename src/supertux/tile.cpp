@@ -102,6 +102,16 @@ Tile::load_images()
   }
 }
 
+void
+Tile::get_pending_image_files(std::vector<std::string>& files) const
+{
+  if(images.size() == 0)
+  {
+    for(const auto& spec : imagespecs)
+      files.push_back(spec.file);
+  }
+}
+
 SurfacePtr
 Tile::get_current_image() const
 {
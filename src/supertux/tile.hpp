@@ -127,6 +127,9 @@ public:
   /** load Surfaces, if not already loaded */
   void load_images();
 
+  /** append the image files load_images() would still have to load */
+  void get_pending_image_files(std::vector<std::string>& files) const;
+
   SurfacePtr get_current_image() const;
 
   /** Draw a tile on the screen */
@@ -138,6 +141,15 @@ public:
   int getData() const
   { return data; }
 
+  float get_fps() const
+  { return fps; }
+
+  const std::vector<ImageSpec>& get_imagespecs() const
+  { return imagespecs; }
+
+  const std::vector<ImageSpec>& get_editor_imagespecs() const
+  { return editor_imagespecs; }
+
   /** Checks the SLOPE attribute. Returns "true" if set, "false" otherwise. */
   bool is_slope() const
   {
@@ -16,12 +16,16 @@
 
 #include "supertux/tile_set.hpp"
 
+#include <algorithm>
+#include <chrono>
+
 #include "editor/editor.hpp"
 #include "supertux/resources.hpp"
 #include "supertux/tile_set_parser.hpp"
 #include "util/gettext.hpp"
 #include "video/drawing_context.hpp"
 #include "video/surface.hpp"
+#include "video/texture_manager.hpp"
 
 Tilegroup::Tilegroup() :
   developers_group(),
@@ -58,9 +62,16 @@ TileSet::TileSet() :
 TileSet::TileSet(const std::string& filename) :
   TileSet()
 {
+  typedef std::chrono::steady_clock Clock;
+  Clock::time_point start = Clock::now();
+
   TileSetParser parser(*this, filename);
   parser.parse();
 
+  auto usec = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+  log_debug << "Loaded tileset '" << filename << "' " << (parser.from_cache() ? "from cache" : "from source")
+            << " in " << usec / 1000.0 << " ms" << std::endl;
+
   if (0)
   { // enable this if you want to see a list of free tiles
     log_info << "Last Tile ID is " << m_tiles.size()-1 << std::endl;
@@ -126,6 +137,25 @@ TileSet::get(const uint32_t id) const
   }
 }
 
+void
+TileSet::prefetch(const std::vector<uint32_t>& ids) const
+{
+  std::vector<bool> seen(m_tiles.size(), false);
+  std::vector<std::string> files;
+  for(const auto& id : ids)
+  {
+    if(id < m_tiles.size() && !seen[id] && m_tiles[id])
+    {
+      seen[id] = true;
+      m_tiles[id]->get_pending_image_files(files);
+    }
+  }
+
+  std::sort(files.begin(), files.end());
+  files.erase(std::unique(files.begin(), files.end()), files.end());
+  TextureManager::current()->prefetch(files);
+}
+
 void
 TileSet::draw_tile(DrawingContext& context, uint32_t id, const Vector& pos,
                    int z_pos, Color color) const
@@ -38,6 +38,8 @@ class Tilegroup {
 
 class TileSet
 {
+  friend class TileSetCache;
+
 private:
   std::vector<std::unique_ptr<Tile> > m_tiles;
   SurfacePtr notile_surface;
@@ -57,6 +59,9 @@ public:
 
   const Tile* get(const uint32_t id) const;
 
+  /** Start decoding the images of the given tiles in the background */
+  void prefetch(const std::vector<uint32_t>& ids) const;
+
   /**
    * Adds a group of tiles that haven't
    * been assigned to any other group
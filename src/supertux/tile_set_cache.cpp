@@ -0,0 +1,402 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "supertux/tile_set_cache.hpp"
+
+#include <physfs.h>
+#include <stdio.h>
+#include <string.h>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#include "physfs/physfs_file_system.hpp"
+#include "supertux/tile.hpp"
+#include "supertux/tile_set.hpp"
+#include "util/gettext.hpp"
+#include "util/log.hpp"
+#include "util/mapped_file.hpp"
+
+namespace {
+
+/** Layout of the start of a cache entry. It is followed by the
+    tileset path and then the record arrays and the string table in
+    the order of the counts below. Entries are only read back on the
+    machine that wrote them, so native byte order is fine. */
+struct EntryHeader
+{
+  char magic[4];
+  uint32_t version;
+  uint64_t hash;
+  uint32_t path_length;
+  uint32_t tile_count;
+  uint32_t image_count;
+  uint32_t tilegroup_count;
+  uint32_t group_tile_count;
+  uint32_t strings_size;
+};
+
+/** A string in the string table */
+struct StringRef
+{
+  uint32_t offset;
+  uint32_t length;
+};
+
+struct TileRecord
+{
+  uint32_t id;
+  uint32_t attributes;
+  uint32_t data;
+  float fps;
+  StringRef object_name;
+  StringRef object_data;
+  /** the images are followed by the editor images */
+  uint32_t first_image;
+  uint32_t image_count;
+  uint32_t editor_image_count;
+};
+
+struct ImageRecord
+{
+  StringRef file;
+  float left;
+  float top;
+  float right;
+  float bottom;
+};
+
+struct TilegroupRecord
+{
+  StringRef name;
+  uint32_t first_tile;
+  uint32_t tile_count;
+};
+
+const char entry_magic[4] = { 'S', 'T', 'T', 'C' };
+
+uint64_t fnv1a(const char* data, size_t size, uint64_t hash = 14695981039346656037ULL)
+{
+  for(size_t i = 0; i < size; ++i)
+  {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+/** Collects the strings of an entry, file names are shared by many
+    tiles and only stored once */
+class StringTable
+{
+public:
+  StringTable() : m_data(), m_offsets() {}
+
+  StringRef add(const std::string& str)
+  {
+    StringRef ref;
+    ref.length = static_cast<uint32_t>(str.size());
+    auto it = m_offsets.find(str);
+    if(it != m_offsets.end())
+    {
+      ref.offset = it->second;
+    }
+    else
+    {
+      ref.offset = static_cast<uint32_t>(m_data.size());
+      m_data.insert(m_data.end(), str.begin(), str.end());
+      m_offsets[str] = ref.offset;
+    }
+    return ref;
+  }
+
+  const std::vector<char>& get_data() const { return m_data; }
+
+private:
+  std::vector<char> m_data;
+  std::map<std::string, uint32_t> m_offsets;
+};
+
+template<typename T>
+void write_records(std::ostream& out, const std::vector<T>& records)
+{
+  if(!records.empty())
+    out.write(reinterpret_cast<const char*>(records.data()), sizeof(T) * records.size());
+}
+
+/** Copies @c count records starting at @c pos, returns false if the
+    entry is too short */
+template<typename T>
+bool read_records(const char* data, size_t size, size_t& pos, uint32_t count, std::vector<T>& records)
+{
+  size_t bytes = sizeof(T) * size_t(count);
+  if(size < pos || size - pos < bytes)
+    return false;
+
+  records.resize(count);
+  if(bytes)
+    memcpy(records.data(), data + pos, bytes);
+  pos += bytes;
+  return true;
+}
+
+} // namespace
+
+uint64_t
+TileSetCache::hash(const char* data, size_t size)
+{
+  uint64_t result = fnv1a(data, size);
+  if(g_dictionary_manager)
+  {
+    const std::string& language = g_dictionary_manager->get_language().get_language();
+    result = fnv1a(language.data(), language.size(), result);
+  }
+  return result;
+}
+
+TileSetCache::TileSetCache(const std::string& directory) :
+  m_directory()
+{
+  if(!PhysFSFileSystem::mkdir(directory))
+  {
+    log_warning << "Couldn't create tileset cache directory '" << directory << "': "
+                << PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()) << std::endl;
+    return;
+  }
+
+  const char* writedir = PHYSFS_getWriteDir();
+  if(writedir)
+  {
+    m_directory = std::string(writedir) + "/" + directory;
+  }
+}
+
+std::string
+TileSetCache::get_entry_path(const std::string& filename) const
+{
+  char name[32];
+  uint64_t path_hash = fnv1a(filename.data(), filename.size());
+  snprintf(name, sizeof(name), "%016llx.stc", static_cast<unsigned long long>(path_hash));
+  return m_directory + "/" + name;
+}
+
+bool
+TileSetCache::load(const std::string& filename, uint64_t hash, TileSet& tileset) const
+{
+  MappedFile entry;
+  if(m_directory.empty() ||
+     !entry.open(get_entry_path(filename)) ||
+     entry.get_size() < sizeof(EntryHeader))
+  {
+    return false;
+  }
+
+  const char* data = entry.get_data();
+  size_t size = entry.get_size();
+
+  EntryHeader header;
+  memcpy(&header, data, sizeof(header));
+  if(memcmp(header.magic, entry_magic, sizeof(entry_magic)) != 0 ||
+     header.version != VERSION ||
+     header.hash != hash ||
+     header.path_length != filename.size() ||
+     size - sizeof(header) < header.path_length ||
+     filename.compare(0, std::string::npos, data + sizeof(header), header.path_length) != 0)
+  {
+    return false;
+  }
+
+  size_t pos = sizeof(header) + header.path_length;
+  std::vector<TileRecord> tiles;
+  std::vector<ImageRecord> images;
+  std::vector<TilegroupRecord> tilegroups;
+  std::vector<int32_t> group_tiles;
+  if(!read_records(data, size, pos, header.tile_count, tiles) ||
+     !read_records(data, size, pos, header.image_count, images) ||
+     !read_records(data, size, pos, header.tilegroup_count, tilegroups) ||
+     !read_records(data, size, pos, header.group_tile_count, group_tiles) ||
+     size - pos < header.strings_size)
+  {
+    return false;
+  }
+
+  const char* strings = data + pos;
+  auto get_string = [&](const StringRef& ref, std::string& result) {
+    if(ref.offset > header.strings_size || header.strings_size - ref.offset < ref.length)
+      return false;
+    result.assign(strings + ref.offset, ref.length);
+    return true;
+  };
+
+  // validate everything before touching the tileset
+  for(const auto& tile : tiles)
+  {
+    if(tile.first_image > images.size() ||
+       images.size() - tile.first_image < size_t(tile.image_count) + tile.editor_image_count)
+      return false;
+  }
+  for(const auto& group : tilegroups)
+  {
+    if(group.first_tile > group_tiles.size() ||
+       group_tiles.size() - group.first_tile < group.tile_count)
+      return false;
+  }
+
+  std::vector<std::string> files(images.size());
+  std::vector<Tile::ImageSpec> specs;
+  specs.reserve(images.size());
+  for(size_t i = 0; i < images.size(); ++i)
+  {
+    if(!get_string(images[i].file, files[i]))
+      return false;
+    specs.push_back(Tile::ImageSpec(files[i], Rectf(images[i].left, images[i].top,
+                                                    images[i].right, images[i].bottom)));
+  }
+
+  std::vector<std::unique_ptr<Tile> > new_tiles;
+  new_tiles.reserve(tiles.size());
+  for(const auto& tile : tiles)
+  {
+    std::string object_name;
+    std::string object_data;
+    if(!get_string(tile.object_name, object_name) ||
+       !get_string(tile.object_data, object_data))
+      return false;
+
+    auto first = specs.begin() + tile.first_image;
+    auto editor_first = first + tile.image_count;
+    std::vector<Tile::ImageSpec> tile_specs(first, editor_first);
+    std::vector<Tile::ImageSpec> editor_specs(editor_first, editor_first + tile.editor_image_count);
+    new_tiles.push_back(std::unique_ptr<Tile>(new Tile(tile_specs, editor_specs,
+                                                       tile.attributes, tile.data, tile.fps,
+                                                       object_name, object_data)));
+  }
+
+  std::vector<Tilegroup> new_groups(tilegroups.size());
+  for(size_t i = 0; i < tilegroups.size(); ++i)
+  {
+    if(!get_string(tilegroups[i].name, new_groups[i].name))
+      return false;
+    auto first = group_tiles.begin() + tilegroups[i].first_tile;
+    new_groups[i].tiles.assign(first, first + tilegroups[i].tile_count);
+  }
+
+  for(size_t i = 0; i < tiles.size(); ++i)
+  {
+    tileset.add_tile(tiles[i].id, std::move(new_tiles[i]));
+  }
+  tileset.tilegroups.insert(tileset.tilegroups.end(), new_groups.begin(), new_groups.end());
+  return true;
+}
+
+void
+TileSetCache::store(const std::string& filename, uint64_t hash, const TileSet& tileset) const
+{
+  if(m_directory.empty())
+    return;
+
+  StringTable strings;
+  std::vector<TileRecord> tiles;
+  std::vector<ImageRecord> images;
+  std::vector<TilegroupRecord> tilegroups;
+  std::vector<int32_t> group_tiles;
+
+  auto add_images = [&](const std::vector<Tile::ImageSpec>& specs) {
+    for(const auto& spec : specs)
+    {
+      ImageRecord image;
+      image.file = strings.add(spec.file);
+      image.left = spec.rect.get_left();
+      image.top = spec.rect.get_top();
+      image.right = spec.rect.get_right();
+      image.bottom = spec.rect.get_bottom();
+      images.push_back(image);
+    }
+    return static_cast<uint32_t>(specs.size());
+  };
+
+  // tile 0 is the empty tile every TileSet starts with
+  for(size_t id = 1; id < tileset.m_tiles.size(); ++id)
+  {
+    const Tile* tile = tileset.m_tiles[id].get();
+    if(!tile)
+      continue;
+
+    TileRecord record;
+    record.id = static_cast<uint32_t>(id);
+    record.attributes = tile->getAttributes();
+    record.data = static_cast<uint32_t>(tile->getData());
+    record.fps = tile->get_fps();
+    record.object_name = strings.add(tile->get_object_name());
+    record.object_data = strings.add(tile->get_object_data());
+    record.first_image = static_cast<uint32_t>(images.size());
+    record.image_count = add_images(tile->get_imagespecs());
+    record.editor_image_count = add_images(tile->get_editor_imagespecs());
+    tiles.push_back(record);
+  }
+
+  for(const auto& group : tileset.tilegroups)
+  {
+    TilegroupRecord record;
+    record.name = strings.add(group.name);
+    record.first_tile = static_cast<uint32_t>(group_tiles.size());
+    record.tile_count = static_cast<uint32_t>(group.tiles.size());
+    group_tiles.insert(group_tiles.end(), group.tiles.begin(), group.tiles.end());
+    tilegroups.push_back(record);
+  }
+
+  EntryHeader header;
+  memcpy(header.magic, entry_magic, sizeof(entry_magic));
+  header.version = VERSION;
+  header.hash = hash;
+  header.path_length = static_cast<uint32_t>(filename.size());
+  header.tile_count = static_cast<uint32_t>(tiles.size());
+  header.image_count = static_cast<uint32_t>(images.size());
+  header.tilegroup_count = static_cast<uint32_t>(tilegroups.size());
+  header.group_tile_count = static_cast<uint32_t>(group_tiles.size());
+  header.strings_size = static_cast<uint32_t>(strings.get_data().size());
+
+  // write to a temporary file first so a crash never leaves a
+  // truncated entry behind
+  std::string path = get_entry_path(filename);
+  std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream out(tmp_path.c_str(), std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(filename.data(), filename.size());
+    write_records(out, tiles);
+    write_records(out, images);
+    write_records(out, tilegroups);
+    write_records(out, group_tiles);
+    write_records(out, strings.get_data());
+    if(!out)
+    {
+      log_debug << "Couldn't write tileset cache entry for '" << filename << "'" << std::endl;
+      out.close();
+      remove(tmp_path.c_str());
+      return;
+    }
+  }
+
+  remove(path.c_str());
+  if(rename(tmp_path.c_str(), path.c_str()) != 0)
+  {
+    remove(tmp_path.c_str());
+  }
+}
+
+/* EOF */
@@ -0,0 +1,66 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADER_SUPERTUX_SUPERTUX_TILE_SET_CACHE_HPP
+#define HEADER_SUPERTUX_SUPERTUX_TILE_SET_CACHE_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+class TileSet;
+
+/** Compiled form of parsed tilesets in the user directory. An entry
+    holds the tiles (attributes, data, fps, image specs) and tilegroups
+    of one .strf file as flat record arrays plus a string table, so
+    loading it is a few memcpy()s instead of a full s-expression parse.
+    Entries are only used while the hash of the tileset file contents
+    still matches. */
+class TileSetCache
+{
+public:
+  /** bump whenever the entry layout changes */
+  static const int VERSION = 1;
+
+  /** Hash of the tileset file contents that entries are validated
+      against, the current language is mixed in as tilegroup names
+      are stored translated */
+  static uint64_t hash(const char* data, size_t size);
+
+  /** @param directory  PhysFS directory below the write dir */
+  TileSetCache(const std::string& directory);
+
+  /** Adds the cached tiles and tilegroups of @c filename to
+      @c tileset, returns false if there is no valid entry */
+  bool load(const std::string& filename, uint64_t hash, TileSet& tileset) const;
+
+  /** Writes the tiles and tilegroups of @c tileset to the cache */
+  void store(const std::string& filename, uint64_t hash, const TileSet& tileset) const;
+
+private:
+  std::string get_entry_path(const std::string& filename) const;
+
+private:
+  std::string m_directory;
+
+private:
+  TileSetCache(const TileSetCache&) = delete;
+  TileSetCache& operator=(const TileSetCache&) = delete;
+};
+
+#endif
+
+/* EOF */
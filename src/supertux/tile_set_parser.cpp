@@ -24,9 +24,11 @@
 #include <sexp/io.hpp>
 
 #include "editor/editor.hpp"
+#include "physfs/physfs_file_data.hpp"
 #include "supertux/gameconfig.hpp"
 #include "supertux/globals.hpp"
 #include "supertux/tile_set.hpp"
+#include "supertux/tile_set_cache.hpp"
 #include "util/reader_document.hpp"
 #include "util/reader_mapping.hpp"
 #include "util/file_system.hpp"
@@ -34,7 +36,8 @@
 TileSetParser::TileSetParser(TileSet& tileset, const std::string& filename) :
   m_tileset(tileset),
   m_filename(filename),
-  m_tiles_path()
+  m_tiles_path(),
+  m_from_cache(false)
 {
 }
 
@@ -43,7 +46,26 @@ TileSetParser::parse()
 {
   m_tiles_path = FileSystem::dirname(m_filename);
 
-  auto doc = ReaderDocument::parse(m_filename);
+  PhysFSFileData file(m_filename);
+  uint64_t hash = TileSetCache::hash(file.get_data(), file.get_size());
+  TileSetCache cache("cache/tilesets");
+  m_from_cache = cache.load(m_filename, hash, m_tileset);
+  if(!m_from_cache)
+  {
+    parse(file.get_data(), file.get_size());
+    cache.store(m_filename, hash, m_tileset);
+  }
+
+  if(g_config->developer_mode)
+  {
+    m_tileset.add_unassigned_tilegroup();
+  }
+}
+
+void
+TileSetParser::parse(const char* data, size_t size)
+{
+  auto doc = ReaderDocument::parse(data, size, m_filename);
   auto root = doc.get_root();
 
   if(root.get_name() != "supertux-tiles") {
@@ -77,10 +99,6 @@ TileSetParser::parse()
       log_warning << "Unknown symbol '" << iter.get_key() << "' in tileset file" << std::endl;
     }
   }
-  if(g_config->developer_mode)
-  {
-    m_tileset.add_unassigned_tilegroup();
-  }
 }
 
 void
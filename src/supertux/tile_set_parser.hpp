@@ -18,6 +18,7 @@
 #ifndef HEADER_SUPERTUX_SUPERTUX_TILE_SET_PARSER_HPP
 #define HEADER_SUPERTUX_SUPERTUX_TILE_SET_PARSER_HPP
 
+#include <stddef.h>
 #include <string>
 #include <stdint.h>
 #include <vector>
@@ -34,13 +35,20 @@ private:
   TileSet&    m_tileset;
   std::string m_filename;
   std::string m_tiles_path;
+  bool        m_from_cache;
 
 public:
   TileSetParser(TileSet& tileset, const std::string& filename);
 
+  /** Loads the tileset from the tileset cache if it has a valid
+      entry for the file, parses it and refreshes the entry otherwise */
   void parse();
 
+  /** true if the last parse() was served from the tileset cache */
+  bool from_cache() const { return m_from_cache; }
+
 private:
+  void parse(const char* data, size_t size);
   void parse_tile(const ReaderMapping& reader);
   void parse_tiles(const ReaderMapping& reader);
   std::vector<Tile::ImageSpec> parse_imagespecs(const ReaderMapping& cur) const;
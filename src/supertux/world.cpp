@@ -110,7 +110,7 @@ World::load_(const std::string& directory)
 
   std::string filename = m_basedir + "/info";
 
-  if(!PHYSFS_exists(filename.c_str()) ||
+  if(!PhysFSFileSystem::exists(filename) ||
      PhysFSFileSystem::is_directory(filename))
   {
     set_default_values();
@@ -178,7 +178,7 @@ World::save(bool retry)
       std::string dirname = FileSystem::dirname(filepath);
       if(!PHYSFS_exists(dirname.c_str()))
       {
-        if(!PHYSFS_mkdir(dirname.c_str()))
+        if(!PhysFSFileSystem::mkdir(dirname))
         {
           std::ostringstream msg;
           msg << "Couldn't create directory for levelset '"
@@ -214,7 +214,7 @@ World::save(bool retry)
       log_warning << "Failed to save the levelset info, retrying..." << std::endl;
       { // create the levelset directory again
         std::string dirname = FileSystem::dirname(filepath);
-        if(!PHYSFS_mkdir(dirname.c_str()))
+        if(!PhysFSFileSystem::mkdir(dirname))
         {
           std::ostringstream msg;
           msg << "Couldn't create directory for levelset '"
@@ -0,0 +1,388 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "util/binary_sexp.hpp"
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+namespace BinarySexp {
+
+namespace {
+
+const char magic[4] = { 'S', 'T', 'L', 'B' };
+
+enum Tag
+{
+  TAG_NIL,
+  TAG_FALSE,
+  TAG_TRUE,
+  TAG_INTEGER,
+  TAG_REAL,
+  TAG_STRING,
+  TAG_SYMBOL,
+  TAG_ARRAY,
+  /** a list whose head is followed by integers only, e.g. (tiles 1 2 3) */
+  TAG_INTEGER_ARRAY
+};
+
+/** lists of at least this many integers are stored packed */
+const size_t min_packed_integers = 8;
+
+class Encoder
+{
+public:
+  Encoder() :
+    m_symbols(),
+    m_symbol_table(),
+    m_body()
+  {}
+
+  void write_value(const sexp::Value& sx)
+  {
+    if (sx.is_nil())
+    {
+      write_u8(TAG_NIL);
+    }
+    else if (sx.is_boolean())
+    {
+      write_u8(sx.as_bool() ? TAG_TRUE : TAG_FALSE);
+    }
+    else if (sx.is_integer())
+    {
+      write_u8(TAG_INTEGER);
+      write_u32(static_cast<uint32_t>(sx.as_int()));
+    }
+    else if (sx.is_real())
+    {
+      float value = sx.as_float();
+      uint32_t bits;
+      memcpy(&bits, &value, sizeof(bits));
+      write_u8(TAG_REAL);
+      write_u32(bits);
+    }
+    else if (sx.is_string())
+    {
+      write_u8(TAG_STRING);
+      write_string(m_body, sx.as_string());
+    }
+    else if (sx.is_symbol())
+    {
+      write_u8(TAG_SYMBOL);
+      write_u32(intern(sx.as_string()));
+    }
+    else if (sx.is_array())
+    {
+      const auto& arr = sx.as_array();
+      if (is_integer_list(arr))
+      {
+        write_u8(TAG_INTEGER_ARRAY);
+        write_value(arr[0]);
+        write_u32(static_cast<uint32_t>(arr.size() - 1));
+        for (size_t i = 1; i < arr.size(); ++i)
+          write_u32(static_cast<uint32_t>(arr[i].as_int()));
+      }
+      else
+      {
+        write_u8(TAG_ARRAY);
+        write_u32(static_cast<uint32_t>(arr.size()));
+        for (const auto& item : arr)
+          write_value(item);
+      }
+    }
+    else
+    {
+      throw std::runtime_error("BinarySexp: can't encode cons cells, parse with USE_ARRAYS");
+    }
+  }
+
+  void finish(std::ostream& out, uint64_t stamp)
+  {
+    std::string header(magic, sizeof(magic));
+    append_u32(header, VERSION);
+    append_u32(header, static_cast<uint32_t>(stamp & 0xffffffff));
+    append_u32(header, static_cast<uint32_t>(stamp >> 32));
+    append_u32(header, static_cast<uint32_t>(m_symbol_table.size()));
+    for (const auto& symbol : m_symbol_table)
+      write_string(header, symbol);
+
+    out.write(header.data(), header.size());
+    out.write(m_body.data(), m_body.size());
+  }
+
+private:
+  static bool is_integer_list(const std::vector<sexp::Value>& arr)
+  {
+    if (arr.size() < min_packed_integers + 1)
+      return false;
+
+    for (size_t i = 1; i < arr.size(); ++i)
+    {
+      if (!arr[i].is_integer())
+        return false;
+    }
+    return true;
+  }
+
+  uint32_t intern(const std::string& symbol)
+  {
+    auto it = m_symbols.find(symbol);
+    if (it != m_symbols.end())
+      return it->second;
+
+    uint32_t index = static_cast<uint32_t>(m_symbol_table.size());
+    m_symbols[symbol] = index;
+    m_symbol_table.push_back(symbol);
+    return index;
+  }
+
+  static void append_u32(std::string& out, uint32_t value)
+  {
+    char bytes[4] = {
+      static_cast<char>(value & 0xff),
+      static_cast<char>((value >> 8) & 0xff),
+      static_cast<char>((value >> 16) & 0xff),
+      static_cast<char>((value >> 24) & 0xff)
+    };
+    out.append(bytes, sizeof(bytes));
+  }
+
+  static void write_string(std::string& out, const std::string& text)
+  {
+    append_u32(out, static_cast<uint32_t>(text.size()));
+    out += text;
+  }
+
+  void write_u8(uint8_t value) { m_body += static_cast<char>(value); }
+  void write_u32(uint32_t value) { append_u32(m_body, value); }
+
+private:
+  std::map<std::string, uint32_t> m_symbols;
+  std::vector<std::string> m_symbol_table;
+  std::string m_body;
+};
+
+class Decoder
+{
+public:
+  Decoder(const char* data, size_t size, ReaderPackedArrays* packed_arrays) :
+    m_ptr(reinterpret_cast<const uint8_t*>(data)),
+    m_end(reinterpret_cast<const uint8_t*>(data) + size),
+    m_symbols(),
+    m_packed_arrays(packed_arrays)
+  {}
+
+  sexp::Value read_document()
+  {
+    need(sizeof(magic));
+    if (memcmp(m_ptr, magic, sizeof(magic)) != 0)
+      throw std::runtime_error("BinarySexp: not a binary sexp");
+    m_ptr += sizeof(magic);
+
+    if (read_u32() != static_cast<uint32_t>(VERSION))
+      throw std::runtime_error("BinarySexp: unsupported version");
+
+    // the source stamp is only of interest to read_source_stamp()
+    read_u32();
+    read_u32();
+
+    uint32_t symbol_count = read_u32();
+    m_symbols.reserve(symbol_count);
+    for (uint32_t i = 0; i < symbol_count; ++i)
+      m_symbols.push_back(read_string());
+
+    sexp::Value sx = read_value();
+    if (m_ptr != m_end)
+      throw std::runtime_error("BinarySexp: trailing data");
+    return sx;
+  }
+
+private:
+  sexp::Value read_value()
+  {
+    need(1);
+    switch (*m_ptr++)
+    {
+      case TAG_NIL:
+        return sexp::Value::nil();
+
+      case TAG_FALSE:
+        return sexp::Value::boolean(false);
+
+      case TAG_TRUE:
+        return sexp::Value::boolean(true);
+
+      case TAG_INTEGER:
+        return sexp::Value::integer(static_cast<int32_t>(read_u32()));
+
+      case TAG_REAL:
+      {
+        uint32_t bits = read_u32();
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return sexp::Value::real(value);
+      }
+
+      case TAG_STRING:
+        return sexp::Value::string(read_string());
+
+      case TAG_SYMBOL:
+      {
+        uint32_t index = read_u32();
+        if (index >= m_symbols.size())
+          throw std::runtime_error("BinarySexp: invalid symbol index");
+        return sexp::Value::symbol(m_symbols[index]);
+      }
+
+      case TAG_ARRAY:
+      {
+        uint32_t count = read_u32();
+        std::vector<sexp::Value> arr;
+        arr.reserve(std::min<size_t>(count, m_end - m_ptr));
+        for (uint32_t i = 0; i < count; ++i)
+          arr.push_back(read_value());
+        return sexp::Value::array(std::move(arr));
+      }
+
+      case TAG_INTEGER_ARRAY:
+      {
+        sexp::Value head = read_value();
+        uint32_t count = read_u32();
+        need(size_t(count) * 4);
+
+        if (m_packed_arrays && count >= packed_array_min_size &&
+            head.is_symbol() && head.as_string() == packed_array_key())
+        {
+          std::vector<unsigned int> values(count);
+          for (uint32_t i = 0; i < count; ++i)
+            values[i] = read_u32();
+
+          std::vector<sexp::Value> arr;
+          arr.push_back(std::move(head));
+          arr.push_back(make_packed_array_ref(m_packed_arrays->size()));
+          m_packed_arrays->push_back(std::move(values));
+          return sexp::Value::array(std::move(arr));
+        }
+
+        std::vector<sexp::Value> arr;
+        arr.reserve(count + 1);
+        arr.push_back(std::move(head));
+        for (uint32_t i = 0; i < count; ++i)
+          arr.push_back(sexp::Value::integer(static_cast<int32_t>(read_u32())));
+        return sexp::Value::array(std::move(arr));
+      }
+
+      default:
+        throw std::runtime_error("BinarySexp: invalid tag");
+    }
+  }
+
+  void need(size_t bytes) const
+  {
+    if (size_t(m_end - m_ptr) < bytes)
+      throw std::runtime_error("BinarySexp: unexpected end of data");
+  }
+
+  uint32_t read_u32()
+  {
+    need(4);
+    uint32_t value = (uint32_t(m_ptr[0]) |
+                      uint32_t(m_ptr[1]) << 8 |
+                      uint32_t(m_ptr[2]) << 16 |
+                      uint32_t(m_ptr[3]) << 24);
+    m_ptr += 4;
+    return value;
+  }
+
+  std::string read_string()
+  {
+    uint32_t length = read_u32();
+    need(length);
+    std::string text(reinterpret_cast<const char*>(m_ptr), length);
+    m_ptr += length;
+    return text;
+  }
+
+private:
+  const uint8_t* m_ptr;
+  const uint8_t* m_end;
+  std::vector<std::string> m_symbols;
+  ReaderPackedArrays* m_packed_arrays;
+};
+
+} // namespace
+
+bool is_binary(const char* data, size_t size)
+{
+  return size >= sizeof(magic) && memcmp(data, magic, sizeof(magic)) == 0;
+}
+
+uint64_t source_stamp(const char* data, size_t size)
+{
+  // 64 bit FNV-1a
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (size_t i = 0; i < size; ++i)
+  {
+    hash ^= static_cast<uint8_t>(data[i]);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+bool read_source_stamp(const char* data, size_t size, uint64_t& stamp)
+{
+  if (size < HEADER_SIZE || !is_binary(data, size))
+    return false;
+
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(data) + sizeof(magic);
+  auto u32 = [&p]() -> uint32_t {
+    uint32_t value = static_cast<uint32_t>(p[0]) |
+      (static_cast<uint32_t>(p[1]) << 8) |
+      (static_cast<uint32_t>(p[2]) << 16) |
+      (static_cast<uint32_t>(p[3]) << 24);
+    p += 4;
+    return value;
+  };
+
+  if (u32() != static_cast<uint32_t>(VERSION))
+    return false;
+
+  uint64_t low = u32();
+  uint64_t high = u32();
+  stamp = low | (high << 32);
+  return true;
+}
+
+void write(std::ostream& out, const sexp::Value& sx, uint64_t stamp)
+{
+  Encoder encoder;
+  encoder.write_value(sx);
+  encoder.finish(out, stamp);
+}
+
+sexp::Value read(const char* data, size_t size, ReaderPackedArrays* packed_arrays)
+{
+  Decoder decoder(data, size, packed_arrays);
+  return decoder.read_document();
+}
+
+} // namespace BinarySexp
+
+/* EOF */
@@ -0,0 +1,67 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADER_SUPERTUX_UTIL_BINARY_SEXP_HPP
+#define HEADER_SUPERTUX_UTIL_BINARY_SEXP_HPP
+
+#include <ostream>
+#include <sexp/value.hpp>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "util/reader_packed_array.hpp"
+
+/** Compact binary encoding of a parsed s-expression as used by the
+    compiled .stlb level files. Symbols are stored once in a table and
+    referenced by index, long lists of integers (tilemap tiles) are
+    stored as packed 32 bit values. The encoding is little endian on
+    all platforms. */
+namespace BinarySexp {
+
+/** bump whenever the encoding changes, old files are then ignored */
+const int VERSION = 2;
+
+/** number of bytes at the start of a file that hold the magic, the
+    version and the source stamp */
+const size_t HEADER_SIZE = 16;
+
+/** Returns true if the data starts with the header of a binary sexp */
+bool is_binary(const char* data, size_t size);
+
+/** Returns a hash of the text a binary sexp was compiled from, used
+    to tell whether a compiled file still matches its source */
+uint64_t source_stamp(const char* data, size_t size);
+
+/** Reads the source stamp from the first HEADER_SIZE bytes of a
+    binary sexp, returns false if they don't hold a header of the
+    current version */
+bool read_source_stamp(const char* data, size_t size, uint64_t& stamp);
+
+/** Writes @c sx to @c out, throws on values that can't be encoded.
+    @c stamp is the source_stamp() of the text @c sx was parsed from. */
+void write(std::ostream& out, const sexp::Value& sx, uint64_t stamp = 0);
+
+/** Decodes a value written by write(), throws std::runtime_error on
+    truncated or corrupt data. If @c packed_arrays is given, long
+    integer lists are copied there as a whole and referenced from the
+    tree, see reader_packed_array.hpp. */
+sexp::Value read(const char* data, size_t size, ReaderPackedArrays* packed_arrays = nullptr);
+
+} // namespace BinarySexp
+
+#endif
+
+/* EOF */
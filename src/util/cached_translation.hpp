@@ -0,0 +1,62 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADER_SUPERTUX_UTIL_CACHED_TRANSLATION_HPP
+#define HEADER_SUPERTUX_UTIL_CACHED_TRANSLATION_HPP
+
+#include <string>
+
+#include "util/gettext.hpp"
+
+/** Translation of a fixed message for hot call sites such as draw()
+    code. The message is looked up once and the interned translation
+    is reused until the language or the translation directories
+    change, use it as a function local static:
+
+      static CachedTranslation coins("Coins");
+      context.draw_text(font, coins.get(), ...); */
+class CachedTranslation
+{
+public:
+  explicit CachedTranslation(const char* msgid) :
+    m_msgid(msgid),
+    m_text(&m_msgid),
+    m_generation(0)
+  {}
+
+  const std::string& get() const
+  {
+    if (m_generation != CompiledDictionary::get_generation())
+    {
+      m_generation = CompiledDictionary::get_generation();
+      m_text = g_compiled_dictionary ? &g_compiled_dictionary->intern(m_msgid) : &m_msgid;
+    }
+    return *m_text;
+  }
+
+private:
+  std::string m_msgid;
+  mutable const std::string* m_text;
+  mutable unsigned int m_generation;
+
+private:
+  CachedTranslation(const CachedTranslation&) = delete;
+  CachedTranslation& operator=(const CachedTranslation&) = delete;
+};
+
+#endif
+
+/* EOF */
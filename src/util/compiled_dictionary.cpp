@@ -0,0 +1,267 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "util/compiled_dictionary.hpp"
+
+#include <physfs.h>
+#include <stdio.h>
+#include <algorithm>
+#include <tinygettext/dictionary.hpp>
+#include <tinygettext/dictionary_manager.hpp>
+#include <tinygettext/language.hpp>
+#include <tinygettext/po_parser.hpp>
+
+#include "physfs/ifile_stream.hpp"
+#include "physfs/physfs_directory_index.hpp"
+#include "physfs/physfs_file_system.hpp"
+#include "util/file_system.hpp"
+#include "util/log.hpp"
+
+unsigned int CompiledDictionary::s_generation = 1;
+
+CompiledDictionary::CompiledDictionary(tinygettext::DictionaryManager& manager,
+                                       const std::string& cache_directory) :
+  m_manager(manager),
+  m_cache_directory(),
+  m_search_path(),
+  m_catalogs(),
+  m_active(),
+  m_active_valid(false),
+  m_interned()
+{
+  s_generation += 1;
+
+  if(!PhysFSFileSystem::mkdir(cache_directory))
+  {
+    log_warning << "Couldn't create translation cache directory '" << cache_directory << "': "
+                << PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()) << std::endl;
+    return;
+  }
+
+  const char* writedir = PHYSFS_getWriteDir();
+  if(writedir)
+  {
+    m_cache_directory = std::string(writedir) + "/" + cache_directory;
+  }
+}
+
+CompiledDictionary::~CompiledDictionary()
+{
+  s_generation += 1;
+}
+
+void
+CompiledDictionary::add_directory(const std::string& pathname, bool precedence)
+{
+  auto it = std::find(m_search_path.begin(), m_search_path.end(), pathname);
+  if(it != m_search_path.end())
+  {
+    if(!precedence || it == m_search_path.begin())
+      return;
+    m_search_path.erase(it);
+  }
+
+  m_manager.add_directory(pathname, precedence);
+  if(precedence)
+    m_search_path.push_front(pathname);
+  else
+    m_search_path.push_back(pathname);
+  invalidate();
+}
+
+void
+CompiledDictionary::remove_directory(const std::string& pathname)
+{
+  auto it = std::find(m_search_path.begin(), m_search_path.end(), pathname);
+  if(it == m_search_path.end())
+    return;
+
+  m_manager.remove_directory(pathname);
+  m_search_path.erase(it);
+  invalidate();
+}
+
+void
+CompiledDictionary::set_language(const tinygettext::Language& language)
+{
+  m_manager.set_language(language);
+  invalidate();
+}
+
+void
+CompiledDictionary::invalidate()
+{
+  m_active_valid = false;
+  m_active.clear();
+  m_interned.clear();
+  s_generation += 1;
+}
+
+std::string
+CompiledDictionary::translate(const std::string& msgid)
+{
+  update();
+
+  size_t length;
+  for(const auto& catalog : m_active)
+  {
+    const char* str = catalog->find(msgid.data(), msgid.size(), length);
+    if(str)
+      return std::string(str, length);
+  }
+  return msgid;
+}
+
+const std::string&
+CompiledDictionary::intern(const std::string& msgid)
+{
+  update();
+
+  auto it = m_interned.find(msgid);
+  if(it != m_interned.end())
+    return it->second;
+
+  return m_interned.insert(std::make_pair(msgid, translate(msgid))).first->second;
+}
+
+void
+CompiledDictionary::update()
+{
+  if(m_active_valid)
+    return;
+
+  m_active_valid = true;
+  m_active.clear();
+
+  tinygettext::Language language = m_manager.get_language();
+  if(!language)
+    return;
+
+  // same order as tinygettext: earlier directories win, a language
+  // with a country falls back to the plain language
+  std::vector<tinygettext::Language> languages;
+  languages.push_back(language);
+  if(!language.get_country().empty())
+    languages.push_back(tinygettext::Language::from_spec(language.get_language()));
+
+  std::vector<std::string> files;
+  for(const auto& lang : languages)
+  {
+    for(const auto& directory : m_search_path)
+    {
+      std::string filename = find_po_file(directory, lang);
+      if(!filename.empty() && std::find(files.begin(), files.end(), filename) == files.end())
+        files.push_back(filename);
+    }
+  }
+
+  for(const auto& filename : files)
+  {
+    const TranslationCatalog* catalog = get_catalog(filename);
+    if(catalog && catalog->size() > 0)
+      m_active.push_back(catalog);
+  }
+}
+
+std::string
+CompiledDictionary::find_po_file(const std::string& directory, const tinygettext::Language& language) const
+{
+  std::string best_filename;
+  int best_score = 0;
+  for(const auto& filename : PhysFSDirectoryIndex::enumerate(directory))
+  {
+    if(filename.size() <= 3 || filename.compare(filename.size() - 3, 3, ".po") != 0)
+      continue;
+
+    tinygettext::Language po_language = tinygettext::Language::from_env(filename.substr(0, filename.size() - 3));
+    if(!po_language)
+      continue;
+
+    int score = tinygettext::Language::match(language, po_language);
+    if(score > best_score)
+    {
+      best_score = score;
+      best_filename = filename;
+    }
+  }
+
+  return best_filename.empty() ? std::string() : FileSystem::join(directory, best_filename);
+}
+
+const TranslationCatalog*
+CompiledDictionary::get_catalog(const std::string& filename)
+{
+  auto it = m_catalogs.find(filename);
+  if(it != m_catalogs.end())
+    return it->second.get();
+
+  // the modification time decides whether the compiled catalog is
+  // still valid, so don't take it from the directory index
+  PHYSFS_Stat statbuf;
+  if(!PHYSFS_stat(filename.c_str(), &statbuf))
+    return nullptr;
+
+  std::unique_ptr<TranslationCatalog> catalog(new TranslationCatalog);
+
+  std::string cache_path = get_cache_path(filename);
+  if(cache_path.empty() ||
+     !catalog->load(cache_path, filename, statbuf.modtime, statbuf.filesize))
+  {
+    try
+    {
+      tinygettext::Dictionary dictionary;
+      IFileStream in(filename);
+      tinygettext::POParser::parse(filename, in, dictionary);
+      catalog->build(dictionary);
+    }
+    catch(const std::exception& err)
+    {
+      log_warning << "Couldn't compile translations of '" << filename << "': " << err.what() << std::endl;
+      catalog->build(std::vector<std::pair<std::string, std::string> >());
+    }
+
+    if(!cache_path.empty() &&
+       !catalog->save(cache_path, filename, statbuf.modtime, statbuf.filesize))
+    {
+      log_debug << "Couldn't write translation cache for '" << filename << "'" << std::endl;
+    }
+  }
+
+  const TranslationCatalog* result = catalog.get();
+  m_catalogs[filename] = std::move(catalog);
+  return result;
+}
+
+std::string
+CompiledDictionary::get_cache_path(const std::string& filename) const
+{
+  if(m_cache_directory.empty())
+    return {};
+
+  // FNV-1a, the full path is stored in the catalog to catch collisions
+  uint64_t hash = 14695981039346656037ULL;
+  for(const auto& c : filename)
+  {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+
+  char name[32];
+  snprintf(name, sizeof(name), "%016llx.stmo", static_cast<unsigned long long>(hash));
+  return m_cache_directory + "/" + name;
+}
+
+/* EOF */
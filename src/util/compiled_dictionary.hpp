@@ -0,0 +1,86 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADER_SUPERTUX_UTIL_COMPILED_DICTIONARY_HPP
+#define HEADER_SUPERTUX_UTIL_COMPILED_DICTIONARY_HPP
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "util/translation_catalog.hpp"
+
+namespace tinygettext {
+class DictionaryManager;
+class Language;
+} // namespace tinygettext
+
+/** Answers _() lookups from compiled TranslationCatalogs instead of
+    the dictionaries tinygettext builds by parsing every .po file of
+    the search path. It picks the same .po file per directory as
+    tinygettext, compiles it on first use and keeps the compiled table
+    in the user dir. Changes to the search path and the language go
+    through this class, which forwards them to the DictionaryManager
+    so plural and context lookups keep working. */
+class CompiledDictionary
+{
+public:
+  /** @param cache_directory  PhysFS directory below the write dir */
+  CompiledDictionary(tinygettext::DictionaryManager& manager, const std::string& cache_directory);
+  ~CompiledDictionary();
+
+  void add_directory(const std::string& pathname, bool precedence = false);
+  void remove_directory(const std::string& pathname);
+  void set_language(const tinygettext::Language& language);
+
+  std::string translate(const std::string& msgid);
+
+  /** Returns the translation of @c msgid by reference, it stays
+      valid until get_generation() changes */
+  const std::string& intern(const std::string& msgid);
+
+  /** Changes whenever translations returned earlier may be outdated */
+  static unsigned int get_generation() { return s_generation; }
+
+private:
+  void invalidate();
+  void update();
+  std::string find_po_file(const std::string& directory, const tinygettext::Language& language) const;
+  const TranslationCatalog* get_catalog(const std::string& filename);
+  std::string get_cache_path(const std::string& filename) const;
+
+private:
+  static unsigned int s_generation;
+
+  tinygettext::DictionaryManager& m_manager;
+  std::string m_cache_directory;
+  std::deque<std::string> m_search_path;
+  std::map<std::string, std::unique_ptr<TranslationCatalog> > m_catalogs;
+  std::vector<const TranslationCatalog*> m_active;
+  bool m_active_valid;
+  std::unordered_map<std::string, std::string> m_interned;
+
+private:
+  CompiledDictionary(const CompiledDictionary&) = delete;
+  CompiledDictionary& operator=(const CompiledDictionary&) = delete;
+};
+
+#endif
+
+/* EOF */
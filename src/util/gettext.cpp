@@ -17,5 +17,6 @@
 #include "util/gettext.hpp"
 
 std::unique_ptr<tinygettext::DictionaryManager> g_dictionary_manager = nullptr;
+std::unique_ptr<CompiledDictionary> g_compiled_dictionary = nullptr;
 
 /* EOF */
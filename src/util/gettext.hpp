@@ -22,9 +22,14 @@
 #include <memory>
 
 #include "supertux/globals.hpp"
+#include "util/compiled_dictionary.hpp"
 
 extern std::unique_ptr<tinygettext::DictionaryManager> g_dictionary_manager;
 
+/** Serves _() from compiled catalogs, search path and language
+    changes must go through it instead of g_dictionary_manager */
+extern std::unique_ptr<CompiledDictionary> g_compiled_dictionary;
+
 /*
  * If you need to do a nontrivial substitution of values into a pattern, use
  * boost::format rather than an ad-hoc concatenation.  That way, translators can
@@ -58,7 +63,11 @@ extern std::unique_ptr<tinygettext::DictionaryManager> g_dictionary_manager;
 
 static inline std::string _(const std::string& message)
 {
-  if (g_dictionary_manager)
+  if (g_compiled_dictionary)
+  {
+    return g_compiled_dictionary->translate(message);
+  }
+  else if (g_dictionary_manager)
   {
     return g_dictionary_manager->get_dictionary().translate(message);
   }
@@ -29,11 +29,31 @@ LogLevel g_log_level = LOG_WARNING;
 static std::ostream& get_logging_instance (bool use_console_buffer = true)
 {
   if (ConsoleBuffer::current() && use_console_buffer)
-    return (ConsoleBuffer::output);
+  {
+    if (ConsoleBuffer::current()->is_main_thread())
+      return (ConsoleBuffer::output);
+
+    // worker threads log into a buffer of their own, the lines are
+    // handed to the main thread by ConsoleBuffer::flush()
+    static thread_local ConsoleStreamBuffer buffer;
+    static thread_local std::ostream output(&buffer);
+    return (output);
+  }
   else
     return (std::cerr);
 }
 
+/** opens the console for warnings in developer mode, only the main
+    thread may touch it */
+static void open_console()
+{
+  if(g_config && g_config->developer_mode &&
+     ConsoleBuffer::current() && ConsoleBuffer::current()->is_main_thread() &&
+     Console::current() && !Console::current()->hasFocus()) {
+    Console::current()->open();
+  }
+}
+
 static std::ostream& log_generic_f (const char *prefix, const char* file, int line, bool use_console_buffer = true)
 {
   get_logging_instance (use_console_buffer) << prefix << " " << file << ":" << line << " ";
@@ -52,19 +72,13 @@ std::ostream& log_info_f(const char* file, int line)
 
 std::ostream& log_warning_f(const char* file, int line)
 {
-  if(g_config && g_config->developer_mode &&
-     Console::current() && !Console::current()->hasFocus()) {
-    Console::current()->open();
-  }
+  open_console();
   return (log_generic_f ("[WARNING]", file, line));
 }
 
 std::ostream& log_fatal_f(const char* file, int line)
 {
-  if(g_config && g_config->developer_mode &&
-     Console::current() && !Console::current()->hasFocus()) {
-    Console::current()->open();
-  }
+  open_console();
   return (log_generic_f ("[FATAL]", file, line));
 }
 
@@ -0,0 +1,109 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "util/mapped_file.hpp"
+
+#include <fstream>
+
+#ifndef _WIN32
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+MappedFile::MappedFile() :
+  m_data(nullptr),
+  m_size(0),
+  m_mapped(false),
+  m_buffer()
+{
+}
+
+MappedFile::~MappedFile()
+{
+  close();
+}
+
+bool
+MappedFile::open(const std::string& path, bool writable)
+{
+  close();
+
+#ifndef _WIN32
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if(fd < 0)
+    return false;
+
+  struct stat statbuf;
+  if(fstat(fd, &statbuf) != 0 || statbuf.st_size <= 0)
+  {
+    ::close(fd);
+    return false;
+  }
+
+  int prot = writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+  void* addr = mmap(nullptr, static_cast<size_t>(statbuf.st_size), prot, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if(addr != MAP_FAILED)
+  {
+    m_data = static_cast<char*>(addr);
+    m_size = static_cast<size_t>(statbuf.st_size);
+    m_mapped = true;
+    return true;
+  }
+#endif
+
+  // no mmap available, read the whole file instead
+  std::ifstream in(path.c_str(), std::ios::binary);
+  if(!in)
+    return false;
+
+  in.seekg(0, std::ios::end);
+  std::streamoff size = in.tellg();
+  if(size <= 0)
+    return false;
+  in.seekg(0, std::ios::beg);
+
+  m_buffer.resize(static_cast<size_t>(size));
+  if(!in.read(m_buffer.data(), size))
+  {
+    m_buffer.clear();
+    return false;
+  }
+
+  m_data = m_buffer.data();
+  m_size = m_buffer.size();
+  return true;
+}
+
+void
+MappedFile::close()
+{
+#ifndef _WIN32
+  if(m_mapped)
+  {
+    munmap(m_data, m_size);
+  }
+#endif
+
+  m_data = nullptr;
+  m_size = 0;
+  m_mapped = false;
+  std::vector<char>().swap(m_buffer);
+}
+
+/* EOF */
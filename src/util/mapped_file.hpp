@@ -0,0 +1,58 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADER_SUPERTUX_UTIL_MAPPED_FILE_HPP
+#define HEADER_SUPERTUX_UTIL_MAPPED_FILE_HPP
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+/** View of a whole native (non-PhysFS) file. The file is
+    memory-mapped where the platform supports it and read into a
+    buffer otherwise. The view is read-only unless opened as writable,
+    writes never reach the file. */
+class MappedFile
+{
+public:
+  MappedFile();
+  ~MappedFile();
+
+  /** Maps the file at the given native path, returns false on error.
+      With @c writable, pages are mapped copy-on-write. */
+  bool open(const std::string& path, bool writable = false);
+  void close();
+
+  bool is_open() const { return m_data != nullptr; }
+  const char* get_data() const { return m_data; }
+  /** Only to be written to if opened as writable */
+  char* get_writable_data() { return m_data; }
+  size_t get_size() const { return m_size; }
+
+private:
+  char* m_data;
+  size_t m_size;
+  bool m_mapped;
+  std::vector<char> m_buffer;
+
+private:
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+};
+
+#endif
+
+/* EOF */
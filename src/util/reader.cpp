@@ -67,7 +67,7 @@ std::string dirname(const std::string& filename)
 
 void register_translation_directory(const std::string& filename)
 {
-  if (g_dictionary_manager) {
+  if (g_compiled_dictionary) {
     std::string rel_dir = dirname(filename);
     if (rel_dir.empty()) {
       // Relative dir inside PhysFS search path?
@@ -79,7 +79,7 @@ void register_translation_directory(const std::string& filename)
     }
 
     if (!rel_dir.empty()) {
-      g_dictionary_manager->add_directory(rel_dir);
+      g_compiled_dictionary->add_directory(rel_dir);
     }
   }
 }
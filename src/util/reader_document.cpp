@@ -16,19 +16,278 @@
 
 #include "util/reader_document.hpp"
 
+#include <algorithm>
+#include <ctype.h>
+#include <iterator>
+#include <memory>
 #include <sexp/parser.hpp>
 #include <sstream>
+#include <stdexcept>
+#include <stdint.h>
+#include <streambuf>
+#include <string.h>
 
-#include "physfs/ifile_stream.hpp"
-#include "physfs/ifile_streambuf.hpp"
+#include "physfs/physfs_file_data.hpp"
+#include "util/binary_sexp.hpp"
 #include "util/log.hpp"
+#include "util/reader_error.hpp"
 #include "util/reader_iterator.hpp"
 
+namespace {
+
+bool is_delimiter(char c)
+{
+  return isspace(static_cast<unsigned char>(c)) || c == '(' || c == ')' || c == '"' || c == ';';
+}
+
+/** Tries to decode "(tiles int int ...)" starting at the '(' at
+    @c pos, see packed_array_key(). On success the integers are
+    appended to @c values, the number of newlines in the list is stored
+    in @c newlines and the position after the closing ')' is returned,
+    otherwise npos. */
+size_t scan_integer_list(const char* text, size_t end, size_t pos,
+                         std::vector<int>& values, int& newlines)
+{
+  size_t i = pos + 1;
+  newlines = 0;
+
+  auto skip_space = [&]() {
+    while (i < end && isspace(static_cast<unsigned char>(text[i])))
+    {
+      if (text[i] == '\n')
+        newlines += 1;
+      i += 1;
+    }
+  };
+
+  skip_space();
+  size_t symbol_start = i;
+  while (i < end && !is_delimiter(text[i]))
+    i += 1;
+  const char* key = packed_array_key();
+  if (i - symbol_start != strlen(key) || strncmp(text + symbol_start, key, i - symbol_start) != 0)
+    return std::string::npos;
+
+  while (true)
+  {
+    skip_space();
+    if (i >= end)
+      return std::string::npos;
+
+    if (text[i] == ')')
+      return i + 1;
+
+    bool negative = false;
+    if (text[i] == '-')
+    {
+      negative = true;
+      i += 1;
+    }
+
+    size_t digits_start = i;
+    long long value = 0;
+    while (i < end && text[i] >= '0' && text[i] <= '9' && i - digits_start < 11)
+    {
+      value = value * 10 + (text[i] - '0');
+      i += 1;
+    }
+
+    if (i == digits_start || (i < end && !is_delimiter(text[i])))
+      return std::string::npos;
+
+    if (negative)
+      value = -value;
+    if (value < INT32_MIN || value > INT32_MAX)
+      return std::string::npos;
+
+    values.push_back(static_cast<int>(value));
+  }
+}
+
+/** Returns the offset of the next '(' at or after @c pos that is not
+    inside a string or comment, or @c size if there is none */
+size_t find_list(const char* text, size_t size, size_t pos)
+{
+  size_t i = pos;
+  while (i < size)
+  {
+    char c = text[i];
+    if (c == '"')
+    {
+      i += 1;
+      while (i < size && text[i] != '"')
+        i += (text[i] == '\\') ? 2 : 1;
+      i += 1;
+    }
+    else if (c == ';')
+    {
+      while (i < size && text[i] != '\n')
+        i += 1;
+    }
+    else if (c == '(')
+    {
+      return i;
+    }
+    else
+    {
+      i += 1;
+    }
+  }
+  return size;
+}
+
+/** Feeds the text to the sexp parser and replaces long tiles lists by
+    references into @c packed_arrays while the parser reads, keeping the
+    line numbers of everything else. The text is handed out in small
+    chunks, it is never copied as a whole. */
+class PackedArrayStreambuf : public std::streambuf
+{
+public:
+  PackedArrayStreambuf(const char* data, size_t size, ReaderPackedArrays& packed_arrays) :
+    m_data(data),
+    m_size(size),
+    m_pos(0),
+    m_plain_end(0),
+    m_packed_arrays(packed_arrays),
+    m_values(),
+    m_ref(),
+    m_buffer()
+  {
+  }
+
+protected:
+  int_type underflow() override
+  {
+    if (gptr() < egptr())
+      return traits_type::to_int_type(*gptr());
+
+    if (m_pos >= m_size)
+      return traits_type::eof();
+
+    if (m_pos == m_plain_end)
+    {
+      if (m_data[m_pos] == '(' && pack_list())
+        return traits_type::to_int_type(*gptr());
+
+      // everything up to the next list can be passed through as is
+      m_plain_end = find_list(m_data, m_size, m_data[m_pos] == '(' ? m_pos + 1 : m_pos);
+    }
+
+    size_t count = std::min(m_plain_end - m_pos, sizeof(m_buffer));
+    memcpy(m_buffer, m_data + m_pos, count);
+    m_pos += count;
+    setg(m_buffer, m_buffer, m_buffer + count);
+    return traits_type::to_int_type(*gptr());
+  }
+
+private:
+  /** Packs the list at m_pos if it is a long tiles list */
+  bool pack_list()
+  {
+    int newlines;
+    m_values.clear();
+    size_t next = scan_integer_list(m_data, m_size, m_pos, m_values, newlines);
+    if (next == std::string::npos || m_values.size() < packed_array_min_size)
+      return false;
+
+    m_ref = "(";
+    m_ref += packed_array_key();
+    m_ref += " (";
+    m_ref += packed_array_marker();
+    m_ref += ' ';
+    m_ref += std::to_string(m_packed_arrays.size());
+    m_ref += ')';
+    m_ref.append(newlines, '\n');
+    m_ref += ')';
+    m_packed_arrays.emplace_back(m_values.begin(), m_values.end());
+
+    m_pos = next;
+    m_plain_end = next;
+    setg(&m_ref[0], &m_ref[0], &m_ref[0] + m_ref.size());
+    return true;
+  }
+
+private:
+  const char* m_data;
+  size_t m_size;
+  size_t m_pos;
+  /** end of the text before the next list that might be packed */
+  size_t m_plain_end;
+  ReaderPackedArrays& m_packed_arrays;
+  std::vector<int> m_values;
+  std::string m_ref;
+  char m_buffer[4096];
+
+private:
+  PackedArrayStreambuf(const PackedArrayStreambuf&) = delete;
+  PackedArrayStreambuf& operator=(const PackedArrayStreambuf&) = delete;
+};
+
+/** Returns the offset of the first list named @c key directly inside
+    the root list, or npos if there is none */
+size_t find_root_child(const char* text, size_t size, const char* key)
+{
+  const size_t key_len = strlen(key);
+  int depth = 0;
+  size_t i = 0;
+  while (i < size)
+  {
+    char c = text[i];
+    if (c == '"')
+    {
+      i += 1;
+      while (i < size && text[i] != '"')
+        i += (text[i] == '\\') ? 2 : 1;
+      i += 1;
+    }
+    else if (c == ';')
+    {
+      while (i < size && text[i] != '\n')
+        i += 1;
+    }
+    else if (c == '(')
+    {
+      if (depth == 1)
+      {
+        size_t j = i + 1;
+        while (j < size && isspace(static_cast<unsigned char>(text[j])))
+          j += 1;
+        if (size - j >= key_len && strncmp(text + j, key, key_len) == 0 &&
+            (j + key_len == size || is_delimiter(text[j + key_len])))
+          return i;
+      }
+      depth += 1;
+      i += 1;
+    }
+    else
+    {
+      if (c == ')')
+        depth -= 1;
+      i += 1;
+    }
+  }
+  return std::string::npos;
+}
+
+} // namespace
+
 ReaderDocument
 ReaderDocument::parse(std::istream& stream, const std::string& filename)
 {
-  sexp::Value sx = sexp::Parser::from_stream(stream, sexp::Parser::USE_ARRAYS);
-  return ReaderDocument(filename, std::move(sx));
+  std::string text((std::istreambuf_iterator<char>(stream)),
+                   std::istreambuf_iterator<char>());
+
+  return parse(text.data(), text.size(), filename);
+}
+
+ReaderDocument
+ReaderDocument::parse(const char* data, size_t size, const std::string& filename)
+{
+  ReaderPackedArrays packed_arrays;
+  PackedArrayStreambuf buf(data, size, packed_arrays);
+  std::istream in(&buf);
+  sexp::Value sx = sexp::Parser::from_stream(in, sexp::Parser::USE_ARRAYS);
+  return ReaderDocument(filename, std::move(sx), std::move(packed_arrays));
 }
 
 ReaderDocument
@@ -36,27 +295,88 @@ ReaderDocument::parse(const std::string& filename)
 {
   log_debug << "ReaderDocument::parse: " << filename << std::endl;
 
-  IFileStreambuf ins(filename);
-  std::istream in(&ins);
+  std::unique_ptr<PhysFSFileData> data;
+  try {
+    data.reset(new PhysFSFileData(filename));
+  } catch(const std::exception&) {
+    std::stringstream msg;
+    msg << "Parser problem: Couldn't open file '" << filename << "'.";
+    throw std::runtime_error(msg.str());
+  }
+
+  return parse(data->get_data(), data->get_size(), filename);
+}
 
-  if(!in.good()) {
+ReaderDocument
+ReaderDocument::parse_header(const std::string& filename, const char* stop_key)
+{
+  log_debug << "ReaderDocument::parse_header: " << filename << std::endl;
+
+  std::unique_ptr<PhysFSFileData> data;
+  try {
+    data.reset(new PhysFSFileData(filename));
+  } catch(const std::exception&) {
     std::stringstream msg;
     msg << "Parser problem: Couldn't open file '" << filename << "'.";
     throw std::runtime_error(msg.str());
-  } else {
-    return parse(in, filename);
   }
+
+  size_t end = find_root_child(data->get_data(), data->get_size(), stop_key);
+  if (end == std::string::npos)
+    return parse(data->get_data(), data->get_size(), filename);
+
+  std::string header(data->get_data(), end);
+  header += ')';
+  return parse(header.data(), header.size(), filename);
+}
+
+ReaderDocument
+ReaderDocument::parse_binary(const std::string& filename)
+{
+  log_debug << "ReaderDocument::parse_binary: " << filename << std::endl;
+
+  std::unique_ptr<PhysFSFileData> data;
+  try {
+    data.reset(new PhysFSFileData(filename));
+  } catch(const std::exception&) {
+    std::stringstream msg;
+    msg << "Parser problem: Couldn't open file '" << filename << "'.";
+    throw std::runtime_error(msg.str());
+  }
+
+  ReaderPackedArrays packed_arrays;
+  sexp::Value sx = BinarySexp::read(data->get_data(), data->get_size(), &packed_arrays);
+  return ReaderDocument(filename, std::move(sx), std::move(packed_arrays));
 }
 
 ReaderDocument::ReaderDocument() :
   m_filename(),
-  m_sx()
+  m_sx(),
+  m_key_indices(),
+  m_packed_arrays(),
+  m_packed_taken(),
+  m_translate(true)
 {
 }
 
 ReaderDocument::ReaderDocument(const std::string& filename, sexp::Value sx) :
   m_filename(filename),
-  m_sx(std::move(sx))
+  m_sx(std::move(sx)),
+  m_key_indices(),
+  m_packed_arrays(),
+  m_packed_taken(),
+  m_translate(true)
+{
+}
+
+ReaderDocument::ReaderDocument(const std::string& filename, sexp::Value sx,
+                               ReaderPackedArrays packed_arrays) :
+  m_filename(filename),
+  m_sx(std::move(sx)),
+  m_key_indices(),
+  m_packed_arrays(std::move(packed_arrays)),
+  m_packed_taken(m_packed_arrays.size(), false),
+  m_translate(true)
 {
 }
 
@@ -72,4 +392,71 @@ ReaderDocument::get_filename() const
   return m_filename;
 }
 
+const ReaderKeyIndex&
+ReaderDocument::get_key_index(const sexp::Value& sx) const
+{
+  auto it = m_key_indices.find(&sx);
+  if (it != m_key_indices.end())
+    return it->second;
+
+  const auto& arr = sx.as_array();
+  ReaderKeyIndex index;
+  index.reserve(arr.size());
+  for(size_t i = 1; i < arr.size(); ++i)
+  {
+    const auto& pair = arr[i];
+
+    // size should be >=2 not >=1, but we have to allow smaller once
+    // due to get_iter(), e.g. (particles-snow)
+    assert_array_size_ge(*this, pair, 1);
+    assert_is_symbol(*this, pair.as_array()[0]);
+
+    ReaderKeyIndexEntry entry = { pair.as_array()[0].as_string().c_str(), &pair };
+    index.push_back(entry);
+  }
+
+  // stable, so that the first of duplicate keys wins like before
+  std::stable_sort(index.begin(), index.end(),
+                   [](const ReaderKeyIndexEntry& lhs, const ReaderKeyIndexEntry& rhs) {
+                     return strcmp(lhs.key, rhs.key) < 0;
+                   });
+
+  return m_key_indices[&sx] = std::move(index);
+}
+
+const std::vector<unsigned int>*
+ReaderDocument::get_packed_array(const sexp::Value& sx) const
+{
+  size_t index;
+  if (!sx.is_array() || sx.as_array().size() != 2 ||
+      !get_packed_array_ref(sx.as_array()[1], index))
+  {
+    return nullptr;
+  }
+
+  if (index >= m_packed_arrays.size())
+  {
+    raise_exception(*this, sx, "invalid packed array reference");
+  }
+  if (m_packed_taken[index])
+  {
+    raise_exception(*this, sx, "packed list was already taken");
+  }
+  return &m_packed_arrays[index];
+}
+
+bool
+ReaderDocument::take_packed_array(const sexp::Value& sx, std::vector<unsigned int>& value) const
+{
+  if (!get_packed_array(sx))
+    return false;
+
+  size_t index;
+  get_packed_array_ref(sx.as_array()[1], index);
+  value.swap(m_packed_arrays[index]);
+  std::vector<unsigned int>().swap(m_packed_arrays[index]);
+  m_packed_taken[index] = true;
+  return true;
+}
+
 /* EOF */
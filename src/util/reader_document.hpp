@@ -19,8 +19,11 @@
 
 #include <istream>
 #include <sexp/value.hpp>
+#include <unordered_map>
 
+#include "util/reader_key_index.hpp"
 #include "util/reader_object.hpp"
+#include "util/reader_packed_array.hpp"
 
 /** The ReaderDocument holds the memory */
 class ReaderDocument final
@@ -29,16 +32,55 @@ public:
   static ReaderDocument parse(std::istream& stream, const std::string& filename = "<stream>");
   static ReaderDocument parse(const std::string& filename);
 
+  /** Parses the text in the given buffer, the buffer is not needed
+      after the call */
+  static ReaderDocument parse(const char* data, size_t size, const std::string& filename = "<buffer>");
+
+  /** Parses only the leading properties of the root list, stopping
+      before its first child list named @c stop_key. Files without
+      such a list are parsed completely. */
+  static ReaderDocument parse_header(const std::string& filename, const char* stop_key);
+
+  /** Loads a document compiled with BinarySexp, the file is
+      memory-mapped when it lives in a plain directory */
+  static ReaderDocument parse_binary(const std::string& filename);
+
 public:
   ReaderDocument();
   ReaderDocument(const std::string& filename, sexp::Value sx);
+  ReaderDocument(const std::string& filename, sexp::Value sx,
+                 ReaderPackedArrays packed_arrays);
 
   ReaderObject get_root() const;
   std::string get_filename() const;
 
+  /** Returns the key index of the mapping @c sx, it is built and the
+      children are validated on the first call for each mapping */
+  const ReaderKeyIndex& get_key_index(const sexp::Value& sx) const;
+
+  /** Returns the packed integer list of the (key value) item @c sx or
+      nullptr if its value is not a packed list */
+  const std::vector<unsigned int>* get_packed_array(const sexp::Value& sx) const;
+
+  /** Moves the packed integer list of @c sx into @c value instead of
+      copying it. Later lookups of the same item raise an error instead
+      of seeing an empty list. */
+  bool take_packed_array(const sexp::Value& sx, std::vector<unsigned int>& value) const;
+
+  /** Whether ReaderMapping translates (_ "...") strings of this
+      document, on by default. The editor and the level index turn it
+      off to get at the untranslated text. */
+  void set_translate(bool translate) { m_translate = translate; }
+  bool get_translate() const { return m_translate; }
+
 private:
   std::string m_filename;
   sexp::Value m_sx;
+  mutable std::unordered_map<const sexp::Value*, ReaderKeyIndex> m_key_indices;
+  mutable ReaderPackedArrays m_packed_arrays;
+  /** which of m_packed_arrays were moved out by take_packed_array() */
+  mutable std::vector<bool> m_packed_taken;
+  bool m_translate;
 };
 
 #endif
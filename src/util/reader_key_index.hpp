@@ -0,0 +1,40 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADER_SUPERTUX_UTIL_READER_KEY_INDEX_HPP
+#define HEADER_SUPERTUX_UTIL_READER_KEY_INDEX_HPP
+
+#include <vector>
+
+namespace sexp {
+class Value;
+} // namespace sexp
+
+struct ReaderKeyIndexEntry
+{
+  const char* key;
+
+  /** the whole (key value ...) child of the mapping */
+  const sexp::Value* item;
+};
+
+/** The children of a mapping sorted by key, see
+    ReaderDocument::get_key_index() */
+typedef std::vector<ReaderKeyIndexEntry> ReaderKeyIndex;
+
+#endif
+
+/* EOF */
@@ -16,28 +16,31 @@
 
 #include "util/reader_mapping.hpp"
 
+#include <algorithm>
 #include <sexp/io.hpp>
 #include <sstream>
 #include <stdexcept>
+#include <string.h>
 
 #include "util/gettext.hpp"
 #include "util/reader_collection.hpp"
 #include "util/reader_document.hpp"
 #include "util/reader_error.hpp"
 
-bool ReaderMapping::translations_enabled = true;
 
 ReaderMapping::ReaderMapping() :
   m_doc(nullptr),
   m_sx(nullptr),
-  m_arr(nullptr)
+  m_arr(nullptr),
+  m_index(nullptr)
 {
 }
 
 ReaderMapping::ReaderMapping(const ReaderDocument* doc, const sexp::Value* sx) :
   m_doc(doc),
   m_sx(sx),
-  m_arr()
+  m_arr(),
+  m_index(nullptr)
 {
   assert(m_doc);
   assert(m_sx);
@@ -63,20 +66,18 @@ ReaderMapping::get_item(const char* key) const
 {
   assert(m_arr);
 
-  for(size_t i = 1; i < m_arr->size(); ++i)
+  if (!m_index)
   {
-    auto const& pair = (*m_arr)[i];
-
-    // size should be >=2 not >=1, but we have to allow smaller once
-    // due to get_iter(), e.g. (particles-snow)
-    assert_array_size_ge(*m_doc, pair, 1);
-
-    assert_is_symbol(*m_doc, pair.as_array()[0]);
+    m_index = &m_doc->get_key_index(*m_sx);
+  }
 
-    if (pair.as_array()[0].as_string() == key)
-    {
-      return &pair;
-    }
+  auto it = std::lower_bound(m_index->begin(), m_index->end(), key,
+                             [](const ReaderKeyIndexEntry& entry, const char* k) {
+                               return strcmp(entry.key, k) < 0;
+                             });
+  if (it != m_index->end() && strcmp(it->key, key) == 0)
+  {
+    return it->item;
   }
   return nullptr;
 }
@@ -167,7 +168,7 @@ ReaderMapping::get(const char* key, std::string& value) const
                item[1].as_array()[0].is_symbol() &&
                item[1].as_array()[0].as_string() == "_" &&
                item[1].as_array()[1].is_string()) {
-      if (translations_enabled) {
+      if (m_doc->get_translate()) {
         value = _(item[1].as_array()[1].as_string());
       } else {
         value = item[1].as_array()[1].as_string();
@@ -199,7 +200,7 @@ ReaderMapping::get(const char* key, std::string& value, std::string defaultValue
                item[1].as_array()[0].is_symbol() &&
                item[1].as_array()[0].as_string() == "_" &&
                item[1].as_array()[1].is_string()) {
-      if (translations_enabled) {
+      if (m_doc->get_translate()) {
         value = _(item[1].as_array()[1].as_string());
       } else {
         value = item[1].as_array()[1].as_string();
@@ -211,10 +212,16 @@ ReaderMapping::get(const char* key, std::string& value, std::string defaultValue
   }
 }
 
-#define GET_VALUES_MACRO(type, checker, getter)                         \
+#define GET_VALUES_MACRO(type, checker, getter, packed_ok)             \
   auto const sx = get_item(key);                                        \
   if (!sx) {                                                            \
     return false;                                                       \
+  } else if (auto const packed = m_doc->get_packed_array(*sx)) {        \
+    if (!packed_ok) {                                                   \
+      raise_exception(*m_doc, *sx, "expected list of " type);           \
+    }                                                                   \
+    value.assign(packed->begin(), packed->end());                       \
+    return true;                                                        \
   } else {                                                              \
     assert_is_array(*m_doc, *sx);                                       \
     auto const& item = sx->as_array();                                  \
@@ -230,7 +237,7 @@ bool
 ReaderMapping::get(const char* key, std::vector<int>& value) const
 {
   value.clear();
-  GET_VALUES_MACRO("int", is_integer, as_int);
+  GET_VALUES_MACRO("int", is_integer, as_int, true);
 }
 
 
@@ -238,25 +245,49 @@ bool
 ReaderMapping::get(const char* key, std::vector<float>& value) const
 {
   value.clear();
-  GET_VALUES_MACRO("float", is_real, as_float);
+  GET_VALUES_MACRO("float", is_real, as_float, false);
 }
 
 bool
 ReaderMapping::get(const char* key, std::vector<std::string>& value) const
 {
   value.clear();
-  GET_VALUES_MACRO("string", is_string, as_string);
+
+  auto const sx = get_item(key);
+  if (!sx) {
+    return false;
+  } else {
+    assert_is_array(*m_doc, *sx);
+    auto const& item = sx->as_array();
+    for(size_t i = 1; i < item.size(); ++i)
+    {
+      assert_is_string(*m_doc, item[i]);
+      value.emplace_back(item[i].as_string());
+    }
+    return true;
+  }
 }
 
 bool
 ReaderMapping::get(const char* key, std::vector<unsigned int>& value) const
 {
   value.clear();
-  GET_VALUES_MACRO("unsigned int", is_integer, as_int);
+  GET_VALUES_MACRO("unsigned int", is_integer, as_int, true);
 }
 
 #undef GET_VALUES_MACRO
 
+bool
+ReaderMapping::take(const char* key, std::vector<unsigned int>& value) const
+{
+  auto const sx = get_item(key);
+  if (sx && m_doc->take_packed_array(*sx, value)) {
+    return true;
+  } else {
+    return get(key, value);
+  }
+}
+
 bool
 ReaderMapping::get(const char* key, ReaderMapping& value) const
 {
@@ -18,6 +18,7 @@
 #define HEADER_SUPERTUX_UTIL_READER_MAPPING_HPP
 
 #include "util/reader_iterator.hpp"
+#include "util/reader_key_index.hpp"
 
 namespace sexp {
 class Value;
@@ -34,8 +35,6 @@ public:
   // sx should point to (section (name value)...)
   ReaderMapping(const ReaderDocument* doc, const sexp::Value* sx);
 
-  static bool translations_enabled;
-
   ReaderIterator get_iter() const;
 
   bool get(const char* key, bool& value) const;
@@ -54,6 +53,10 @@ public:
   bool get(const char* key, std::vector<std::string>& value) const;
   bool get(const char* key, std::vector<unsigned int>& value) const;
 
+  /** Like get(), but a packed integer list is moved out of the
+      document instead of being copied, so it can only be taken once */
+  bool take(const char* key, std::vector<unsigned int>& value) const;
+
   bool get(const char* key, ReaderMapping&) const;
   bool get(const char* key, ReaderCollection&) const;
 
@@ -69,6 +72,10 @@ private:
   const ReaderDocument* m_doc;
   const sexp::Value* m_sx;
   std::vector<sexp::Value> const* m_arr;
+
+  /** key index of m_sx, owned by the document and fetched on the
+      first lookup */
+  mutable const ReaderKeyIndex* m_index;
 };
 
 #endif
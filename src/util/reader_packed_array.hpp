@@ -0,0 +1,76 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADER_SUPERTUX_UTIL_READER_PACKED_ARRAY_HPP
+#define HEADER_SUPERTUX_UTIL_READER_PACKED_ARRAY_HPP
+
+#include <sexp/value.hpp>
+#include <stddef.h>
+#include <vector>
+
+/** The tiles of a tilemap are not turned into one sexp::Value per
+    number. The parser decodes them straight into a buffer owned by the
+    ReaderDocument and leaves a reference of the form
+    (tiles (supertux-packed-array INDEX)) in the tree, which
+    ReaderMapping resolves transparently for integer lists. Values are
+    kept in the tile id type, negative ones in two's complement, so that
+    a TileMap can take the buffer over as is. */
+typedef std::vector<std::vector<unsigned int> > ReaderPackedArrays;
+
+/** lists with fewer integers are kept as regular values */
+const size_t packed_array_min_size = 64;
+
+/** only integer lists with this name are packed */
+inline const char* packed_array_key()
+{
+  return "tiles";
+}
+
+inline const char* packed_array_marker()
+{
+  return "supertux-packed-array";
+}
+
+inline sexp::Value make_packed_array_ref(size_t index)
+{
+  std::vector<sexp::Value> arr;
+  arr.push_back(sexp::Value::symbol(packed_array_marker()));
+  arr.push_back(sexp::Value::integer(static_cast<int>(index)));
+  return sexp::Value::array(std::move(arr));
+}
+
+/** Returns true if @c sx is a reference created by
+    make_packed_array_ref() and stores the index of the buffer */
+inline bool get_packed_array_ref(const sexp::Value& sx, size_t& index)
+{
+  if (!sx.is_array())
+    return false;
+
+  const auto& arr = sx.as_array();
+  if (arr.size() != 2 ||
+      !arr[0].is_symbol() || arr[0].as_string() != packed_array_marker() ||
+      !arr[1].is_integer())
+  {
+    return false;
+  }
+
+  index = static_cast<size_t>(arr[1].as_int());
+  return true;
+}
+
+#endif
+
+/* EOF */
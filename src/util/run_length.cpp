@@ -0,0 +1,63 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "util/run_length.hpp"
+
+namespace RunLength {
+
+std::vector<unsigned int> encode(const std::vector<uint32_t>& values)
+{
+  std::vector<unsigned int> runs;
+  for(size_t i = 0; i < values.size();)
+  {
+    size_t j = i + 1;
+    while(j < values.size() && values[j] == values[i])
+      ++j;
+
+    runs.push_back(static_cast<unsigned int>(j - i));
+    runs.push_back(values[i]);
+    i = j;
+  }
+  return runs;
+}
+
+bool decode(const std::vector<unsigned int>& runs, size_t expected,
+            std::vector<uint32_t>& values)
+{
+  if(runs.size() % 2 != 0 || expected > MAX_VALUES)
+    return false;
+
+  size_t total = 0;
+  for(size_t i = 0; i < runs.size(); i += 2)
+  {
+    if(runs[i] == 0 || runs[i] > expected - total)
+      return false;
+    total += runs[i];
+  }
+  if(total != expected)
+    return false;
+
+  values.reserve(values.size() + total);
+  for(size_t i = 0; i < runs.size(); i += 2)
+  {
+    values.insert(values.end(), runs[i], runs[i + 1]);
+  }
+  return true;
+}
+
+} // namespace RunLength
+
+/* EOF */
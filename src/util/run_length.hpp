@@ -0,0 +1,46 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADER_SUPERTUX_UTIL_RUN_LENGTH_HPP
+#define HEADER_SUPERTUX_UTIL_RUN_LENGTH_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/** Run-length encoding of tile data as written to (tiles-rle ...):
+    a flat list of COUNT VALUE pairs. */
+namespace RunLength {
+
+/** Largest number of values decode() produces. The tilemap size it
+    is checked against comes from the same file as the runs, so without
+    a cap a few bytes could ask for gigabytes. */
+const size_t MAX_VALUES = 4096 * 4096;
+
+std::vector<unsigned int> encode(const std::vector<uint32_t>& values);
+
+/** Appends the decoded runs to @c values, returns false without
+    touching @c values if @c runs is malformed (odd length or an empty
+    run), doesn't decode to exactly @c expected values or @c expected
+    is larger than MAX_VALUES */
+bool decode(const std::vector<unsigned int>& runs, size_t expected,
+            std::vector<uint32_t>& values);
+
+} // namespace RunLength
+
+#endif
+
+/* EOF */
@@ -0,0 +1,81 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADER_SUPERTUX_UTIL_SPSC_QUEUE_HPP
+#define HEADER_SUPERTUX_UTIL_SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <stddef.h>
+#include <utility>
+#include <vector>
+
+/** Bounded lock-free queue for exactly one producer thread and one
+    consumer thread. Neither side ever blocks, push() fails when the
+    queue is full and pop() when it is empty. */
+template<typename T>
+class SPSCQueue
+{
+public:
+  /** @param capacity  maximum number of queued elements */
+  SPSCQueue(size_t capacity) :
+    m_slots(capacity + 1),
+    m_head(0),
+    m_tail(0)
+  {}
+
+  /** Called by the producer only */
+  bool push(const T& value)
+  {
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    size_t next = (tail + 1) % m_slots.size();
+    if (next == m_head.load(std::memory_order_acquire))
+      return false;
+
+    m_slots[tail] = value;
+    m_tail.store(next, std::memory_order_release);
+    return true;
+  }
+
+  /** Called by the consumer only */
+  bool pop(T& value)
+  {
+    size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail.load(std::memory_order_acquire))
+      return false;
+
+    value = std::move(m_slots[head]);
+    m_head.store((head + 1) % m_slots.size(), std::memory_order_release);
+    return true;
+  }
+
+  bool empty() const
+  {
+    return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+  }
+
+private:
+  std::vector<T> m_slots;
+  std::atomic<size_t> m_head;
+  std::atomic<size_t> m_tail;
+
+private:
+  SPSCQueue(const SPSCQueue&) = delete;
+  SPSCQueue& operator=(const SPSCQueue&) = delete;
+};
+
+#endif
+
+/* EOF */
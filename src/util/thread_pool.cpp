@@ -0,0 +1,96 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "util/thread_pool.hpp"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(int num_threads) :
+  m_threads(),
+  m_jobs(),
+  m_mutex(),
+  m_cond(),
+  m_quit(false)
+{
+  if (num_threads <= 0)
+  {
+    // leave one core for the main thread
+    num_threads = std::max(1, std::min(4, static_cast<int>(std::thread::hardware_concurrency()) - 1));
+  }
+
+  for (int i = 0; i < num_threads; ++i)
+  {
+    m_threads.push_back(std::thread(&ThreadPool::run, this));
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_quit = true;
+    // jobs that haven't started yet are dropped
+    m_jobs.clear();
+  }
+  m_cond.notify_all();
+
+  for (auto& thread : m_threads)
+  {
+    thread.join();
+  }
+}
+
+void
+ThreadPool::post(const Job& job)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_jobs.push_back(job);
+  }
+  m_cond.notify_one();
+}
+
+void
+ThreadPool::post_front(const Job& job)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_jobs.push_front(job);
+  }
+  m_cond.notify_one();
+}
+
+void
+ThreadPool::run()
+{
+  while (true)
+  {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_cond.wait(lock, [this]{ return m_quit || !m_jobs.empty(); });
+      if (m_quit)
+        return;
+
+      job = std::move(m_jobs.front());
+      m_jobs.pop_front();
+    }
+
+    job();
+  }
+}
+
+/* EOF */
@@ -0,0 +1,67 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADER_SUPERTUX_UTIL_THREAD_POOL_HPP
+#define HEADER_SUPERTUX_UTIL_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** A fixed set of worker threads that run posted jobs in FIFO order,
+    except for jobs posted with post_front(). Jobs must not touch the
+    renderer or any other state that is only safe to use from the main
+    thread, logging is fine. */
+class ThreadPool
+{
+public:
+  typedef std::function<void ()> Job;
+
+  /** @param num_threads  number of workers, 0 picks one based on the
+                          number of available cores */
+  ThreadPool(int num_threads = 0);
+  /** Waits for the jobs that are running, jobs that haven't started
+      yet are dropped */
+  ~ThreadPool();
+
+  void post(const Job& job);
+
+  /** Posts a job that runs before all jobs that are still queued */
+  void post_front(const Job& job);
+
+  int get_num_threads() const { return static_cast<int>(m_threads.size()); }
+
+private:
+  void run();
+
+private:
+  std::vector<std::thread> m_threads;
+  std::deque<Job> m_jobs;
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+  bool m_quit;
+
+private:
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+};
+
+#endif
+
+/* EOF */
@@ -0,0 +1,318 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "util/translation_catalog.hpp"
+
+#include <stdio.h>
+#include <string.h>
+#include <fstream>
+#include <tinygettext/dictionary.hpp>
+
+namespace {
+
+/** Start of a catalog file, followed by the path of the .po file,
+    padding to a multiple of four bytes and the table. Catalogs are
+    only read back on the machine that wrote them, so native byte
+    order is fine. */
+struct FileHeader
+{
+  char magic[4];
+  uint32_t version;
+  int64_t mtime;
+  int64_t size;
+  uint32_t source_length;
+  uint32_t table_size;
+};
+
+/** Start of the table, followed by the buckets (entry index + 1, 0
+    for an empty bucket), the entries and the string data */
+struct TableHeader
+{
+  uint32_t bucket_count;
+  uint32_t entry_count;
+  uint32_t strings_size;
+  uint32_t reserved;
+};
+
+struct Entry
+{
+  uint32_t hash;
+  uint32_t msgid_offset;
+  uint32_t msgid_length;
+  uint32_t msgstr_offset;
+  uint32_t msgstr_length;
+};
+
+const char file_magic[4] = { 'S', 'T', 'M', 'O' };
+
+uint32_t hash_string(const char* str, size_t length)
+{
+  // FNV-1a
+  uint32_t hash = 2166136261U;
+  for(size_t i = 0; i < length; ++i)
+  {
+    hash ^= static_cast<unsigned char>(str[i]);
+    hash *= 16777619U;
+  }
+  return hash;
+}
+
+size_t padding(size_t size)
+{
+  return (4 - size % 4) % 4;
+}
+
+} // namespace
+
+TranslationCatalog::TranslationCatalog() :
+  m_file(),
+  m_buffer(),
+  m_table(nullptr),
+  m_table_size(0),
+  m_bucket_count(0),
+  m_entry_count(0),
+  m_strings_size(0)
+{
+}
+
+void
+TranslationCatalog::build(const std::vector<std::pair<std::string, std::string> >& entries)
+{
+  uint32_t bucket_count = 2;
+  while(bucket_count < entries.size() * 2)
+    bucket_count *= 2;
+
+  std::vector<uint32_t> buckets(bucket_count, 0);
+  std::vector<Entry> records;
+  std::vector<char> strings;
+  records.reserve(entries.size());
+  for(const auto& it : entries)
+  {
+    if(it.first.empty() || it.second.empty())
+      continue;
+
+    Entry entry;
+    entry.hash = hash_string(it.first.data(), it.first.size());
+
+    uint32_t bucket = entry.hash & (bucket_count - 1);
+    bool duplicate = false;
+    while(buckets[bucket] != 0)
+    {
+      const Entry& other = records[buckets[bucket] - 1];
+      if(other.hash == entry.hash && other.msgid_length == it.first.size() &&
+         it.first.compare(0, std::string::npos, strings.data() + other.msgid_offset, other.msgid_length) == 0)
+      {
+        duplicate = true;
+        break;
+      }
+      bucket = (bucket + 1) & (bucket_count - 1);
+    }
+    if(duplicate)
+      continue;
+
+    entry.msgid_offset = static_cast<uint32_t>(strings.size());
+    entry.msgid_length = static_cast<uint32_t>(it.first.size());
+    strings.insert(strings.end(), it.first.begin(), it.first.end());
+    entry.msgstr_offset = static_cast<uint32_t>(strings.size());
+    entry.msgstr_length = static_cast<uint32_t>(it.second.size());
+    strings.insert(strings.end(), it.second.begin(), it.second.end());
+
+    records.push_back(entry);
+    buckets[bucket] = static_cast<uint32_t>(records.size());
+  }
+
+  TableHeader header;
+  header.bucket_count = bucket_count;
+  header.entry_count = static_cast<uint32_t>(records.size());
+  header.strings_size = static_cast<uint32_t>(strings.size());
+  header.reserved = 0;
+
+  m_file.close();
+  m_buffer.resize(sizeof(header) + buckets.size() * sizeof(uint32_t) +
+                  records.size() * sizeof(Entry) + strings.size());
+  char* out = m_buffer.data();
+  memcpy(out, &header, sizeof(header));
+  out += sizeof(header);
+  memcpy(out, buckets.data(), buckets.size() * sizeof(uint32_t));
+  out += buckets.size() * sizeof(uint32_t);
+  if(!records.empty())
+    memcpy(out, records.data(), records.size() * sizeof(Entry));
+  out += records.size() * sizeof(Entry);
+  if(!strings.empty())
+    memcpy(out, strings.data(), strings.size());
+
+  attach(m_buffer.data(), m_buffer.size());
+}
+
+void
+TranslationCatalog::build(tinygettext::Dictionary& dictionary)
+{
+  std::vector<std::pair<std::string, std::string> > entries;
+  dictionary.foreach([&entries](const std::string& msgid, const std::vector<std::string>& msgstrs) {
+      if(!msgstrs.empty())
+        entries.push_back(std::make_pair(msgid, msgstrs[0]));
+    });
+  build(entries);
+}
+
+bool
+TranslationCatalog::attach(const char* data, size_t size)
+{
+  TableHeader header;
+  if(size < sizeof(header))
+    return false;
+  memcpy(&header, data, sizeof(header));
+
+  uint64_t expected = sizeof(header) +
+    uint64_t(header.bucket_count) * sizeof(uint32_t) +
+    uint64_t(header.entry_count) * sizeof(Entry) +
+    header.strings_size;
+  if(header.bucket_count == 0 ||
+     (header.bucket_count & (header.bucket_count - 1)) != 0 ||
+     header.entry_count >= header.bucket_count ||
+     expected != size)
+  {
+    return false;
+  }
+
+  m_table = data;
+  m_table_size = size;
+  m_bucket_count = header.bucket_count;
+  m_entry_count = header.entry_count;
+  m_strings_size = header.strings_size;
+  return true;
+}
+
+bool
+TranslationCatalog::load(const std::string& path, const std::string& source, int64_t mtime, int64_t size)
+{
+  m_table = nullptr;
+  m_bucket_count = 0;
+  m_entry_count = 0;
+  m_buffer.clear();
+
+  if(!m_file.open(path) || m_file.get_size() < sizeof(FileHeader))
+    return false;
+
+  FileHeader header;
+  memcpy(&header, m_file.get_data(), sizeof(header));
+  size_t table_offset = sizeof(header) + header.source_length + padding(header.source_length);
+  if(memcmp(header.magic, file_magic, sizeof(file_magic)) != 0 ||
+     header.version != VERSION ||
+     header.mtime != mtime ||
+     header.size != size ||
+     header.source_length != source.size() ||
+     m_file.get_size() != table_offset + header.table_size ||
+     source.compare(0, std::string::npos, m_file.get_data() + sizeof(header), header.source_length) != 0 ||
+     !attach(m_file.get_data() + table_offset, header.table_size))
+  {
+    m_file.close();
+    return false;
+  }
+
+  return true;
+}
+
+bool
+TranslationCatalog::save(const std::string& path, const std::string& source, int64_t mtime, int64_t size) const
+{
+  if(!m_table)
+    return false;
+
+  FileHeader header;
+  memcpy(header.magic, file_magic, sizeof(file_magic));
+  header.version = VERSION;
+  header.mtime = mtime;
+  header.size = size;
+  header.source_length = static_cast<uint32_t>(source.size());
+  header.table_size = static_cast<uint32_t>(m_table_size);
+
+  // write to a temporary file first so a crash never leaves a
+  // truncated catalog behind
+  std::string tmp_path = path + ".tmp";
+  {
+    const char zeros[4] = { 0, 0, 0, 0 };
+    std::ofstream out(tmp_path.c_str(), std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(source.data(), source.size());
+    out.write(zeros, padding(source.size()));
+    out.write(m_table, m_table_size);
+    if(!out)
+    {
+      out.close();
+      remove(tmp_path.c_str());
+      return false;
+    }
+  }
+
+  remove(path.c_str());
+  if(rename(tmp_path.c_str(), path.c_str()) != 0)
+  {
+    remove(tmp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+const char*
+TranslationCatalog::find(const char* msgid, size_t msgid_length, size_t& result_length) const
+{
+  if(!m_table || m_entry_count == 0)
+    return nullptr;
+
+  const char* buckets = m_table + sizeof(TableHeader);
+  const char* entries = buckets + size_t(m_bucket_count) * sizeof(uint32_t);
+  const char* strings = entries + size_t(m_entry_count) * sizeof(Entry);
+
+  uint32_t hash = hash_string(msgid, msgid_length);
+  uint32_t bucket = hash & (m_bucket_count - 1);
+  for(uint32_t probes = 0; probes < m_bucket_count; ++probes)
+  {
+    uint32_t index;
+    memcpy(&index, buckets + size_t(bucket) * sizeof(uint32_t), sizeof(index));
+    if(index == 0 || index > m_entry_count)
+      return nullptr;
+
+    Entry entry;
+    memcpy(&entry, entries + size_t(index - 1) * sizeof(Entry), sizeof(entry));
+    if(entry.hash == hash &&
+       entry.msgid_length == msgid_length &&
+       uint64_t(entry.msgid_offset) + entry.msgid_length <= m_strings_size &&
+       uint64_t(entry.msgstr_offset) + entry.msgstr_length <= m_strings_size &&
+       memcmp(strings + entry.msgid_offset, msgid, msgid_length) == 0)
+    {
+      result_length = entry.msgstr_length;
+      return strings + entry.msgstr_offset;
+    }
+
+    bucket = (bucket + 1) & (m_bucket_count - 1);
+  }
+  return nullptr;
+}
+
+bool
+TranslationCatalog::find(const std::string& msgid, std::string& result) const
+{
+  size_t length;
+  const char* str = find(msgid.data(), msgid.size(), length);
+  if(!str)
+    return false;
+
+  result.assign(str, length);
+  return true;
+}
+
+/* EOF */
@@ -0,0 +1,92 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADER_SUPERTUX_UTIL_TRANSLATION_CATALOG_HPP
+#define HEADER_SUPERTUX_UTIL_TRANSLATION_CATALOG_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "util/mapped_file.hpp"
+
+namespace tinygettext {
+class Dictionary;
+} // namespace tinygettext
+
+/** The singular translations of one .po file compiled into an open
+    addressing hash table. The table is a single flat block (buckets,
+    entries, string data) that is written to the user dir as is and
+    memory-mapped on the next run, so looking up a message never needs
+    the .po file to be parsed again. */
+class TranslationCatalog
+{
+public:
+  /** bump whenever the table layout changes */
+  static const int VERSION = 1;
+
+  TranslationCatalog();
+
+  /** Builds the table from msgid/msgstr pairs, empty translations
+      and the header entry are skipped */
+  void build(const std::vector<std::pair<std::string, std::string> >& entries);
+
+  /** Builds the table from the singular translations of @c dictionary */
+  void build(tinygettext::Dictionary& dictionary);
+
+  /** Maps a table written by save(), returns false if the file is
+      missing or corrupt or was compiled from another version of the
+      .po file @c source */
+  bool load(const std::string& path, const std::string& source, int64_t mtime, int64_t size);
+
+  /** Writes the table to the native file @c path, stamped with the
+      modification time and size of @c source */
+  bool save(const std::string& path, const std::string& source, int64_t mtime, int64_t size) const;
+
+  /** Returns the translation of @c msgid or nullptr if there is none,
+      the result stays valid as long as the catalog */
+  const char* find(const char* msgid, size_t msgid_length, size_t& result_length) const;
+
+  /** Stores the translation of @c msgid in @c result, returns false
+      if there is none */
+  bool find(const std::string& msgid, std::string& result) const;
+
+  size_t size() const { return m_entry_count; }
+
+private:
+  /** Points the table members into @c data, returns false if the
+      table doesn't fit into @c size bytes */
+  bool attach(const char* data, size_t size);
+
+private:
+  MappedFile m_file;
+  std::vector<char> m_buffer;
+  const char* m_table;
+  size_t m_table_size;
+  uint32_t m_bucket_count;
+  uint32_t m_entry_count;
+  uint32_t m_strings_size;
+
+private:
+  TranslationCatalog(const TranslationCatalog&) = delete;
+  TranslationCatalog& operator=(const TranslationCatalog&) = delete;
+};
+
+#endif
+
+/* EOF */
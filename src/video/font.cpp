@@ -26,6 +26,7 @@
 #include <SDL_image.h>
 #include <physfs.h>
 
+#include "physfs/physfs_directory_index.hpp"
 #include "physfs/physfs_sdl.hpp"
 #include "supertux/screen.hpp"
 #include "util/file_system.hpp"
@@ -75,9 +76,7 @@ Font::Font(GlyphWidth glyph_width_,
   const std::string fontname = FileSystem::basename(filename);
 
   // scan for prefix-filename in addons search path
-  char **rc = PHYSFS_enumerateFiles(fontdir.c_str());
-  for (char **i = rc; *i != NULL; i++) {
-    std::string filename_(*i);
+  for (const auto& filename_ : PhysFSDirectoryIndex::enumerate(fontdir)) {
     if( filename_.rfind(fontname) != std::string::npos ) {
       try {
         loadFontFile(fontdir + filename_);
@@ -88,7 +87,6 @@ Font::Font(GlyphWidth glyph_width_,
       }
     }
   }
-  PHYSFS_freeList(rc);
 }
 
 void
@@ -0,0 +1,211 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "video/image_cache.hpp"
+
+#include <physfs.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include "physfs/physfs_file_system.hpp"
+#include "util/log.hpp"
+#include "util/mapped_file.hpp"
+
+namespace {
+
+/** Layout of the start of a cache entry, followed by the image path
+    and the pixel rows. Entries are only read back on the machine that
+    wrote them, so native byte order is fine. */
+struct EntryHeader
+{
+  char magic[4];
+  uint32_t version;
+  int64_t mtime;
+  int64_t filesize;
+  uint32_t width;
+  uint32_t height;
+  uint32_t pitch;
+  uint32_t bpp;
+  uint32_t rmask;
+  uint32_t gmask;
+  uint32_t bmask;
+  uint32_t amask;
+  uint32_t path_length;
+};
+
+const char entry_magic[4] = { 'S', 'T', 'I', 'C' };
+
+bool get_stamp(const std::string& filename, int64_t& mtime, int64_t& filesize)
+{
+  PHYSFS_Stat statbuf;
+  if(!PHYSFS_stat(filename.c_str(), &statbuf) ||
+     statbuf.filetype != PHYSFS_FILETYPE_REGULAR)
+  {
+    return false;
+  }
+
+  mtime = statbuf.modtime;
+  filesize = statbuf.filesize;
+  return true;
+}
+
+} // namespace
+
+ImageCache::ImageCache(const std::string& directory) :
+  m_directory(),
+  m_hits(0),
+  m_misses(0),
+  m_tmp_counter(0)
+{
+  if(!PhysFSFileSystem::mkdir(directory))
+  {
+    log_warning << "Couldn't create image cache directory '" << directory << "': "
+                << PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()) << std::endl;
+  }
+
+  const char* writedir = PHYSFS_getWriteDir();
+  if(writedir)
+  {
+    m_directory = std::string(writedir) + "/" + directory;
+  }
+}
+
+std::string
+ImageCache::get_entry_path(const std::string& filename) const
+{
+  // FNV-1a, the full path is stored in the entry to catch collisions
+  uint64_t hash = 14695981039346656037ULL;
+  for(const auto& c : filename)
+  {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+
+  char name[32];
+  snprintf(name, sizeof(name), "%016llx.img", static_cast<unsigned long long>(hash));
+  return m_directory + "/" + name;
+}
+
+SDL_Surface*
+ImageCache::load(const std::string& filename)
+{
+  int64_t mtime;
+  int64_t filesize;
+  MappedFile entry;
+  if(m_directory.empty() ||
+     !get_stamp(filename, mtime, filesize) ||
+     !entry.open(get_entry_path(filename)) ||
+     entry.get_size() < sizeof(EntryHeader))
+  {
+    m_misses += 1;
+    return nullptr;
+  }
+
+  EntryHeader header;
+  memcpy(&header, entry.get_data(), sizeof(header));
+  size_t pixels_offset = sizeof(header) + header.path_length;
+  if(memcmp(header.magic, entry_magic, sizeof(entry_magic)) != 0 ||
+     header.version != VERSION ||
+     header.mtime != mtime ||
+     header.filesize != filesize ||
+     header.path_length != filename.size() ||
+     entry.get_size() < pixels_offset + size_t(header.pitch) * header.height ||
+     filename.compare(0, std::string::npos, entry.get_data() + sizeof(header), header.path_length) != 0)
+  {
+    m_misses += 1;
+    return nullptr;
+  }
+
+  SDL_Surface* surface = SDL_CreateRGBSurface(0, header.width, header.height, header.bpp,
+                                              header.rmask, header.gmask,
+                                              header.bmask, header.amask);
+  if(!surface)
+  {
+    m_misses += 1;
+    return nullptr;
+  }
+
+  const char* src = entry.get_data() + pixels_offset;
+  char* dst = static_cast<char*>(surface->pixels);
+  size_t row_bytes = std::min(size_t(surface->pitch), size_t(header.pitch));
+  for(uint32_t y = 0; y < header.height; ++y)
+  {
+    memcpy(dst + y * surface->pitch, src + y * header.pitch, row_bytes);
+  }
+
+  m_hits += 1;
+  return surface;
+}
+
+void
+ImageCache::store(const std::string& filename, SDL_Surface* surface)
+{
+  Uint32 colorkey;
+  if(m_directory.empty() ||
+     SDL_MUSTLOCK(surface) ||
+     surface->format->palette ||
+     SDL_GetColorKey(surface, &colorkey) == 0)
+  {
+    // only plain pixel data survives the round trip through the cache
+    return;
+  }
+
+  EntryHeader header;
+  memcpy(header.magic, entry_magic, sizeof(entry_magic));
+  header.version = VERSION;
+  if(!get_stamp(filename, header.mtime, header.filesize))
+    return;
+  header.width = surface->w;
+  header.height = surface->h;
+  header.pitch = surface->pitch;
+  header.bpp = surface->format->BitsPerPixel;
+  header.rmask = surface->format->Rmask;
+  header.gmask = surface->format->Gmask;
+  header.bmask = surface->format->Bmask;
+  header.amask = surface->format->Amask;
+  header.path_length = static_cast<uint32_t>(filename.size());
+
+  // write to a temporary file first so a crash never leaves a
+  // truncated entry behind
+  std::string path = get_entry_path(filename);
+  std::ostringstream tmp_path;
+  tmp_path << path << ".tmp" << m_tmp_counter++;
+  {
+    std::ofstream out(tmp_path.str().c_str(), std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(filename.data(), filename.size());
+    out.write(static_cast<const char*>(surface->pixels), std::streamsize(surface->pitch) * surface->h);
+    if(!out)
+    {
+      log_debug << "Couldn't write image cache entry for '" << filename << "'" << std::endl;
+      out.close();
+      remove(tmp_path.str().c_str());
+      return;
+    }
+  }
+
+  remove(path.c_str());
+  if(rename(tmp_path.str().c_str(), path.c_str()) != 0)
+  {
+    remove(tmp_path.str().c_str());
+  }
+}
+
+/* EOF */
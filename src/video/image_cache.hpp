@@ -0,0 +1,65 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADER_SUPERTUX_VIDEO_IMAGE_CACHE_HPP
+#define HEADER_SUPERTUX_VIDEO_IMAGE_CACHE_HPP
+
+#include <SDL_video.h>
+
+#include <atomic>
+#include <string>
+
+/** Persistent cache of decoded and converted images in the user
+    directory. Entries are keyed by the PhysFS path of the image and
+    are only used while the modification time and size of the image
+    file still match, so a warm start can skip the image codecs. All
+    functions are safe to call from the decode worker threads. */
+class ImageCache
+{
+public:
+  /** bump whenever the entry layout changes */
+  static const int VERSION = 1;
+
+  /** @param directory  PhysFS directory below the write dir */
+  ImageCache(const std::string& directory);
+
+  /** Returns a new surface with the cached pixels of @c filename or
+      nullptr if there is no valid entry for it */
+  SDL_Surface* load(const std::string& filename);
+
+  /** Writes the decoded pixels of @c filename to the cache */
+  void store(const std::string& filename, SDL_Surface* surface);
+
+  int get_hits() const { return m_hits; }
+  int get_misses() const { return m_misses; }
+
+private:
+  std::string get_entry_path(const std::string& filename) const;
+
+private:
+  std::string m_directory;
+  std::atomic<int> m_hits;
+  std::atomic<int> m_misses;
+  std::atomic<int> m_tmp_counter;
+
+private:
+  ImageCache(const ImageCache&) = delete;
+  ImageCache& operator=(const ImageCache&) = delete;
+};
+
+#endif
+
+/* EOF */
@@ -62,11 +62,18 @@ SDLPainter::draw_surface(SDL_Renderer* renderer, const DrawingRequest& request)
   const auto surface = static_cast<const SurfaceRequest*>(request.request_data)->surface;
   std::shared_ptr<SDLTexture> sdltexture = std::dynamic_pointer_cast<SDLTexture>(surface->get_texture());
 
+  // the surface may only cover a part of the texture, e.g. on an atlas page
+  SDL_Rect src_rect;
+  src_rect.x = surface->get_x();
+  src_rect.y = surface->get_y();
+  src_rect.w = surface->get_width();
+  src_rect.h = surface->get_height();
+
   SDL_Rect dst_rect;
   dst_rect.x = request.pos.x;
   dst_rect.y = request.pos.y;
-  dst_rect.w = sdltexture->get_image_width();
-  dst_rect.h = sdltexture->get_image_height();
+  dst_rect.w = surface->get_width();
+  dst_rect.h = surface->get_height();
 
   Uint8 r = static_cast<Uint8>(request.color.red * 255);
   Uint8 g = static_cast<Uint8>(request.color.green * 255);
@@ -87,7 +94,7 @@ SDLPainter::draw_surface(SDL_Renderer* renderer, const DrawingRequest& request)
     flip = static_cast<SDL_RendererFlip>(flip | SDL_FLIP_VERTICAL);
   }
 
-  SDL_RenderCopyEx(renderer, sdltexture->get_texture(), NULL, &dst_rect, request.angle, NULL, flip);
+  SDL_RenderCopyEx(renderer, sdltexture->get_texture(), &src_rect, &dst_rect, request.angle, NULL, flip);
 }
 
 void
@@ -100,8 +107,8 @@ SDLPainter::draw_surface_part(SDL_Renderer* renderer, const DrawingRequest& requ
   std::shared_ptr<SDLTexture> sdltexture = std::dynamic_pointer_cast<SDLTexture>(surface->surface->get_texture());
 
   SDL_Rect src_rect;
-  src_rect.x = surfacepartrequest->srcrect.p1.x;
-  src_rect.y = surfacepartrequest->srcrect.p1.y;
+  src_rect.x = surface->surface->get_x() + surfacepartrequest->srcrect.p1.x;
+  src_rect.y = surface->surface->get_y() + surfacepartrequest->srcrect.p1.y;
   src_rect.w = surfacepartrequest->srcrect.get_width();
   src_rect.h = surfacepartrequest->srcrect.get_height();
 
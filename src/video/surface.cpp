@@ -21,6 +21,7 @@
 #include <SDL.h>
 
 #include "video/texture.hpp"
+#include "video/texture_manager.hpp"
 #include "video/video_system.hpp"
 
 SurfacePtr
@@ -35,6 +36,22 @@ Surface::create(const std::string& file, const Rect& rect)
   return SurfacePtr(new Surface(file, rect));
 }
 
+SurfacePtr
+Surface::create_async(const std::string& file)
+{
+  TexturePtr texture = TextureManager::current()->get_cached(file);
+  if (texture)
+  {
+    return SurfacePtr(new Surface(texture));
+  }
+  else
+  {
+    SurfacePtr surface(new Surface(TextureManager::current()->get_placeholder()));
+    TextureManager::current()->load_async(file, surface);
+    return surface;
+  }
+}
+
 Surface::Surface(const std::string& file) :
   texture(TextureManager::current()->get(file)),
   surface_data(),
@@ -55,6 +72,26 @@ Surface::Surface(const std::string& file, const Rect& rect_) :
   surface_data = VideoSystem::current()->new_surface_data(*this);
 }
 
+Surface::Surface(const TexturePtr& texture_) :
+  texture(texture_),
+  surface_data(),
+  rect(0, 0,
+      Size(texture->get_image_width(),
+           texture->get_image_height())),
+  flipx(false)
+{
+  surface_data = VideoSystem::current()->new_surface_data(*this);
+}
+
+Surface::Surface(const TexturePtr& texture_, const Rect& rect_) :
+  texture(texture_),
+  surface_data(),
+  rect(rect_),
+  flipx(false)
+{
+  surface_data = VideoSystem::current()->new_surface_data(*this);
+}
+
 Surface::Surface(const Surface& rhs) :
   texture(rhs.texture),
   surface_data(),
@@ -76,6 +113,17 @@ Surface::clone() const
   return surface;
 }
 
+void
+Surface::set_texture(const TexturePtr& texture_)
+{
+  VideoSystem::current()->free_surface_data(surface_data);
+
+  texture = texture_;
+  rect = Rect(0, 0, Size(texture->get_image_width(),
+                         texture->get_image_height()));
+  surface_data = VideoSystem::current()->new_surface_data(*this);
+}
+
 /** flip the surface horizontally */
 void Surface::hflip()
 {
@@ -93,6 +141,12 @@ Surface::get_texture() const
   return texture;
 }
 
+bool
+Surface::is_pending() const
+{
+  return texture == TextureManager::current()->get_placeholder();
+}
+
 SurfaceData*
 Surface::get_surface_data() const
 {
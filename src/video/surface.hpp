@@ -36,7 +36,14 @@ public:
   static SurfacePtr create(const std::string& file);
   static SurfacePtr create(const std::string& file, const Rect& rect);
 
+  /** Creates a surface for images that aren't needed right away: it
+      shows a transparent placeholder until @c file has been decoded in
+      the background, so its size isn't final until then either. */
+  static SurfacePtr create_async(const std::string& file);
+
 private:
+  friend class TextureManager;
+
   TexturePtr texture;
   SurfaceData* surface_data;
   Rect rect;
@@ -45,8 +52,12 @@ private:
 private:
   Surface(const std::string& file);
   Surface(const std::string& file, const Rect& rect);
+  Surface(const TexturePtr& texture);
+  Surface(const TexturePtr& texture, const Rect& rect);
   Surface(const Surface&);
 
+  void set_texture(const TexturePtr& texture);
+
 public:
   ~Surface();
 
@@ -57,6 +68,9 @@ public:
   bool get_flipx() const;
 
   TexturePtr get_texture() const;
+
+  /** true while a surface from create_async() still shows its placeholder */
+  bool is_pending() const;
   SurfaceData* get_surface_data() const;
   int get_x() const;
   int get_y() const;
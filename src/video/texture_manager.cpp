@@ -17,7 +17,10 @@
 #include "video/texture_manager.hpp"
 
 #include <SDL_image.h>
+#include <algorithm>
 #include <assert.h>
+#include <chrono>
+#include <string.h>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
@@ -26,7 +29,10 @@
 #include "physfs/physfs_sdl.hpp"
 #include "util/file_system.hpp"
 #include "util/log.hpp"
+#include "util/thread_pool.hpp"
+#include "video/image_cache.hpp"
 #include "video/sdl_surface_ptr.hpp"
+#include "video/surface.hpp"
 #include "video/texture.hpp"
 #include "video/video_system.hpp"
 
@@ -34,9 +40,39 @@
 #include "video/gl/gl_texture.hpp"
 #endif
 
+namespace {
+
+/** number of decodes prefetch() may have in flight or waiting to be
+    consumed */
+const size_t MAX_PENDING_DECODES = 64;
+
+} // namespace
+
 TextureManager::TextureManager() :
-  m_image_textures()
-  ,m_surfaces()
+  m_retained_textures(),
+  m_image_textures(),
+  m_surface_lru(),
+  m_surfaces(),
+  m_texture_budget(64 * 1024 * 1024),
+  m_surface_budget(32 * 1024 * 1024),
+  m_texture_bytes(0),
+  m_retained_bytes(0),
+  m_surface_bytes(0),
+  m_hits(0),
+  m_misses(0),
+  m_evictions(0),
+  m_decode_jobs(),
+  m_decode_mutex(),
+  m_decode_cond(),
+  m_decoded_bytes(0),
+  m_async_loads(),
+  m_placeholder(),
+  m_decode_pool(),
+  m_images_decoded(0),
+  m_images_from_cache(0),
+  m_decode_usec(0),
+  m_cache_usec(0),
+  m_image_cache()
 #ifdef HAVE_OPENGL
   ,m_textures(),
   m_saved_textures()
@@ -46,36 +82,48 @@ TextureManager::TextureManager() :
 
 TextureManager::~TextureManager()
 {
+  // stop the workers before throwing away the jobs they report into
+  m_decode_pool.reset();
+  for(auto& job : m_decode_jobs)
+  {
+    SDL_FreeSurface(job.second->surface);
+  }
+  m_decode_jobs.clear();
+  m_async_loads.clear();
+  m_placeholder.reset();
+
+  // releasing the retained textures reaps their cache entries, which
+  // must not be marked as retained anymore by then
+  for(auto& texture : m_image_textures)
+  {
+    texture.second.retained = false;
+  }
+  m_retained_bytes = 0;
+  RetainedTextures retained;
+  retained.swap(m_retained_textures);
+  retained.clear();
+
   for(const auto& texture : m_image_textures)
   {
-    if(!texture.second.expired())
+    if(!texture.second.texture.expired())
     {
       log_warning << "Texture '" << texture.first << "' not freed" << std::endl;
     }
   }
   m_image_textures.clear();
 
-  for(auto& surface : m_surfaces)
-  {
-    SDL_FreeSurface(surface.second);
-  }
-  m_surfaces.clear();
+  release_surfaces();
 }
 
 TexturePtr
 TextureManager::get(const std::string& _filename)
 {
   std::string filename = FileSystem::normalize(_filename);
-  auto i = m_image_textures.find(filename);
-
-  TexturePtr texture;
-  if(i != m_image_textures.end())
-    texture = i->second.lock();
 
+  TexturePtr texture = lookup(filename);
   if(!texture) {
     texture = create_image_texture(filename);
-    texture->cache_filename = filename;
-    m_image_textures[filename] = texture;
+    insert(filename, texture);
   }
 
   return texture;
@@ -90,30 +138,582 @@ TextureManager::get(const std::string& _filename, const Rect& rect)
                     std::to_string(rect.top)   + "|" +
                     std::to_string(rect.right) + "|" +
                     std::to_string(rect.bottom);
-  auto i = m_image_textures.find(key);
-
-  TexturePtr texture;
-  if(i != m_image_textures.end())
-    texture = i->second.lock();
 
+  TexturePtr texture = lookup(key);
   if(!texture) {
     texture = create_image_texture(filename, rect);
-    texture->cache_filename = key;
-    m_image_textures[key] = texture;
+    insert(key, texture);
   }
 
   return texture;
 }
 
+void
+TextureManager::set_budget(size_t texture_bytes, size_t surface_bytes)
+{
+  m_texture_budget = texture_bytes;
+  m_surface_budget = surface_bytes;
+
+  evict_textures();
+  evict_surfaces(std::string());
+}
+
+void
+TextureManager::release_surfaces()
+{
+  for(auto& surface : m_surfaces)
+  {
+    SDL_FreeSurface(surface.second.surface);
+  }
+  m_surfaces.clear();
+  m_surface_lru.clear();
+  m_surface_bytes = 0;
+
+  drop_decoded(true);
+}
+
+void
+TextureManager::enable_image_cache(const std::string& directory)
+{
+  m_image_cache.reset(new ImageCache(directory));
+}
+
+void
+TextureManager::print_image_stats(std::ostream& out) const
+{
+  out << "Images: " << m_images_decoded << " decoded in "
+      << m_decode_usec / 1000 << " ms, " << m_images_from_cache
+      << " read from cache in " << m_cache_usec / 1000 << " ms" << std::endl;
+}
+
+void
+TextureManager::print_stats(std::ostream& out) const
+{
+  size_t lookups = m_hits + m_misses;
+  out << "Textures: " << m_image_textures.size()
+      << " resident, " << m_texture_bytes / 1024 << " KiB"
+      << " (" << m_retained_textures.size() << " retained, "
+      << m_retained_bytes / 1024 << " KiB), budget "
+      << m_texture_budget / 1024 << " KiB" << std::endl;
+  out << "Surfaces: " << m_surfaces.size()
+      << " resident, " << m_surface_bytes / 1024 << " KiB, budget "
+      << m_surface_budget / 1024 << " KiB" << std::endl;
+  out << "Hits: " << m_hits << ", misses: " << m_misses
+      << " (" << (lookups ? 100 * m_hits / lookups : 0) << "% hit rate)"
+      << ", evictions: " << m_evictions << std::endl;
+  print_image_stats(out);
+}
+
+void
+TextureManager::prefetch(const std::vector<std::string>& filenames)
+{
+  for(const auto& _filename : filenames)
+  {
+    std::string filename = FileSystem::normalize(_filename);
+    if(m_surfaces.find(filename) != m_surfaces.end())
+      continue;
+
+    auto i = m_image_textures.find(filename);
+    if(i != m_image_textures.end() && !i->second.texture.expired())
+      continue;
+
+    // prefetching is only a hint, don't queue up more than the workers
+    // can get through in a while
+    if(m_decode_jobs.size() >= MAX_PENDING_DECODES)
+      break;
+
+    start_decode(filename);
+  }
+}
+
+void
+TextureManager::load_async(const std::string& _filename, const SurfacePtr& surface)
+{
+  std::string filename = FileSystem::normalize(_filename);
+  start_decode(filename);
+  m_async_loads[filename].push_back(surface);
+}
+
+TexturePtr
+TextureManager::get_cached(const std::string& _filename)
+{
+  return lookup(FileSystem::normalize(_filename));
+}
+
+TexturePtr
+TextureManager::get_placeholder()
+{
+  if(!m_placeholder)
+  {
+    SDLSurfacePtr image(SDL_CreateRGBSurface(0, 1, 1, 32,
+                                             0xff000000, 0x00ff0000,
+                                             0x0000ff00, 0x000000ff));
+    if (!image)
+    {
+      throw std::runtime_error("SDL_CreateRGBSurface() call failed");
+    }
+    *static_cast<Uint32*>(image->pixels) = 0;
+    m_placeholder = VideoSystem::current()->new_texture(image.get());
+  }
+  return m_placeholder;
+}
+
+void
+TextureManager::update()
+{
+  for(auto i = m_async_loads.begin(); i != m_async_loads.end();)
+  {
+    auto job = m_decode_jobs.find(i->first);
+    if(job != m_decode_jobs.end())
+    {
+      std::lock_guard<std::mutex> lock(m_decode_mutex);
+      if(!job->second->done)
+      {
+        ++i;
+        continue;
+      }
+    }
+
+    // either done or already consumed by a synchronous get()
+    TexturePtr texture = get(i->first);
+    for(const auto& weak_surface : i->second)
+    {
+      SurfacePtr surface = weak_surface.lock();
+      if(surface)
+        surface->set_texture(texture);
+    }
+    i = m_async_loads.erase(i);
+  }
+
+  drop_decoded(false);
+}
+
+namespace {
+
+/** width and maximum height of an atlas page */
+const int atlas_page_size = 1024;
+
+/** every frame is surrounded by a copy of its edge pixels, so that
+    filtering doesn't bleed neighbouring frames into it */
+const int atlas_padding = 1;
+
+/** Copies the 32 bit pixels of @c src into @c dst at x, y including the
+    extruded border. Both surfaces must share the same pixel format. */
+void blit_extruded(SDL_Surface* src, SDL_Surface* dst, int x, int y)
+{
+  const int bpp = 4;
+  const int row_bytes = src->w * bpp;
+  const int p = atlas_padding;
+  auto dst_row = [dst](int row) {
+    return static_cast<uint8_t*>(dst->pixels) + row * dst->pitch;
+  };
+
+  for(int row = 0; row < src->h; ++row)
+  {
+    const uint8_t* srcp = static_cast<const uint8_t*>(src->pixels) + row * src->pitch;
+    uint8_t* dstp = dst_row(y + p + row) + x * bpp;
+    for(int i = 0; i < p; ++i)
+    {
+      memcpy(dstp + i * bpp, srcp, bpp);
+      memcpy(dstp + (p + src->w + i) * bpp, srcp + row_bytes - bpp, bpp);
+    }
+    memcpy(dstp + p * bpp, srcp, row_bytes);
+  }
+
+  const int full_row_bytes = (src->w + 2 * p) * bpp;
+  for(int i = 0; i < p; ++i)
+  {
+    memcpy(dst_row(y + i) + x * bpp, dst_row(y + p) + x * bpp, full_row_bytes);
+    memcpy(dst_row(y + p + src->h + i) + x * bpp, dst_row(y + p + src->h - 1) + x * bpp, full_row_bytes);
+  }
+}
+
+} // namespace
+
+std::vector<SurfacePtr>
+TextureManager::create_atlas(const std::vector<std::string>& filenames)
+{
+  std::vector<SurfacePtr> result(filenames.size());
+
+  // grab a converted copy of every frame, the source surfaces may be
+  // evicted while the later ones are loaded
+  std::vector<std::shared_ptr<SDL_Surface> > frames(filenames.size());
+  for(size_t i = 0; i < filenames.size(); ++i)
+  {
+    try
+    {
+      SDL_Surface* image = get_source_surface(FileSystem::normalize(filenames[i]));
+      SDL_Surface* frame = SDL_ConvertSurfaceFormat(image, SDL_PIXELFORMAT_RGBA8888, 0);
+      if(frame &&
+         frame->w + 2 * atlas_padding <= atlas_page_size &&
+         frame->h + 2 * atlas_padding <= atlas_page_size)
+      {
+        frames[i].reset(frame, SDL_FreeSurface);
+      }
+      else
+      {
+        SDL_FreeSurface(frame);
+      }
+    }
+    catch(const std::exception&)
+    {
+      // handled below, Surface::create() falls back to the dummy texture
+    }
+
+    if(!frames[i])
+    {
+      result[i] = Surface::create(filenames[i]);
+    }
+  }
+
+  // simple shelf packing, tallest frames first
+  std::vector<size_t> order;
+  for(size_t i = 0; i < frames.size(); ++i)
+  {
+    if(frames[i])
+      order.push_back(i);
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [&frames](size_t lhs, size_t rhs) {
+                     return frames[lhs]->h > frames[rhs]->h;
+                   });
+
+  struct Placement
+  {
+    size_t frame;
+    int x;
+    int y;
+  };
+
+  size_t next = 0;
+  while(next < order.size())
+  {
+    std::vector<Placement> page;
+    int shelf_x = 0;
+    int shelf_y = 0;
+    int shelf_h = 0;
+    int page_w = 0;
+    for(; next < order.size(); ++next)
+    {
+      const SDL_Surface* frame = frames[order[next]].get();
+      int w = frame->w + 2 * atlas_padding;
+      int h = frame->h + 2 * atlas_padding;
+      if(shelf_x + w > atlas_page_size)
+      {
+        shelf_y += shelf_h;
+        shelf_x = 0;
+        shelf_h = 0;
+      }
+      if(shelf_y + h > atlas_page_size)
+        break;
+
+      Placement placement = { order[next], shelf_x, shelf_y };
+      page.push_back(placement);
+      shelf_x += w;
+      shelf_h = std::max(shelf_h, h);
+      page_w = std::max(page_w, shelf_x);
+    }
+
+    SDLSurfacePtr image(SDL_CreateRGBSurface(0, page_w, shelf_y + shelf_h, 32,
+                                             0xff000000, 0x00ff0000,
+                                             0x0000ff00, 0x000000ff));
+    if (!image)
+    {
+      throw std::runtime_error("SDL_CreateRGBSurface() call failed");
+    }
+
+    for(const auto& placement : page)
+    {
+      blit_extruded(frames[placement.frame].get(), image.get(), placement.x, placement.y);
+    }
+
+    TexturePtr texture = VideoSystem::current()->new_texture(image.get());
+    for(const auto& placement : page)
+    {
+      const SDL_Surface* frame = frames[placement.frame].get();
+      Rect rect(placement.x + atlas_padding, placement.y + atlas_padding,
+                Size(frame->w, frame->h));
+      result[placement.frame] = SurfacePtr(new Surface(texture, rect));
+    }
+  }
+
+  return result;
+}
+
+void
+TextureManager::start_decode(const std::string& filename)
+{
+  if(m_decode_jobs.find(filename) != m_decode_jobs.end())
+    return;
+
+  if(!m_decode_pool)
+    m_decode_pool.reset(new ThreadPool);
+
+  auto job = std::make_shared<DecodeJob>(filename);
+  m_decode_jobs[filename] = job;
+
+  m_decode_pool->post([this, job]{
+      SDL_Surface* surface = nullptr;
+      std::string error;
+      try
+      {
+        surface = decode_image(job->filename);
+      }
+      catch(const std::exception& err)
+      {
+        error = err.what();
+      }
+
+      std::lock_guard<std::mutex> lock(m_decode_mutex);
+      if(job->dropped)
+      {
+        SDL_FreeSurface(surface);
+        surface = nullptr;
+      }
+      else if(surface)
+      {
+        m_decoded_bytes += size_t(surface->pitch) * surface->h;
+      }
+      job->surface = surface;
+      job->error = error;
+      job->done = true;
+      m_decode_cond.notify_all();
+    });
+}
+
+void
+TextureManager::drop_decoded(bool all)
+{
+  std::lock_guard<std::mutex> lock(m_decode_mutex);
+  for(auto i = m_decode_jobs.begin(); i != m_decode_jobs.end();)
+  {
+    if(!all && m_surface_bytes + m_decoded_bytes <= m_surface_budget)
+      break;
+
+    DecodeJob& job = *i->second;
+    if((!all && !job.done) ||
+       m_async_loads.find(i->first) != m_async_loads.end())
+    {
+      ++i;
+      continue;
+    }
+
+    if(job.done)
+    {
+      if(job.surface)
+      {
+        m_decoded_bytes -= size_t(job.surface->pitch) * job.surface->h;
+        SDL_FreeSurface(job.surface);
+        job.surface = nullptr;
+      }
+    }
+    else
+    {
+      job.dropped = true;
+    }
+    i = m_decode_jobs.erase(i);
+  }
+}
+
+SDL_Surface*
+TextureManager::take_decoded(const std::string& filename)
+{
+  auto i = m_decode_jobs.find(filename);
+  if(i == m_decode_jobs.end())
+    return nullptr;
+
+  std::shared_ptr<DecodeJob> job = i->second;
+  m_decode_jobs.erase(i);
+
+  std::unique_lock<std::mutex> lock(m_decode_mutex);
+  m_decode_cond.wait(lock, [&job]{ return job->done; });
+  if(!job->surface)
+  {
+    throw std::runtime_error(job->error);
+  }
+  m_decoded_bytes -= size_t(job->surface->pitch) * job->surface->h;
+  return job->surface;
+}
+
+SDL_Surface*
+TextureManager::decode_image(const std::string& filename)
+{
+  typedef std::chrono::steady_clock Clock;
+  Clock::time_point start = Clock::now();
+
+  if(m_image_cache)
+  {
+    SDL_Surface* cached = m_image_cache->load(filename);
+    if(cached)
+    {
+      m_images_from_cache += 1;
+      m_cache_usec += std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+      return cached;
+    }
+  }
+
+  SDL_Surface* image = IMG_Load_RW(get_physfs_SDLRWops(filename), 1);
+  if (!image)
+  {
+    std::ostringstream msg;
+    msg << "Couldn't load image '" << filename << "' :" << SDL_GetError();
+    throw std::runtime_error(msg.str());
+  }
+
+  auto format = image->format;
+  if(format->Rmask == 0 && format->Gmask == 0 && format->Bmask == 0 && format->Amask == 0) {
+    // palette images can't be sub-rected, convert them once here
+    SDL_Surface* converted = SDL_ConvertSurfaceFormat(image, SDL_PIXELFORMAT_RGBA8888, 0);
+    SDL_FreeSurface(image);
+    if (!converted)
+    {
+      throw std::runtime_error("SDL_ConvertSurfaceFormat() call failed");
+    }
+    image = converted;
+  }
+
+  m_images_decoded += 1;
+  m_decode_usec += std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+  if(m_image_cache)
+  {
+    m_image_cache->store(filename, image);
+  }
+
+  return image;
+}
+
 void
 TextureManager::reap_cache_entry(const std::string& filename)
 {
   auto i = m_image_textures.find(filename);
   assert(i != m_image_textures.end());
-  assert(i->second.expired());
+  assert(i->second.texture.expired());
+  assert(!i->second.retained);
+  m_texture_bytes -= i->second.bytes;
   m_image_textures.erase(i);
 }
 
+TexturePtr
+TextureManager::lookup(const std::string& key)
+{
+  auto i = m_image_textures.find(key);
+  if(i == m_image_textures.end())
+  {
+    m_misses += 1;
+    return TexturePtr();
+  }
+
+  TexturePtr texture = i->second.texture.lock();
+  if(!texture)
+  {
+    m_misses += 1;
+    return TexturePtr();
+  }
+
+  m_hits += 1;
+  retain(i->second, texture);
+  return texture;
+}
+
+void
+TextureManager::insert(const std::string& key, const TexturePtr& texture)
+{
+  texture->cache_filename = key;
+
+  ImageTexture& entry = m_image_textures[key];
+  entry.texture = texture;
+  entry.bytes = size_t(texture->get_texture_width()) * texture->get_texture_height() * 4;
+  entry.retained = false;
+  m_texture_bytes += entry.bytes;
+
+  retain(entry, texture);
+  evict_textures();
+}
+
+void
+TextureManager::retain(ImageTexture& entry, const TexturePtr& texture)
+{
+  if(entry.retained)
+  {
+    m_retained_textures.splice(m_retained_textures.begin(), m_retained_textures, entry.retained_it);
+  }
+  else
+  {
+    m_retained_textures.push_front(texture);
+    entry.retained_it = m_retained_textures.begin();
+    entry.retained = true;
+    m_retained_bytes += entry.bytes;
+  }
+}
+
+void
+TextureManager::evict_textures()
+{
+  // only the references held by the manager count, textures that are
+  // still in use elsewhere stay resident and are retained again by the
+  // next lookup, so the tail can be dropped without looking at it
+  while(m_retained_bytes > m_texture_budget && !m_retained_textures.empty())
+  {
+    TexturePtr victim = std::move(m_retained_textures.back());
+    m_retained_textures.pop_back();
+
+    ImageTexture& entry = m_image_textures[victim->cache_filename];
+    entry.retained = false;
+    m_retained_bytes -= entry.bytes;
+    m_evictions += 1;
+
+    // dropping the last reference reaps the cache entry
+    victim.reset();
+  }
+}
+
+SDL_Surface*
+TextureManager::get_source_surface(const std::string& filename)
+{
+  auto i = m_surfaces.find(filename);
+  if (i != m_surfaces.end())
+  {
+    m_surface_lru.splice(m_surface_lru.begin(), m_surface_lru, i->second.lru_it);
+    return i->second.surface;
+  }
+
+  SDL_Surface* image = take_decoded(filename);
+  if (!image)
+  {
+    image = decode_image(filename);
+  }
+
+  m_surface_lru.push_front(filename);
+
+  SourceSurface entry;
+  entry.surface = image;
+  entry.bytes = size_t(image->pitch) * image->h;
+  entry.lru_it = m_surface_lru.begin();
+  m_surfaces[filename] = entry;
+  m_surface_bytes += entry.bytes;
+
+  evict_surfaces(filename);
+
+  return image;
+}
+
+void
+TextureManager::evict_surfaces(const std::string& keep)
+{
+  while(m_surface_bytes > m_surface_budget && !m_surface_lru.empty() &&
+        m_surface_lru.back() != keep)
+  {
+    auto i = m_surfaces.find(m_surface_lru.back());
+    assert(i != m_surfaces.end());
+
+    SDL_FreeSurface(i->second.surface);
+    m_surface_bytes -= i->second.bytes;
+    m_surfaces.erase(i);
+    m_surface_lru.pop_back();
+  }
+}
+
 #ifdef HAVE_OPENGL
 void
 TextureManager::register_texture(GLTexture* texture)
@@ -145,31 +745,7 @@ TextureManager::create_image_texture(const std::string& filename, const Rect& re
 TexturePtr
 TextureManager::create_image_texture_raw(const std::string& filename, const Rect& rect)
 {
-  SDL_Surface *image = nullptr;
-
-  auto i = m_surfaces.find(filename);
-  if (i != m_surfaces.end())
-  {
-    image = i->second;
-  }
-  else
-  {
-    image = IMG_Load_RW(get_physfs_SDLRWops(filename), 1);
-    if (!image)
-    {
-      std::ostringstream msg;
-      msg << "Couldn't load image '" << filename << "' :" << SDL_GetError();
-      throw std::runtime_error(msg.str());
-    }
-
-    m_surfaces[filename] = image;
-  }
-
-  auto format = image->format;
-  if(format->Rmask == 0 && format->Gmask == 0 && format->Bmask == 0 && format->Amask == 0) {
-    log_debug << "Wrong surface format for image " << filename << ". Compensating." << std::endl;
-    image = SDL_ConvertSurfaceFormat(image, SDL_PIXELFORMAT_RGBA8888, 0);
-  }
+  SDL_Surface* image = get_source_surface(filename);
 
   SDLSurfacePtr subimage(SDL_CreateRGBSurfaceFrom(static_cast<uint8_t*>(image->pixels) +
                                                   rect.top * image->pitch +
@@ -206,19 +782,12 @@ TextureManager::create_image_texture(const std::string& filename)
 TexturePtr
 TextureManager::create_image_texture_raw(const std::string& filename)
 {
-  SDLSurfacePtr image(IMG_Load_RW(get_physfs_SDLRWops(filename), 1));
-  if (!image)
-  {
-    std::ostringstream msg;
-    msg << "Couldn't load image '" << filename << "' :" << SDL_GetError();
-    throw std::runtime_error(msg.str());
-  }
-  else
-  {
-    TexturePtr texture = VideoSystem::current()->new_texture(image.get());
-    image.reset(NULL);
-    return texture;
-  }
+  SDL_Surface* decoded = take_decoded(filename);
+  SDLSurfacePtr image(decoded ? decoded : decode_image(filename));
+
+  TexturePtr texture = VideoSystem::current()->new_texture(image.get());
+  image.reset(NULL);
+  return texture;
 }
 
 TexturePtr
@@ -273,7 +842,7 @@ TextureManager::save_textures()
 
   for(auto& tex : m_image_textures)
   {
-    auto texture = dynamic_cast<GLTexture*>(tex.second.lock().get());
+    auto texture = dynamic_cast<GLTexture*>(tex.second.texture.lock().get());
     if(texture == NULL)
       continue;
 
@@ -21,19 +21,27 @@
 
 #include <config.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <list>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <ostream>
 #include <set>
 #include <string>
 #include <vector>
 
 #include "util/currenton.hpp"
 #include "video/glutil.hpp"
+#include "video/surface_ptr.hpp"
 #include "video/texture_ptr.hpp"
 
 class Texture;
 class GLTexture;
+class ImageCache;
 class Rect;
+class ThreadPool;
 
 class TextureManager : public Currenton<TextureManager>
 {
@@ -44,6 +52,50 @@ public:
   TexturePtr get(const std::string& filename);
   TexturePtr get(const std::string& filename, const Rect& rect);
 
+  /** Sets the number of bytes that the textures retained by the
+      manager itself and the decoded source surfaces may occupy before
+      the least recently used ones are evicted. Textures in use
+      elsewhere don't count once they drop out of the retained list. */
+  void set_budget(size_t texture_bytes, size_t surface_bytes);
+
+  /** Frees all decoded source surfaces and drops prefetched images
+      nobody asked for, to be called once the sub-textures of a level
+      have been built and when a level ends */
+  void release_surfaces();
+
+  /** Keeps decoded images in the given directory below the user dir,
+      must be called before the first image is loaded */
+  void enable_image_cache(const std::string& directory);
+
+  void print_stats(std::ostream& out) const;
+
+  /** Prints how many images were decoded or read from the image cache
+      and how long that took */
+  void print_image_stats(std::ostream& out) const;
+
+  /** Starts decoding the given image files on the worker threads, a
+      later get() of one of them only has to wait for its decode to
+      finish and upload the result */
+  void prefetch(const std::vector<std::string>& filenames);
+
+  /** Lets @c surface show a transparent placeholder until @c filename
+      has been decoded in the background, see update() */
+  void load_async(const std::string& filename, const SurfacePtr& surface);
+
+  /** Returns the texture for @c filename if it is already loaded */
+  TexturePtr get_cached(const std::string& filename);
+
+  TexturePtr get_placeholder();
+
+  /** Packs the given images into a few shared atlas pages and returns
+      one surface per file, in the same order. Images that fail to load
+      or don't fit on a page get a texture of their own. */
+  std::vector<SurfacePtr> create_atlas(const std::vector<std::string>& filenames);
+
+  /** Uploads the images requested with load_async() that finished
+      decoding, to be called once per frame from the main thread */
+  void update();
+
 #ifdef HAVE_OPENGL
   void register_texture(GLTexture* texture);
   void remove_texture(GLTexture* texture);
@@ -55,15 +107,114 @@ public:
 private:
   friend class Texture;
 
-  typedef std::map<std::string, std::weak_ptr<Texture> > ImageTextures;
+  /** Textures that are kept alive by the manager itself, most recently
+      used first */
+  typedef std::list<TexturePtr> RetainedTextures;
+  RetainedTextures m_retained_textures;
+
+  struct ImageTexture
+  {
+    std::weak_ptr<Texture> texture;
+    size_t bytes;
+    bool retained;
+    RetainedTextures::iterator retained_it;
+  };
+  typedef std::map<std::string, ImageTexture> ImageTextures;
   ImageTextures m_image_textures;
 
-  typedef std::map<std::string, SDL_Surface*> Surfaces;
+  typedef std::list<std::string> SurfaceLRU;
+  SurfaceLRU m_surface_lru;
+
+  struct SourceSurface
+  {
+    SDL_Surface* surface;
+    size_t bytes;
+    SurfaceLRU::iterator lru_it;
+  };
+  typedef std::map<std::string, SourceSurface> Surfaces;
   Surfaces m_surfaces;
 
+  size_t m_texture_budget;
+  size_t m_surface_budget;
+  size_t m_texture_bytes;
+  size_t m_retained_bytes;
+  size_t m_surface_bytes;
+  size_t m_hits;
+  size_t m_misses;
+  size_t m_evictions;
+
+  /** An image decode running on the worker threads, the result is
+      guarded by m_decode_mutex */
+  struct DecodeJob
+  {
+    DecodeJob(const std::string& filename_) :
+      filename(filename_),
+      surface(nullptr),
+      error(),
+      done(false),
+      dropped(false)
+    {}
+
+    std::string filename;
+    SDL_Surface* surface;
+    std::string error;
+    bool done;
+
+    /** set when the job was removed from m_decode_jobs before it
+        finished, the worker frees its result then */
+    bool dropped;
+  };
+  typedef std::map<std::string, std::shared_ptr<DecodeJob> > DecodeJobs;
+  DecodeJobs m_decode_jobs;
+  std::mutex m_decode_mutex;
+  std::condition_variable m_decode_cond;
+
+  /** bytes held by finished but not yet consumed decodes, counted
+      against m_surface_budget, guarded by m_decode_mutex */
+  size_t m_decoded_bytes;
+
+  typedef std::map<std::string, std::vector<std::weak_ptr<Surface> > > AsyncLoads;
+  AsyncLoads m_async_loads;
+
+  TexturePtr m_placeholder;
+
+  /** created on the first background decode */
+  std::unique_ptr<ThreadPool> m_decode_pool;
+
+  /** image load statistics, updated from the decode workers */
+  std::atomic<int> m_images_decoded;
+  std::atomic<int> m_images_from_cache;
+  std::atomic<long long> m_decode_usec;
+  std::atomic<long long> m_cache_usec;
+
+  std::unique_ptr<ImageCache> m_image_cache;
+
 private:
   void reap_cache_entry(const std::string& filename);
 
+  TexturePtr lookup(const std::string& key);
+  void insert(const std::string& key, const TexturePtr& texture);
+  void retain(ImageTexture& entry, const TexturePtr& texture);
+  void evict_textures();
+
+  SDL_Surface* get_source_surface(const std::string& filename);
+  void evict_surfaces(const std::string& keep);
+
+  void start_decode(const std::string& filename);
+
+  /** Drops finished decodes that no async load waits for, all of them
+      or only as many as needed to get back within m_surface_budget */
+  void drop_decoded(bool all);
+
+  /** Returns the result of a pending decode of @c filename, waiting for
+      it if needed, or nullptr if no decode was started. The caller owns
+      the returned surface. */
+  SDL_Surface* take_decoded(const std::string& filename);
+
+  /** Loads and converts an image or reads it from the image cache,
+      safe to call from any thread */
+  SDL_Surface* decode_image(const std::string& filename);
+
   TexturePtr create_image_texture(const std::string& filename, const Rect& rect);
 
   /** on failure a dummy texture is returned and no exception is thrown */
@@ -37,12 +37,14 @@
 #include "object/tilemap.hpp"
 #include "physfs/physfs_file_system.hpp"
 #include "physfs/ifile_streambuf.hpp"
+#include "scripting/closure_cache.hpp"
 #include "scripting/scripting.hpp"
 #include "scripting/squirrel_error.hpp"
 #include "scripting/squirrel_util.hpp"
 #include "sprite/sprite.hpp"
 #include "sprite/sprite_manager.hpp"
 #include "supertux/game_session.hpp"
+#include "supertux/level_metadata_index.hpp"
 #include "supertux/game_manager.hpp"
 #include "supertux/gameconfig.hpp"
 #include "supertux/globals.hpp"
@@ -102,6 +104,7 @@ WorldMap::WorldMap(const std::string& filename, Savegame& savegame, const std::s
   total_stats(),
   worldmap_table(),
   scripts(),
+  m_closures(new scripting::ClosureCache),
   ambient_light( 1.0f, 1.0f, 1.0f, 1.0f ),
   force_spawnpoint(force_spawnpoint_),
   in_level(false),
@@ -145,6 +148,7 @@ WorldMap::~WorldMap()
 
   spawn_points.clear();
 
+  m_closures->release(global_vm);
   release_scripts(global_vm, scripts, worldmap_table);
 }
 
@@ -233,6 +237,8 @@ WorldMap::load(const std::string& filename)
       tileset = TileManager::current()->get_tileset("images/worldmap.strf");
     }
 
+    LevelMetadataIndex level_index(levels_path);
+
     ReaderMapping sector;
     if(!level_.get("sector", sector)) {
       throw std::runtime_error("No sector specified in worldmap file.");
@@ -252,7 +258,7 @@ WorldMap::load(const std::string& filename)
           spawn_points.push_back(std::move(sp));
         } else if(iter.get_key() == "level") {
           auto level = std::make_shared<LevelTile>(levels_path, iter.as_mapping());
-          load_level_information(*level.get());
+          load_level_information(*level.get(), level_index);
           levels.push_back(level.get());
           add_object(level);
         } else if(iter.get_key() == "special-tile") {
@@ -286,6 +292,8 @@ WorldMap::load(const std::string& filename)
       }
     }
 
+    level_index.save();
+
     if(solid_tilemaps.empty())
       throw std::runtime_error("No solid tilemap specified");
 
@@ -300,43 +308,28 @@ WorldMap::load(const std::string& filename)
 }
 
 void
-WorldMap::load_level_information(LevelTile& level)
+WorldMap::load_level_information(LevelTile& level, LevelMetadataIndex& level_index)
 {
   /** get special_tile's title */
   level.title = _("<no title>");
   level.target_time = 0.0f;
 
-  try {
-    std::string filename = levels_path + level.get_name();
-
-    if(levels_path == "./")
-      filename = level.get_name();
-
-    if(!PHYSFS_exists(filename.c_str()))
-    {
-      log_warning << "Level file '" << filename << "' does not exist. Skipping." << std::endl;
-      return;
-    }
-    if(PhysFSFileSystem::is_directory(filename))
-    {
-      log_warning << "Level file '" << filename << "' is a directory. Skipping." << std::endl;
-      return;
-    }
-
-    register_translation_directory(filename);
-    auto doc = ReaderDocument::parse(filename);
-    auto root = doc.get_root();
-    if(root.get_name() != "supertux-level") {
-      return;
-    } else {
-      auto level_lisp = root.get_mapping();
-      level_lisp.get("name", level.title);
-      level_lisp.get("target-time", level.target_time);
-    }
-  } catch(std::exception& e) {
-    log_warning << "Problem when reading level information: " << e.what() << std::endl;
+  const LevelMetadataIndex::Entry* entry = level_index.get(level.get_name());
+  if(!entry)
+  {
+    log_warning << "Couldn't read level information for '" << level.get_name() << "'. Skipping." << std::endl;
     return;
   }
+
+  if(!entry->title.empty())
+    level.title = LevelMetadataIndex::get_title(*entry);
+  level.target_time = entry->target_time;
+  if(entry->has_totals)
+  {
+    level.statistics.total_coins = entry->total_coins;
+    level.statistics.total_badguys = entry->total_badguys;
+    level.statistics.total_secrets = entry->total_secrets;
+  }
 }
 
 void WorldMap::calculate_total_stats()
@@ -441,6 +434,12 @@ WorldMap::finished_level(Level* gamelevel)
   level->statistics.merge(gamelevel->stats);
   calculate_total_stats();
 
+  // the totals are only counted once a level is entered
+  LevelMetadataIndex level_index(levels_path);
+  level_index.set_totals(level->get_name(), gamelevel->stats.total_coins,
+                         gamelevel->stats.total_badguys, gamelevel->stats.total_secrets);
+  level_index.save();
+
   if(level->statistics.completed(level->statistics, level->target_time)) {
     level->perfect = true;
     if(level->sprite->has_action("perfect"))
@@ -964,7 +963,11 @@ WorldMap::save_state()
 
   sq_settop(vm, oldtop);
 
-  m_savegame.save();
+  try {
+    m_savegame.save();
+  } catch(const std::exception& err) {
+    log_warning << "Couldn't save worldmap state: " << err.what() << std::endl;
+  }
 }
 
 void
@@ -1098,8 +1101,15 @@ WorldMap::run_script(const std::string& script, const std::string& sourcename)
   {
     return NULL;
   }
-  std::istringstream in(script);
-  return run_script(in, sourcename);
+
+  try {
+    return scripting::run_script(script, sourcename, scripts, &worldmap_table, *m_closures);
+  }
+  catch(const std::exception& e)
+  {
+    log_warning << "Error running worldmap script: " << e.what() << std::endl;
+    return NULL;
+  }
 }
 
 HSQUIRRELVM
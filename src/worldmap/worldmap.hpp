@@ -18,6 +18,7 @@
 #ifndef HEADER_SUPERTUX_WORLDMAP_WORLDMAP_HPP
 #define HEADER_SUPERTUX_WORLDMAP_WORLDMAP_HPP
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -40,11 +41,16 @@
 #include "worldmap/teleporter.hpp"
 
 class GameObject;
+class LevelMetadataIndex;
 class PlayerStatus;
 class Sprite;
 class TileMap;
 class Savegame;
 
+namespace scripting {
+class ClosureCache;
+}
+
 namespace worldmap {
 
 class Tux;
@@ -113,6 +119,8 @@ private:
 
   HSQOBJECT worldmap_table;
   ScriptList scripts;
+  /** compiled scripts, bound to worldmap_table */
+  std::unique_ptr<scripting::ClosureCache> m_closures;
 
   Color ambient_light;
   std::string force_spawnpoint; /**< if set, spawnpoint will be forced to this value */
@@ -225,7 +233,7 @@ public:
   void set_levels_solved(bool solved, bool perfect);
 
 private:
-  void load_level_information(LevelTile& level);
+  void load_level_information(LevelTile& level, LevelMetadataIndex& level_index);
   void draw_status(DrawingContext& context);
   void calculate_total_stats();
 
@@ -0,0 +1,114 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <gtest/gtest.h>
+
+#include <sexp/parser.hpp>
+#include <sstream>
+
+#include "util/binary_sexp.hpp"
+#include "util/reader_document.hpp"
+#include "util/reader_mapping.hpp"
+
+TEST(BinarySexpTest, roundtrip)
+{
+  std::istringstream in(
+    "(supertux-test\n"
+    "   (mybool #t)\n"
+    "   (myint -123456789)\n"
+    "   (myfloat 1.125)\n"
+    "   (mystring \"Hello World\")\n"
+    "   (mystringtrans (_ \"Hello World\"))\n"
+    "   (tiles 0 1 2 3 4 5 6 7 8 9 10 11)\n"
+    "   (mymapping (a 1) (b 2))\n"
+    ")\n");
+
+  std::ostringstream out;
+  BinarySexp::write(out, sexp::Parser::from_stream(in, sexp::Parser::USE_ARRAYS));
+  std::string data = out.str();
+  ASSERT_TRUE(BinarySexp::is_binary(data.data(), data.size()));
+
+  ReaderDocument doc("<test>", BinarySexp::read(data.data(), data.size()));
+  auto root = doc.get_root();
+  ASSERT_EQ("supertux-test", root.get_name());
+  auto mapping = root.get_mapping();
+
+  bool mybool = false;
+  ASSERT_TRUE(mapping.get("mybool", mybool));
+  ASSERT_EQ(true, mybool);
+
+  int myint = 0;
+  ASSERT_TRUE(mapping.get("myint", myint));
+  ASSERT_EQ(-123456789, myint);
+
+  float myfloat = 0.0f;
+  ASSERT_TRUE(mapping.get("myfloat", myfloat));
+  ASSERT_EQ(1.125, myfloat);
+
+  std::string mystring;
+  ASSERT_TRUE(mapping.get("mystring", mystring));
+  ASSERT_EQ("Hello World", mystring);
+
+  std::string mystringtrans;
+  ASSERT_TRUE(mapping.get("mystringtrans", mystringtrans));
+  ASSERT_EQ("Hello World", mystringtrans);
+
+  std::vector<unsigned int> tiles;
+  ASSERT_TRUE(mapping.get("tiles", tiles));
+  ASSERT_EQ(12u, tiles.size());
+  for(size_t i = 0; i < tiles.size(); ++i)
+  {
+    ASSERT_EQ(i, tiles[i]);
+  }
+
+  ReaderMapping child_mapping;
+  ASSERT_TRUE(mapping.get("mymapping", child_mapping));
+  int b = 0;
+  child_mapping.get("b", b);
+  ASSERT_EQ(2, b);
+}
+
+TEST(BinarySexpTest, truncated)
+{
+  std::ostringstream out;
+  BinarySexp::write(out, sexp::Parser::from_string("(supertux-test (myint 1))", sexp::Parser::USE_ARRAYS));
+  std::string data = out.str();
+
+  ASSERT_THROW({BinarySexp::read(data.data(), data.size() - 1);}, std::runtime_error);
+  ASSERT_THROW({BinarySexp::read("(supertux-test)", 15);}, std::runtime_error);
+}
+
+TEST(BinarySexpTest, source_stamp)
+{
+  std::string text = "(supertux-test (myint 1))";
+  uint64_t stamp = BinarySexp::source_stamp(text.data(), text.size());
+
+  std::ostringstream out;
+  BinarySexp::write(out, sexp::Parser::from_string(text, sexp::Parser::USE_ARRAYS), stamp);
+  std::string data = out.str();
+
+  uint64_t read_stamp = 0;
+  ASSERT_TRUE(BinarySexp::read_source_stamp(data.data(), BinarySexp::HEADER_SIZE, read_stamp));
+  ASSERT_EQ(stamp, read_stamp);
+
+  std::string edited = "(supertux-test (myint 2))";
+  ASSERT_NE(stamp, BinarySexp::source_stamp(edited.data(), edited.size()));
+
+  ASSERT_FALSE(BinarySexp::read_source_stamp(data.data(), BinarySexp::HEADER_SIZE - 1, read_stamp));
+  ASSERT_FALSE(BinarySexp::read_source_stamp(text.data(), text.size(), read_stamp));
+}
+
+/* EOF */
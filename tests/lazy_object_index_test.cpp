@@ -0,0 +1,205 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <squirrel.h>
+#include <string>
+
+#include "scripting/lazy_object_index.hpp"
+#include "scripting/scripting.hpp"
+#include "supertux/game_object.hpp"
+#include "supertux/script_interface.hpp"
+
+namespace {
+
+/** exposes itself as a string slot holding @c value */
+class NamedObject : public GameObject,
+                    public ScriptInterface
+{
+public:
+  NamedObject(const std::string& name_, const std::string& value) :
+    m_value(value)
+  {
+    name = name_;
+  }
+
+  void update(float) override {}
+  void draw(DrawingContext&) override {}
+
+  void expose(HSQUIRRELVM vm, SQInteger table_idx) override
+  {
+    sq_pushstring(vm, name.c_str(), -1);
+    sq_pushstring(vm, m_value.c_str(), -1);
+    sq_createslot(vm, table_idx - 2);
+  }
+
+  void unexpose(HSQUIRRELVM vm, SQInteger table_idx) override
+  {
+    sq_pushstring(vm, name.c_str(), -1);
+    sq_deleteslot(vm, table_idx - 1, SQFalse);
+  }
+
+private:
+  std::string m_value;
+};
+
+void put_string(HSQUIRRELVM vm, const char* key, const char* value)
+{
+  sq_pushstring(vm, key, -1);
+  sq_pushstring(vm, value, -1);
+  sq_createslot(vm, -3);
+}
+
+/** looks up @c key in @c table like a script would */
+std::string lookup(HSQUIRRELVM vm, const HSQOBJECT& table, const char* key)
+{
+  SQInteger oldtop = sq_gettop(vm);
+  std::string result;
+  sq_pushobject(vm, table);
+  sq_pushstring(vm, key, -1);
+  const SQChar* value;
+  if(SQ_SUCCEEDED(sq_get(vm, -2)) && SQ_SUCCEEDED(sq_getstring(vm, -1, &value)))
+    result = value;
+  sq_settop(vm, oldtop);
+  return result;
+}
+
+/** runs @c code with @c table as root table like a sector script,
+    returns the result converted to a string */
+std::string run(HSQUIRRELVM vm, const HSQOBJECT& table, const std::string& code)
+{
+  SQInteger oldtop = sq_gettop(vm);
+  sq_pushroottable(vm);
+  sq_pushobject(vm, table);
+  sq_setroottable(vm);
+
+  std::string result = "error";
+  if(SQ_SUCCEEDED(sq_compilebuffer(vm, code.c_str(), code.size(), "test", SQTrue)))
+  {
+    sq_pushobject(vm, table);
+    if(SQ_SUCCEEDED(sq_call(vm, 1, SQTrue, SQTrue)))
+    {
+      const SQChar* value;
+      SQBool flag;
+      if(SQ_SUCCEEDED(sq_getstring(vm, -1, &value)))
+        result = value;
+      else if(SQ_SUCCEEDED(sq_getbool(vm, -1, &flag)))
+        result = flag ? "true" : "false";
+    }
+  }
+
+  sq_settop(vm, oldtop + 1);
+  sq_setroottable(vm);
+  sq_settop(vm, oldtop);
+  return result;
+}
+
+/** pushes a new table whose delegate is the root table */
+HSQOBJECT create_sector_table(HSQUIRRELVM vm)
+{
+  HSQOBJECT table;
+  sq_newtable(vm);
+  sq_pushroottable(vm);
+  sq_setdelegate(vm, -2);
+  sq_getstackobj(vm, -1, &table);
+  sq_addref(vm, &table);
+  sq_pop(vm, 1);
+  return table;
+}
+
+} // namespace
+
+TEST(LazyObjectIndexTest, objects_before_globals)
+{
+  HSQUIRRELVM vm = sq_open(64);
+  scripting::global_vm = vm;
+
+  // a root table with a global of the same name as a sector object
+  sq_pushroottable(vm);
+  put_string(vm, "Camera", "camera class");
+  put_string(vm, "print_stats", "global function");
+  sq_pop(vm, 1);
+
+  HSQOBJECT table = create_sector_table(vm);
+
+  {
+    scripting::LazyObjectIndex index(table);
+    GameObjectPtr camera = std::make_shared<NamedObject>("Camera", "sector camera");
+    index.add(camera);
+    index.enable();
+
+    ASSERT_EQ("sector camera", lookup(vm, table, "Camera"));
+    ASSERT_EQ("global function", lookup(vm, table, "print_stats"));
+    ASSERT_EQ("", lookup(vm, table, "missing"));
+    ASSERT_EQ(1, index.get_exposed_count());
+
+    // once disabled, the globals show through again
+    index.disable();
+    ASSERT_EQ("camera class", lookup(vm, table, "Camera"));
+
+    index.release();
+    ASSERT_EQ("global function", lookup(vm, table, "print_stats"));
+  }
+
+  sq_release(vm, &table);
+  scripting::global_vm = NULL;
+  sq_close(vm);
+}
+
+TEST(LazyObjectIndexTest, scripts)
+{
+  HSQUIRRELVM vm = sq_open(64);
+  scripting::global_vm = vm;
+
+  sq_pushroottable(vm);
+  put_string(vm, "difficulty", "easy");
+  sq_pop(vm, 1);
+
+  HSQOBJECT table = create_sector_table(vm);
+
+  {
+    scripting::LazyObjectIndex index(table);
+    GameObjectPtr tux = std::make_shared<NamedObject>("Tux", "penguin");
+    index.add(tux);
+    index.enable();
+    ASSERT_EQ(0, index.get_exposed_count());
+
+    // assigning a global changes it in the root table
+    ASSERT_EQ("hard", run(vm, table, "difficulty = \"hard\"; return difficulty;"));
+    HSQOBJECT root;
+    sq_pushroottable(vm);
+    sq_getstackobj(vm, -1, &root);
+    sq_pop(vm, 1);
+    ASSERT_EQ("hard", lookup(vm, root, "difficulty"));
+    ASSERT_EQ("error", run(vm, table, "undefined_global = 1;"));
+
+    // 'in' finds objects that weren't looked up yet
+    ASSERT_EQ("true", run(vm, table, "return \"Tux\" in this;"));
+    ASSERT_EQ(1, index.get_exposed_count());
+    ASSERT_EQ("false", run(vm, table, "return \"Penny\" in this;"));
+    ASSERT_EQ("penguin", run(vm, table, "return Tux;"));
+
+    index.release();
+  }
+
+  sq_release(vm, &table);
+  scripting::global_vm = NULL;
+  sq_close(vm);
+}
+
+/* EOF */
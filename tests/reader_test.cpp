@@ -120,4 +120,97 @@ TEST(ReaderTest, syntax_error)
   ASSERT_THROW({mymapping.get("b", myint);}, std::runtime_error);
 }
 
+TEST(ReaderTest, packed_integer_list)
+{
+  std::ostringstream text;
+  text << "(supertux-test\n  (tiles";
+  for(int i = 0; i < 1000; ++i)
+  {
+    text << ' ' << i - 10;
+  }
+  text << ")\n  (myint 5))\n";
+
+  std::istringstream in(text.str());
+  auto doc = ReaderDocument::parse(in);
+  auto mapping = doc.get_root().get_mapping();
+
+  std::vector<int> tiles;
+  ASSERT_TRUE(mapping.get("tiles", tiles));
+  ASSERT_EQ(1000u, tiles.size());
+  ASSERT_EQ(-10, tiles[0]);
+  ASSERT_EQ(989, tiles[999]);
+
+  // lookups don't consume the packed list
+  std::vector<unsigned int> tiles2;
+  ASSERT_TRUE(mapping.get("tiles", tiles2));
+  ASSERT_EQ(1000u, tiles2.size());
+  ASSERT_EQ(11u, tiles2[21]);
+
+  std::vector<float> floats;
+  ASSERT_THROW({mapping.get("tiles", floats);}, std::runtime_error);
+
+  // taking moves the buffer out, later lookups fail loudly
+  std::vector<unsigned int> taken;
+  ASSERT_TRUE(mapping.take("tiles", taken));
+  ASSERT_EQ(1000u, taken.size());
+  ASSERT_EQ(static_cast<unsigned int>(-10), taken[0]);
+  ASSERT_THROW({mapping.get("tiles", tiles);}, std::runtime_error);
+
+  int myint;
+  ASSERT_TRUE(mapping.get("myint", myint));
+  ASSERT_EQ(5, myint);
+}
+
+TEST(ReaderTest, packed_list_after_long_text)
+{
+  std::ostringstream text;
+  text << "(supertux-test\n  (name \"" << std::string(10000, '(') << "\")\n"
+       << "  ; (tiles 1 2 3) in a comment\n  (tiles";
+  for(int i = 0; i < 5000; ++i)
+  {
+    text << ' ' << i << (i % 100 == 99 ? "\n" : "");
+  }
+  text << ")\n  (myint 5))\n";
+
+  std::string data = text.str();
+  auto doc = ReaderDocument::parse(data.data(), data.size());
+  auto mapping = doc.get_root().get_mapping();
+
+  std::string name;
+  ASSERT_TRUE(mapping.get("name", name));
+  ASSERT_EQ(10000u, name.size());
+
+  std::vector<unsigned int> tiles;
+  ASSERT_TRUE(mapping.take("tiles", tiles));
+  ASSERT_EQ(5000u, tiles.size());
+  ASSERT_EQ(4999u, tiles[4999]);
+
+  int myint;
+  ASSERT_TRUE(mapping.get("myint", myint));
+  ASSERT_EQ(5, myint);
+}
+
+TEST(ReaderTest, only_tiles_are_packed)
+{
+  std::ostringstream text;
+  text << "(supertux-test\n  (values";
+  for(int i = 0; i < 100; ++i)
+  {
+    text << ' ' << i;
+  }
+  text << "))\n";
+
+  std::istringstream in(text.str());
+  auto doc = ReaderDocument::parse(in);
+  auto mapping = doc.get_root().get_mapping();
+
+  std::vector<int> ints;
+  ASSERT_TRUE(mapping.get("values", ints));
+  ASSERT_EQ(100u, ints.size());
+
+  // a regular list still has one value per number
+  auto const& item = mapping.get_sexp().as_array()[1].as_array();
+  ASSERT_EQ(101u, item.size());
+}
+
 /* EOF */
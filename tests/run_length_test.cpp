@@ -0,0 +1,58 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <gtest/gtest.h>
+
+#include "util/run_length.hpp"
+
+TEST(RunLengthTest, roundtrip)
+{
+  std::vector<uint32_t> tiles = { 0, 0, 0, 0, 7, 7, 1, 2, 2, 0 };
+
+  auto runs = RunLength::encode(tiles);
+  std::vector<unsigned int> expected = { 4, 0, 2, 7, 1, 1, 2, 2, 1, 0 };
+  ASSERT_EQ(expected, runs);
+
+  std::vector<uint32_t> decoded;
+  ASSERT_TRUE(RunLength::decode(runs, tiles.size(), decoded));
+  ASSERT_EQ(tiles, decoded);
+
+  ASSERT_TRUE(RunLength::encode(std::vector<uint32_t>()).empty());
+}
+
+TEST(RunLengthTest, malformed)
+{
+  std::vector<uint32_t> decoded;
+  ASSERT_FALSE(RunLength::decode({ 3, 1, 2 }, 3, decoded));
+  ASSERT_FALSE(RunLength::decode({ 0, 1 }, 0, decoded));
+
+  // the total has to match the size of the tilemap
+  ASSERT_FALSE(RunLength::decode({ 3, 1 }, 4, decoded));
+  ASSERT_FALSE(RunLength::decode({ 3, 1, 2, 5 }, 4, decoded));
+  ASSERT_FALSE(RunLength::decode({ 0xffffffff, 1 }, 4, decoded));
+
+  // a small run list can't claim a huge tilemap
+  ASSERT_FALSE(RunLength::decode({ 0xffffffff, 1, 0xffffffff, 1 },
+                                 size_t(0xffffffff) * 2, decoded));
+  ASSERT_FALSE(RunLength::decode({ RunLength::MAX_VALUES + 1, 1 },
+                                 RunLength::MAX_VALUES + 1, decoded));
+  ASSERT_TRUE(decoded.empty());
+
+  ASSERT_TRUE(RunLength::decode({ 3, 1, 1, 5 }, 4, decoded));
+  ASSERT_EQ(4u, decoded.size());
+}
+
+/* EOF */
@@ -0,0 +1,199 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <squirrel.h>
+#include <stdexcept>
+#include <string>
+
+#include "scripting/serialize.hpp"
+#include "util/reader_document.hpp"
+#include "util/reader_mapping.hpp"
+#include "util/writer.hpp"
+
+namespace {
+
+void put_bool(HSQUIRRELVM vm, const char* key, bool value)
+{
+  sq_pushstring(vm, key, -1);
+  sq_pushbool(vm, value ? SQTrue : SQFalse);
+  sq_createslot(vm, -3);
+}
+
+void put_int(HSQUIRRELVM vm, const char* key, int value)
+{
+  sq_pushstring(vm, key, -1);
+  sq_pushinteger(vm, value);
+  sq_createslot(vm, -3);
+}
+
+void put_float(HSQUIRRELVM vm, const char* key, float value)
+{
+  sq_pushstring(vm, key, -1);
+  sq_pushfloat(vm, value);
+  sq_createslot(vm, -3);
+}
+
+std::string world_name(int world)
+{
+  return "levels/world" + std::to_string(world) + "/worldmap.stwm";
+}
+
+std::string level_name(int level)
+{
+  return "level" + std::to_string(level) + ".stl";
+}
+
+/** pushes a state table shaped like the one worldmaps save, with
+    @c worlds worlds of @c levels levels each */
+void push_state(HSQUIRRELVM vm, int worlds, int levels)
+{
+  sq_newtable(vm);
+  put_bool(vm, "intro-shown", true);
+  sq_pushstring(vm, "name", -1);
+  sq_pushstring(vm, "Tux", -1);
+  sq_createslot(vm, -3);
+
+  sq_pushstring(vm, "worlds", -1);
+  sq_newtable(vm);
+  for(int world = 0; world < worlds; ++world)
+  {
+    sq_pushstring(vm, world_name(world).c_str(), -1);
+    sq_newtable(vm);
+    sq_pushstring(vm, "levels", -1);
+    sq_newtable(vm);
+    for(int level = 0; level < levels; ++level)
+    {
+      sq_pushstring(vm, level_name(level).c_str(), -1);
+      sq_newtable(vm);
+      put_bool(vm, "solved", level % 2 == 0);
+      put_bool(vm, "perfect", level % 3 == 0);
+      put_int(vm, "coins-collected", world * 100 + level);
+      put_int(vm, "coins-collected-total", 200);
+      put_float(vm, "time-needed", 12.5f + static_cast<float>(level));
+      sq_createslot(vm, -3);
+    }
+    sq_createslot(vm, -3);
+    sq_createslot(vm, -3);
+  }
+  sq_createslot(vm, -3);
+}
+
+/** pushes table[key] for the table on top of the stack */
+bool push_entry(HSQUIRRELVM vm, const std::string& key)
+{
+  sq_pushstring(vm, key.c_str(), -1);
+  return SQ_SUCCEEDED(sq_get(vm, -2));
+}
+
+} // namespace
+
+TEST(SavegameStateTest, roundtrip)
+{
+  HSQUIRRELVM vm = sq_open(64);
+  push_state(vm, 3, 4);
+
+  std::string encoded;
+  ASSERT_TRUE(scripting::encode_squirrel_value(vm, -1, encoded));
+
+  size_t pos = 0;
+  scripting::decode_squirrel_value(vm, encoded.data(), encoded.size(), pos);
+  ASSERT_EQ(encoded.size(), pos);
+  ASSERT_EQ(OT_TABLE, sq_gettype(vm, -1));
+
+  std::string reencoded;
+  ASSERT_TRUE(scripting::encode_squirrel_value(vm, -1, reencoded));
+  ASSERT_EQ(encoded.size(), reencoded.size());
+
+  ASSERT_TRUE(push_entry(vm, "worlds"));
+  ASSERT_TRUE(push_entry(vm, world_name(2)));
+  ASSERT_TRUE(push_entry(vm, "levels"));
+  ASSERT_TRUE(push_entry(vm, level_name(3)));
+  ASSERT_TRUE(push_entry(vm, "coins-collected"));
+  SQInteger coins = 0;
+  sq_getinteger(vm, -1, &coins);
+  ASSERT_EQ(203, coins);
+  sq_pop(vm, 1);
+  ASSERT_TRUE(push_entry(vm, "time-needed"));
+  SQFloat time = 0;
+  sq_getfloat(vm, -1, &time);
+  ASSERT_EQ(15.5f, time);
+  sq_pop(vm, 1);
+  ASSERT_TRUE(push_entry(vm, "perfect"));
+  SQBool perfect = SQFalse;
+  sq_getbool(vm, -1, &perfect);
+  ASSERT_EQ(SQTrue, perfect);
+
+  sq_close(vm);
+}
+
+TEST(SavegameStateTest, skip_keys_and_truncation)
+{
+  HSQUIRRELVM vm = sq_open(64);
+  push_state(vm, 2, 2);
+
+  std::string encoded;
+  ASSERT_TRUE(scripting::encode_squirrel_value(vm, -1, encoded,
+                                               std::vector<std::string>(1, "worlds")));
+  size_t pos = 0;
+  scripting::decode_squirrel_value(vm, encoded.data(), encoded.size(), pos);
+  ASSERT_FALSE(push_entry(vm, "worlds"));
+  ASSERT_TRUE(push_entry(vm, "name"));
+  const SQChar* name = NULL;
+  sq_getstring(vm, -1, &name);
+  ASSERT_EQ(std::string("Tux"), name);
+  sq_pop(vm, 2);
+
+  std::string truncated = encoded.substr(0, encoded.size() / 2);
+  pos = 0;
+  SQInteger top = sq_gettop(vm);
+  ASSERT_THROW(scripting::decode_squirrel_value(vm, truncated.data(), truncated.size(), pos),
+               std::runtime_error);
+  sq_settop(vm, top);
+
+  sq_close(vm);
+}
+
+TEST(SavegameStateTest, binary_is_smaller_than_text)
+{
+  HSQUIRRELVM vm = sq_open(1024);
+  push_state(vm, 100, 40);
+
+  std::ostringstream text;
+  Writer writer(&text);
+  writer.start_list("state");
+  scripting::save_squirrel_table(vm, -1, writer);
+  writer.end_list("state");
+
+  std::string binary;
+  ASSERT_TRUE(scripting::encode_squirrel_value(vm, -1, binary));
+  ASSERT_LT(binary.size(), text.str().size());
+
+  std::istringstream in(text.str());
+  auto doc = ReaderDocument::parse(in);
+  sq_newtable(vm);
+  scripting::load_squirrel_table(vm, -1, doc.get_root().get_mapping());
+  std::string reencoded;
+  ASSERT_TRUE(scripting::encode_squirrel_value(vm, -1, reencoded));
+  ASSERT_EQ(binary.size(), reencoded.size());
+
+  sq_close(vm);
+}
+
+/* EOF */
@@ -0,0 +1,168 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <gtest/gtest.h>
+
+#include <string.h>
+
+#include "audio/memory_sound_sink.hpp"
+#include "audio/software_mixer.hpp"
+#include "audio/software_sound_source.hpp"
+#include "audio/sound_file.hpp"
+
+namespace {
+
+/** mono 16 bit file of @c frames samples, all of value @c value */
+class ConstantSoundFile : public SoundFile
+{
+public:
+  ConstantSoundFile(int rate, size_t frames, int16_t value) :
+    m_value(value),
+    m_position(0)
+  {
+    channels = 1;
+    this->rate = rate;
+    bits_per_sample = 16;
+    size = frames * 2;
+  }
+
+  virtual size_t read(void* buffer, size_t buffer_size) override
+  {
+    size_t bytes = std::min(buffer_size, size - m_position) & ~size_t(1);
+    int16_t* samples = static_cast<int16_t*>(buffer);
+    for(size_t i = 0; i < bytes / 2; ++i)
+      samples[i] = m_value;
+    m_position += bytes;
+    return bytes;
+  }
+
+  virtual void reset() override
+  {
+    m_position = 0;
+  }
+
+private:
+  int16_t m_value;
+  size_t m_position;
+};
+
+} // namespace
+
+TEST(SoftwareMixerTest, mix_frame)
+{
+  MemorySoundSink* sink = new MemorySoundSink;
+  SoftwareMixer mixer(44100, 64, std::unique_ptr<SoundSink>(sink));
+
+  for(int i = 0; i < 64; ++i)
+    mixer.mix_frame();
+
+  // 44100 / 64 is no whole number, the frames must still add up
+  ASSERT_EQ(44100u, sink->get_frames());
+  ASSERT_EQ(44100u, mixer.get_mixed_frames());
+  for(const auto& sample : sink->get_samples())
+    ASSERT_EQ(0, sample);
+}
+
+TEST(SoftwareMixerTest, decoded)
+{
+  MemorySoundSink* sink = new MemorySoundSink;
+  SoftwareMixer mixer(100, 10, std::unique_ptr<SoundSink>(sink));
+
+  ConstantSoundFile file(100, 15, 1000);
+  SoftwareSoundSource source(mixer, SoftwareSoundSource::decode(file));
+  source.set_relative(true);
+  source.play();
+
+  mixer.mix(20);
+  ASSERT_FALSE(source.playing());
+
+  const auto& samples = sink->get_samples();
+  ASSERT_EQ(40u, samples.size());
+  for(size_t i = 0; i < 30; ++i)
+    ASSERT_EQ(1000, samples[i]);
+  for(size_t i = 30; i < 40; ++i)
+    ASSERT_EQ(0, samples[i]);
+}
+
+TEST(SoftwareMixerTest, streamed_looping)
+{
+  MemorySoundSink* sink = new MemorySoundSink;
+  SoftwareMixer mixer(8000, 10, std::unique_ptr<SoundSink>(sink));
+
+  // longer than one stream block, so the source has to refill and loop
+  std::unique_ptr<SoundFile> file(new ConstantSoundFile(8000, 10000, -2000));
+  SoftwareSoundSource source(mixer, std::move(file));
+  source.set_relative(true);
+  source.set_looping(true);
+  source.play();
+
+  mixer.mix(25000);
+  ASSERT_TRUE(source.playing());
+  for(const auto& sample : sink->get_samples())
+    ASSERT_EQ(-2000, sample);
+}
+
+TEST(SoftwareMixerTest, deterministic)
+{
+  std::vector<int16_t> runs[2];
+  for(auto& run : runs)
+  {
+    MemorySoundSink* sink = new MemorySoundSink;
+    SoftwareMixer mixer(22050, 64, std::unique_ptr<SoundSink>(sink));
+    mixer.set_listener_position(Vector(100, 100));
+
+    ConstantSoundFile file(11025, 3000, 12000);
+    auto samples = SoftwareSoundSource::decode(file);
+    SoftwareSoundSource left(mixer, samples);
+    left.set_position(Vector(-200, 100));
+    SoftwareSoundSource right(mixer, samples);
+    right.set_position(Vector(600, 300));
+    right.set_pitch(1.5f);
+
+    left.play();
+    for(int i = 0; i < 10; ++i)
+      mixer.mix_frame();
+    right.play();
+    for(int i = 0; i < 30; ++i)
+      mixer.mix_frame();
+
+    run = sink->get_samples();
+  }
+
+  ASSERT_EQ(runs[0], runs[1]);
+  // the source on the left is louder in the left channel
+  ASSERT_GT(runs[0][0], runs[0][1]);
+}
+
+TEST(SoftwareMixerTest, events)
+{
+  SoftwareMixer mixer(8000, 10, std::unique_ptr<SoundSink>(new MemorySoundSink));
+
+  for(int i = 0; i < 1000; ++i)
+  {
+    mixer.record_event("sounds/" + std::to_string(i) + ".wav");
+    mixer.mix_frame();
+  }
+
+  // only the most recent events are kept
+  ASSERT_EQ(1000u, mixer.get_event_count());
+  ASSERT_EQ(SoftwareMixer::MAX_EVENTS, mixer.get_events().size());
+  ASSERT_EQ("sounds/999.wav", mixer.get_events().back().filename);
+  ASSERT_EQ(999u * 800u, mixer.get_events().back().frame);
+}
+
+/* EOF */
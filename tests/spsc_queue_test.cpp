@@ -0,0 +1,91 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+
+#include "util/spsc_queue.hpp"
+
+TEST(SPSCQueueTest, push_pop)
+{
+  SPSCQueue<int> queue(2);
+  int value = 0;
+  ASSERT_TRUE(queue.empty());
+  ASSERT_FALSE(queue.pop(value));
+
+  ASSERT_TRUE(queue.push(1));
+  ASSERT_TRUE(queue.push(2));
+  ASSERT_FALSE(queue.push(3));
+
+  ASSERT_TRUE(queue.pop(value));
+  ASSERT_EQ(1, value);
+  ASSERT_TRUE(queue.push(3));
+  ASSERT_TRUE(queue.pop(value));
+  ASSERT_EQ(2, value);
+  ASSERT_TRUE(queue.pop(value));
+  ASSERT_EQ(3, value);
+  ASSERT_TRUE(queue.empty());
+}
+
+TEST(SPSCQueueTest, pop_releases_slot)
+{
+  SPSCQueue<std::shared_ptr<int> > queue(2);
+  auto item = std::make_shared<int>(1);
+  ASSERT_TRUE(queue.push(item));
+
+  std::shared_ptr<int> value;
+  ASSERT_TRUE(queue.pop(value));
+  value.reset();
+  ASSERT_EQ(1, item.use_count());
+}
+
+TEST(SPSCQueueTest, threads)
+{
+  const int count = 100000;
+  SPSCQueue<int> queue(16);
+
+  std::thread producer([&queue]{
+      for(int i = 0; i < count; ++i)
+      {
+        while(!queue.push(i))
+          std::this_thread::yield();
+      }
+    });
+
+  long long sum = 0;
+  int expected = 0;
+  while(expected < count)
+  {
+    int value;
+    if(queue.pop(value))
+    {
+      ASSERT_EQ(expected, value);
+      sum += value;
+      expected += 1;
+    }
+    else
+    {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+
+  ASSERT_EQ(static_cast<long long>(count) * (count - 1) / 2, sum);
+}
+
+/* EOF */
@@ -0,0 +1,128 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "util/thread_pool.hpp"
+
+TEST(ThreadPoolTest, post)
+{
+  std::mutex mutex;
+  std::condition_variable cond;
+  int count = 0;
+
+  ThreadPool pool(2);
+  ASSERT_EQ(2, pool.get_num_threads());
+
+  for(int i = 0; i < 100; ++i)
+  {
+    pool.post([&]{
+        std::lock_guard<std::mutex> lock(mutex);
+        count += 1;
+        cond.notify_all();
+      });
+  }
+
+  std::unique_lock<std::mutex> lock(mutex);
+  cond.wait(lock, [&count]{ return count == 100; });
+  ASSERT_EQ(100, count);
+}
+
+TEST(ThreadPoolTest, post_front)
+{
+  std::mutex mutex;
+  std::condition_variable cond;
+  bool blocked = true;
+  std::string order;
+
+  ThreadPool pool(1);
+
+  // keep the only worker busy until everything is queued
+  pool.post([&]{
+      std::unique_lock<std::mutex> lock(mutex);
+      cond.wait(lock, [&blocked]{ return !blocked; });
+    });
+  auto append = [&](char c) {
+    return [&, c]{
+      std::lock_guard<std::mutex> lock(mutex);
+      order += c;
+      cond.notify_all();
+    };
+  };
+  pool.post(append('a'));
+  pool.post(append('b'));
+  pool.post_front(append('c'));
+
+  std::unique_lock<std::mutex> lock(mutex);
+  blocked = false;
+  cond.notify_all();
+  cond.wait(lock, [&order]{ return order.size() == 3; });
+  ASSERT_EQ("cab", order);
+}
+
+TEST(ThreadPoolTest, destructor_drops_queued_jobs)
+{
+  std::mutex mutex;
+  std::condition_variable cond;
+  bool started = false;
+  bool released = false;
+  bool finished = false;
+  int dropped_runs = 0;
+
+  std::unique_ptr<ThreadPool> pool(new ThreadPool(1));
+  pool->post([&]{
+      std::unique_lock<std::mutex> lock(mutex);
+      started = true;
+      cond.notify_all();
+      cond.wait(lock, [&released]{ return released; });
+      finished = true;
+    });
+  for(int i = 0; i < 10; ++i)
+  {
+    pool->post([&]{
+        std::lock_guard<std::mutex> lock(mutex);
+        dropped_runs += 1;
+      });
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    cond.wait(lock, [&started]{ return started; });
+  }
+
+  // let the running job finish only once the destructor had time to
+  // drop the queue
+  std::thread releaser([&]{
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      std::lock_guard<std::mutex> lock(mutex);
+      released = true;
+      cond.notify_all();
+    });
+  pool.reset();
+  releaser.join();
+
+  ASSERT_TRUE(finished);
+  ASSERT_EQ(0, dropped_runs);
+}
+
+/* EOF */
@@ -0,0 +1,132 @@
+//  SuperTux
+//  Copyright (C) 2018 The SuperTux Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <tinygettext/dictionary.hpp>
+
+#include "util/translation_catalog.hpp"
+
+namespace {
+
+std::vector<std::pair<std::string, std::string> > make_entries(int count)
+{
+  std::vector<std::pair<std::string, std::string> > entries;
+  for(int i = 0; i < count; ++i)
+  {
+    std::ostringstream msgid;
+    std::ostringstream msgstr;
+    msgid << "Message number " << i;
+    msgstr << "Nachricht Nummer " << i;
+    entries.push_back(std::make_pair(msgid.str(), msgstr.str()));
+  }
+  return entries;
+}
+
+} // namespace
+
+TEST(TranslationCatalogTest, find)
+{
+  std::vector<std::pair<std::string, std::string> > entries;
+  entries.push_back(std::make_pair("Coins", "Münzen"));
+  entries.push_back(std::make_pair("Time", "Zeit"));
+  entries.push_back(std::make_pair("Untranslated", ""));
+  entries.push_back(std::make_pair("Coins", "Geld"));
+
+  TranslationCatalog catalog;
+  catalog.build(entries);
+  ASSERT_EQ(2u, catalog.size());
+
+  std::string result;
+  ASSERT_TRUE(catalog.find("Coins", result));
+  ASSERT_EQ("Münzen", result);
+  ASSERT_TRUE(catalog.find("Time", result));
+  ASSERT_EQ("Zeit", result);
+  ASSERT_FALSE(catalog.find("Untranslated", result));
+  ASSERT_FALSE(catalog.find("Secrets", result));
+  ASSERT_FALSE(catalog.find("", result));
+}
+
+TEST(TranslationCatalogTest, save_load)
+{
+  const std::string path = "translation_catalog_test.stmo";
+
+  TranslationCatalog catalog;
+  catalog.build(make_entries(1000));
+  ASSERT_TRUE(catalog.save(path, "locale/de.po", 1234, 5678));
+
+  TranslationCatalog loaded;
+  ASSERT_FALSE(loaded.load(path, "locale/de.po", 1235, 5678));
+  ASSERT_FALSE(loaded.load(path, "locale/fr.po", 1234, 5678));
+  ASSERT_TRUE(loaded.load(path, "locale/de.po", 1234, 5678));
+  ASSERT_EQ(1000u, loaded.size());
+
+  std::string result;
+  ASSERT_TRUE(loaded.find("Message number 0", result));
+  ASSERT_EQ("Nachricht Nummer 0", result);
+  ASSERT_TRUE(loaded.find("Message number 999", result));
+  ASSERT_EQ("Nachricht Nummer 999", result);
+  ASSERT_FALSE(loaded.find("Message number 1000", result));
+
+  remove(path.c_str());
+}
+
+TEST(TranslationCatalogTest, lookup_benchmark)
+{
+  typedef std::chrono::steady_clock Clock;
+  const int count = 2000;
+  const int rounds = 50;
+
+  auto entries = make_entries(count);
+  TranslationCatalog catalog;
+  catalog.build(entries);
+  tinygettext::Dictionary dictionary;
+  for(const auto& entry : entries)
+  {
+    dictionary.add_translation(entry.first, entry.second);
+  }
+
+  size_t checksum = 0;
+  Clock::time_point start = Clock::now();
+  for(int round = 0; round < rounds; ++round)
+  {
+    for(const auto& entry : entries)
+      checksum += dictionary.translate(entry.first).size();
+  }
+  auto dictionary_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+  start = Clock::now();
+  for(int round = 0; round < rounds; ++round)
+  {
+    for(const auto& entry : entries)
+    {
+      size_t length = 0;
+      catalog.find(entry.first.data(), entry.first.size(), length);
+      checksum -= length;
+    }
+  }
+  auto catalog_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+  ASSERT_EQ(0u, checksum);
+  std::cout << "tinygettext::Dictionary: " << dictionary_nsec / (count * rounds) << " ns/lookup, "
+            << "TranslationCatalog: " << catalog_nsec / (count * rounds) << " ns/lookup" << std::endl;
+}
+
+/* EOF */